@@ -0,0 +1,106 @@
+// ApplyFixes.cc
+// Oct 17, 2026
+
+/* Apply the edits that global-replace or function-mover exported with
+ * -export-fixes (or any clang-apply-replacements YAML): read every fixes
+ * file, keep one copy of each edit, report conflicts, and rewrite each file
+ * once. */
+
+#include "fix_export.h"
+#include "replacement_set.h"
+
+#include "llvm/Support/CommandLine.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+using namespace llvm;
+
+const char * addl_help =
+    "Apply exported fixes: deduplicate the edits, report conflicts, and "
+    "rewrite the files in parallel";
+
+static cl::OptionCategory AFOpts("apply-fixes options");
+
+static cl::list<std::string> fixes_paths(
+    cl::Positional,
+    cl::desc("<fixes file or directory> ..."),
+    cl::OneOrMore,
+    cl::cat(AFOpts));
+
+static cl::opt<unsigned> n_jobs("j",
+                                cl::desc("threads; 0 means one per core"),
+                                cl::cat(AFOpts),
+                                cl::init(0));
+
+static cl::opt<bool> dry_run(
+    "d",
+    cl::desc("report what would be done, and conflicts, but write nothing"),
+    cl::cat(AFOpts),
+    cl::init(false));
+
+static cl::opt<bool> force(
+    "force",
+    cl::desc("apply the edits even if some conflict (the first edit read "
+             "wins)"),
+    cl::cat(AFOpts),
+    cl::init(false));
+
+int
+main(int argc, const char ** argv)
+{
+  using namespace corct;
+  cl::HideUnrelatedOptions(AFOpts);
+  cl::ParseCommandLineOptions(argc, argv, addl_help);
+  vec_str const files(expand_fixes_dirs(
+      vec_str(fixes_paths.begin(), fixes_paths.end())));
+  uint32_t const n_threads = static_cast<uint32_t>(std::max<size_t>(
+      1, std::min<size_t>(files.size(),
+                          n_jobs > 0 ? n_jobs
+                                     : std::thread::hardware_concurrency())));
+  /* Thread t reads a contiguous block of files into its own set; merging
+   * the sets in block order keeps the results independent of timing. */
+  symbol_table syms;
+  std::vector<replacement_set> sets;
+  std::vector<string_t> errs(files.size());
+  for(uint32_t t = 0; t < n_threads; ++t) { sets.emplace_back(syms); }
+  auto read_block = [&](uint32_t const t) {
+    size_t const first = files.size() * t / n_threads;
+    size_t const last = files.size() * (t + 1) / n_threads;
+    for(size_t i = first; i < last; ++i) {
+      read_fixes(files[i], sets[t], errs[i]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for(uint32_t t = 1; t < n_threads; ++t) {
+    threads.emplace_back(read_block, t);
+  }
+  read_block(0);
+  for(auto & t : threads) { t.join(); }
+  int status(0);
+  for(auto & e : errs) {
+    if(e.empty()) { continue; }
+    std::cerr << "apply-fixes: " << e << "\n";
+    status = 1;
+  }
+  replacement_set & reps(sets[0]);
+  for(uint32_t t = 1; t < n_threads; ++t) { reps.merge(sets[t]); }
+  std::cout << files.size() << " fixes files: " << reps.n_edits()
+            << " edits to " << reps.n_files() << " files ("
+            << reps.n_duplicates() << " duplicates dropped)\n";
+  if(!reps.conflicts().empty()) {
+    reps.write_conflicts(std::cerr);
+    if(!force) {
+      std::cerr << "apply-fixes: " << reps.conflicts().size()
+                << " conflicts; nothing written (see -force)\n";
+      return 1;
+    }
+  }
+  if(dry_run) {
+    reps.write(std::cout);
+    return status;
+  }
+  return reps.apply(std::cerr, n_threads) > 0 ? 1 : status;
+}  // main
+
+// End of file
@@ -0,0 +1,84 @@
+// CallGraph.cc
+// Oct 17, 2026
+
+/* Build a whole-program call graph, keyed by USR, and write it in the binary
+ * format that call-graph-query reads (see call_graph_file.h). */
+
+#include "call_graph_builder.h"
+#include "summarize_command_line.h"
+#include "tool_options.h"
+#include "utilities.h"
+
+#include "clang/Tooling/CommonOptionsParser.h"
+#include "llvm/Support/CommandLine.h"
+#include <fstream>
+#include <iostream>
+
+using namespace clang::tooling;
+using namespace llvm;
+
+const char * addl_help =
+    "Record every caller -> callee edge in the sources, and write the call "
+    "graph to a file for call-graph-query";
+
+static llvm::cl::OptionCategory CGOpts("call-graph options");
+
+static cl::opt<std::string> out_file("o",
+                                     cl::desc("write the call graph here"),
+                                     cl::value_desc("file"),
+                                     cl::Required,
+                                     cl::cat(CGOpts));
+
+static cl::opt<bool> export_opts("xp",
+                                 cl::desc("export command line options"),
+                                 cl::value_desc("bool"),
+                                 cl::cat(CGOpts),
+                                 cl::init(false));
+
+int
+main(int argc, const char ** argv)
+{
+  using namespace corct;
+  add_tool_options(CGOpts);
+  CommonOptionsParser opt_prs(argc, argv, CGOpts, addl_help);
+  if(export_opts) {
+    summarize_command_line("call-graph", addl_help);
+    return 0;
+  }
+  parallel_tool tool(mk_parallel_tool(opt_prs));
+  // one builder per worker thread, merged after the run
+  symbol_table syms;
+  std::vector<call_graph_builder> builders;
+  for(uint32_t w = 0; w < tool.n_jobs(); ++w) { builders.emplace_back(syms); }
+  auto const matcher = call_graph_builder::matcher();
+  tool.add_cache_salt("call-graph");
+  int const status = tool.run(
+      [&](tu_context & tu) {
+        if(!tool.keeps_tu_data()) {
+          tu.add_matcher(matcher, &builders[tu.worker]);
+          return tu.run();
+        }
+        // keep this TU's edges separate, so they can be cached
+        call_graph_builder tu_builder(syms);
+        tu.add_matcher(matcher, &tu_builder);
+        int const tu_status = tu.run();
+        tu_builder.write(tu.data());
+        builders[tu.worker].merge(tu_builder);
+        return tu_status;
+      },
+      [&](tu_context & tu, std::istream & data) {
+        builders[tu.worker].read(data);
+      });
+  call_graph_builder & graph(builders[0]);
+  for(uint32_t w = 1; w < builders.size(); ++w) { graph.merge(builders[w]); }
+  std::ofstream o(out_file, std::ios::binary);
+  write_call_graph(graph.data(), o);
+  if(!o) {
+    std::cerr << "call-graph: error writing " << out_file << "\n";
+    return 1;
+  }
+  std::cerr << "call-graph: " << graph.n_edges() << " edges\n";
+  return status;
+}  // main
+
+// End of file
@@ -0,0 +1,83 @@
+// CallGraphQuery.cc
+// Oct 17, 2026
+
+/* Answer reachability questions from a call graph that call-graph wrote:
+ * which functions call these, directly or not, and which do these call. */
+
+#include "call_graph_file.h"
+#include "utilities.h"
+
+#include "llvm/Support/CommandLine.h"
+#include <iostream>
+
+using namespace llvm;
+
+const char * addl_help =
+    "List the transitive callers or callees of functions, from a call-graph "
+    "file";
+
+static cl::OptionCategory CGQOpts("call-graph-query options");
+
+static cl::opt<std::string> graph_file(cl::Positional,
+                                       cl::desc("<call-graph file>"),
+                                       cl::Required,
+                                       cl::cat(CGQOpts));
+
+static cl::opt<std::string> callers_of(
+    "callers",
+    cl::desc("list every function that calls these, directly or not; "
+             "separate names with commas"),
+    cl::value_desc("functions"),
+    cl::cat(CGQOpts));
+
+static cl::opt<std::string> callees_of(
+    "callees",
+    cl::desc("list every function that these call, directly or not"),
+    cl::value_desc("functions"),
+    cl::cat(CGQOpts));
+
+static cl::opt<bool> by_usr(
+    "usr",
+    cl::desc("functions are given by USR, rather than by qualified name"),
+    cl::cat(CGQOpts),
+    cl::init(false));
+
+int
+main(int argc, const char ** argv)
+{
+  using namespace corct;
+  cl::HideUnrelatedOptions(CGQOpts);
+  cl::ParseCommandLineOptions(argc, argv, addl_help);
+  bool const up = !callers_of.empty();
+  if(up == !callees_of.empty()) {
+    std::cerr << "call-graph-query: give one of -callers or -callees\n";
+    return 1;
+  }
+  call_graph_file g;
+  string_t err;
+  if(!g.open(graph_file, err)) {
+    std::cerr << "call-graph-query: " << err << "\n";
+    return 1;
+  }
+  call_graph_file::nodes_t roots;
+  for(auto & f : split(up ? callers_of : callees_of, ',')) {
+    call_graph_file::node_t n(0);
+    call_graph_file::nodes_t const ns =
+        by_usr ? (g.find(f, n) ? call_graph_file::nodes_t{n}
+                               : call_graph_file::nodes_t{})
+               : g.find_name(f);
+    if(ns.empty()) {
+      std::cerr << "call-graph-query: no function " << f << " in "
+                << graph_file << "\n";
+      return 1;
+    }
+    roots.insert(roots.end(), ns.begin(), ns.end());
+  }
+  // qualified name <tab> USR, one function per line
+  for(auto n : up ? g.transitive_callers(roots) : g.transitive_callees(roots)) {
+    std::cout << g.name(n) << "\t" << g.usr(n) << "\n";
+  }
+  return 0;
+}  // main
+
+// End of file
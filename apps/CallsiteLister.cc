@@ -11,7 +11,9 @@
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/CommandLine.h"
+#include "tool_options.h"
 #include <iostream>
+#include <vector>
 
 using namespace clang::tooling;
 using namespace llvm;
@@ -32,47 +34,89 @@ static cl::opt<std::string> target_func_string(
     cl::value_desc("target-function-string"),
     cl::cat(csl_cat));
 
+static cl::opt<bool> jsonl(
+    "jsonl",
+    cl::desc("write one JSON object per call site (file, line, col, "
+             "function, symbol) instead of the text report"),
+    cl::cat(csl_cat),
+    cl::init(false));
+
+static cl::opt<bool> edges(
+    "edges",
+    cl::desc("instead of each call site, print each caller -> callee edge "
+             "once per TU, with its number of call sites"),
+    cl::cat(csl_cat),
+    cl::init(false));
+
 const char * addl_help =
     "List all calls to target functions and where they are called (excluding "
     "functions defined in system headers).";
 
 void
-add_include_paths(ClangTool & tool);
+add_include_paths(corct::parallel_tool & tool);
 
 int
 main(int argc, const char ** argv)
 {
+  corct::add_tool_options(csl_cat);
   CommonOptionsParser OptionsParser(argc, argv, csl_cat);
-  ClangTool tool(OptionsParser.getCompilations(),
-                 OptionsParser.getSourcePathList());
+  corct::parallel_tool tool(corct::mk_parallel_tool(OptionsParser));
   add_include_paths(tool);
   // process target functions
   corct::vec_str targ_fns(corct::split(target_func_string, ','));
 
-  // instantiate callback and matcher
-  corct::callsite_lister csl(targ_fns);
-  MatchFinder finder;
-  auto matchers = csl.matchers();
-  for(auto & m : matchers) { finder.addMatcher(m, &csl); }
-  // go!
-  int rslt = tool.run(newFrontendActionFactory(&finder).get());
-  std::cout << "Reported " << csl.m_num_calls << " calls\n";
+  // matchers are shared, callbacks are per TU so they can print to tu.out
+  auto matchers = corct::callsite_lister(targ_fns).matchers();
+  corct::symbol_table syms;
+  // each worker's calls, for the summary and -partial
+  std::vector<corct::callsite_lister> totals;
+  for(uint32_t w = 0; w < tool.n_jobs(); ++w) {
+    totals.emplace_back(targ_fns, std::cout, syms);
+  }
+  // go! (":2": TU data holds the edges, not just the count)
+  tool.add_cache_salt("callsite-lister:2");
+  tool.add_cache_salt(target_func_string);
+  tool.add_cache_salt(jsonl ? "jsonl" : "text");
+  tool.add_cache_salt(edges ? "edges" : "sites");
+  int rslt = tool.run(
+      [&](corct::tu_context & tu) {
+        corct::callsite_lister csl(targ_fns, tu.out, syms);
+        if(jsonl) { csl.set_format(corct::output_format::jsonl); }
+        csl.set_print_calls(!edges);
+        for(auto & m : matchers) { tu.add_matcher(m, &csl); }
+        int const tu_rslt = tu.run();
+        if(edges) { csl.write_edges(tu.out); }
+        totals[tu.worker].merge(csl);
+        if(tool.keeps_tu_data()) { csl.write(tu.data()); }
+        return tu_rslt;
+      },
+      [&](corct::tu_context & tu, std::istream & data) {
+        totals[tu.worker].read(data);
+      });
+  for(uint32_t w = 1; w < totals.size(); ++w) { totals[0].merge(totals[w]); }
+  if(!corct::partial_path().empty()) {
+    auto write = [&totals](std::ostream & o) { totals[0].write(o); };
+    return corct::write_partial("callsite-lister", write) ? rslt : 1;
+  }
+  // keep stdout pure JSON Lines
+  std::ostream & summary(jsonl ? std::cerr : std::cout);
+  summary << "Reported " << totals[0].m_num_calls << " calls\n";
   return rslt;
 }
 
 void
-add_include_paths(ClangTool & tool)
+add_include_paths(corct::parallel_tool & tool)
 {
   // add header search paths to compiler
   ArgumentsAdjuster ardj1 =
       getInsertArgumentAdjuster(corct::clang_inc_dir1.c_str());
   ArgumentsAdjuster ardj2 =
       getInsertArgumentAdjuster(corct::clang_inc_dir2.c_str());
-  tool.appendArgumentsAdjuster(ardj1);
-  tool.appendArgumentsAdjuster(ardj2);
+  tool.append_arguments_adjuster(ardj1);
+  tool.append_arguments_adjuster(ardj2);
   if(verbose_compiler) {
     ArgumentsAdjuster ardj3 = getInsertArgumentAdjuster("-v");
-    tool.appendArgumentsAdjuster(ardj3);
+    tool.append_arguments_adjuster(ardj3);
   }
   return;
 }  // add_include_paths
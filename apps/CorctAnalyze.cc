@@ -0,0 +1,220 @@
+// CorctAnalyze.cc
+// Oct 17, 2026
+
+/* Run several of the CoARCT analyses over a code base in one pass: each
+ * translation unit is parsed once, and one MatchFinder feeds the callbacks of
+ * every analysis selected on the command line. The reports are the same as
+ * those of global-detect, callsite-lister, typedef-report, struct-field-use,
+ * and template-vars-report. */
+
+#include "callsite_lister.h"
+#include "global_matchers.h"
+#include "struct_field_user.h"
+#include "summarize_command_line.h"
+#include "symbol_table.h"
+#include "template_var_matchers.h"
+#include "tool_options.h"
+#include "typedef_reporter.h"
+#include "types.h"
+#include "utilities.h"
+
+#include "clang/Tooling/ArgumentsAdjusters.h"
+#include "clang/Tooling/CommonOptionsParser.h"
+#include "llvm/Support/CommandLine.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace clang::tooling;
+using namespace llvm;
+
+const char * addl_help =
+    "Run several analyses in one pass over the code: global variable uses, "
+    "call sites, typedef'd struct fields, struct field uses, and template "
+    "variable types";
+
+static llvm::cl::OptionCategory CAOpts("corct-analyze options");
+
+static cl::opt<bool> do_globals(
+    "globals",
+    cl::desc("report each reference to a global variable (as global-detect)"),
+    cl::cat(CAOpts),
+    cl::init(false));
+
+static cl::opt<bool> do_calls(
+    "calls",
+    cl::desc("report call sites (as callsite-lister); see -tf"),
+    cl::cat(CAOpts),
+    cl::init(false));
+
+static cl::opt<std::string> target_func_string(
+    "tf",
+    cl::desc("with -calls, only report calls to these functions, separated by "
+             "commas if nec. E.g. -tf=\"foo,bar,baz\""),
+    cl::value_desc("target-function-string"),
+    cl::cat(CAOpts));
+
+static cl::opt<bool> do_typedefs(
+    "typedefs",
+    cl::desc("report struct fields declared with a typedef (as "
+             "typedef-report)"),
+    cl::cat(CAOpts),
+    cl::init(false));
+
+static cl::opt<std::string> target_struct_string(
+    "ts",
+    cl::desc("report which functions read/write fields of these structs (as "
+             "struct-field-use), separated by commas if nec. E.g. "
+             "-ts=\"cell_t,bas_t,region_t\""),
+    cl::value_desc("target-struct-string"),
+    cl::cat(CAOpts));
+
+static cl::opt<std::string> template_name(
+    "tn",
+    cl::desc("gather the types with which this template is instantiated (as "
+             "template-vars-report), e.g.\"vector\""),
+    cl::value_desc("template-name-pattern"),
+    cl::cat(CAOpts));
+
+static cl::opt<std::string> namespace_name(
+    "nn",
+    cl::desc("with -tn, optional namespace to limit search e.g.\"std\""),
+    cl::value_desc("namespace-name"),
+    cl::cat(CAOpts),
+    cl::init(""));
+
+static cl::opt<bool> export_opts("xp",
+                                 cl::desc("export command line options"),
+                                 cl::value_desc("bool"),
+                                 cl::cat(CAOpts),
+                                 cl::init(false));
+
+/**\brief Write a section of a TU's report, if it has anything in it. */
+void
+write_section(std::ostream & o, corct::str_t_cr title, std::stringstream & s);
+
+int
+main(int argc, const char ** argv)
+{
+  using namespace corct;
+  add_tool_options(CAOpts);
+  CommonOptionsParser opt_prs(argc, argv, CAOpts, addl_help);
+  if(export_opts) {
+    summarize_command_line("corct-analyze", addl_help);
+    return 0;
+  }
+  bool const do_fields = !target_struct_string.empty();
+  bool const do_tvars = !template_name.empty();
+  if(!(do_globals || do_calls || do_typedefs || do_fields || do_tvars)) {
+    std::cerr << "No analyses selected: use one or more of -globals, -calls, "
+                 "-typedefs, -ts, -tn\n";
+    return -1;
+  }
+  parallel_tool tool(mk_parallel_tool(opt_prs));
+  // Alert the compiler instance to std lib header locations
+  tool.append_arguments_adjuster(
+      getInsertArgumentAdjuster(clang_inc_dir1.c_str()));
+  tool.append_arguments_adjuster(
+      getInsertArgumentAdjuster(clang_inc_dir2.c_str()));
+
+  // matchers are built once and shared by all TUs
+  auto const global_matcher = all_global_var_matcher();
+  vec_str const targ_fns(split(target_func_string, ','));
+  callsite_lister::matchers_t const call_matchers =
+      callsite_lister(targ_fns).matchers();
+  vec_str targ_structs(split(target_struct_string, ','));
+  struct_field_user::matchers_t const field_matchers =
+      struct_field_user(targ_structs).matchers();
+  using tvr_t = template_var_reporter;
+  tvr_t::matchers_t const tvar_matchers =
+      tvr_t(template_name, namespace_name).matchers();
+
+  // accumulators for the whole-program reports, one per worker
+  symbol_table syms;
+  std::vector<struct_field_user> s_finders;
+  for(uint32_t w = 0; w < tool.n_jobs(); ++w) {
+    s_finders.emplace_back(targ_structs, syms);
+  }
+  std::vector<tvr_t> trs(tool.n_jobs(), tvr_t(template_name, namespace_name));
+
+  // A TU's data holds the length of its struct_field_user shard, the shard,
+  // then its template_var_reporter shard.
+  int const status = tool.run(
+      [&](tu_context & tu) {
+        // per-TU reports: each callback writes to its own section
+        std::stringstream g_s, c_s, t_s;
+        Global_Printer printer(g_s, syms);
+        callsite_lister csl(targ_fns, c_s, syms);
+        Typedef_Reporter tr(t_s);
+        // whole-program results, kept per TU so that they can be journaled
+        struct_field_user s_finder(targ_structs, syms);
+        tvr_t t_reporter(template_name, namespace_name);
+        if(do_globals) { tu.add_matcher(global_matcher, &printer); }
+        if(do_calls) {
+          for(auto & m : call_matchers) { tu.add_matcher(m, &csl); }
+        }
+        if(do_typedefs) { tu.add_matcher(tr.matcher(), &tr); }
+        if(do_fields) {
+          for(auto & m : field_matchers) { tu.add_matcher(m, &s_finder); }
+        }
+        if(do_tvars) {
+          for(auto & m : tvar_matchers) { tu.add_matcher(m, &t_reporter); }
+        }
+        int const tu_status = tu.run();
+        if(do_globals || do_calls || do_typedefs) {
+          tu.out << "== " << tu.source << "\n";
+          write_section(tu.out, "global references", g_s);
+          write_section(tu.out, "call sites", c_s);
+          write_section(tu.out, "typedef fields", t_s);
+        }
+        s_finders[tu.worker].merge(s_finder);
+        trs[tu.worker].merge(t_reporter);
+        if(tool.keeps_tu_data()) {
+          std::stringstream f_s;
+          s_finder.write(f_s);
+          tu.data() << f_s.str().size() << "\n" << f_s.str();
+          t_reporter.write(tu.data());
+        }
+        return tu_status;
+      },
+      [&](tu_context & tu, std::istream & data) {
+        size_t n_f(0);
+        data >> n_f;
+        data.ignore(1);
+        string_t f_text(n_f, '\0');
+        data.read(&f_text[0], n_f);
+        std::istringstream f_s(f_text);
+        s_finders[tu.worker].read(f_s);
+        trs[tu.worker].read(data);
+      });
+
+  // whole-program reports
+  if(do_fields) {
+    struct_field_user & s_finder(s_finders[0]);
+    for(uint32_t w = 1; w < s_finders.size(); ++w) {
+      s_finder.merge(s_finders[w]);
+    }
+    std::cout << "== struct field uses\n";
+    std::cout << "Fields written:\n";
+    print_fields(s_finder.lhs_uses());
+    std::cout << "Fields accessed, but not written:\n";
+    print_fields(s_finder.non_lhs_uses());
+  }
+  if(do_tvars) {
+    for(size_t w = 1; w < trs.size(); ++w) { trs[0].merge(trs[w]); }
+    std::cout << "== template variable types\n";
+    process_type_set(collate_types(trs[0].args_), std::cout);
+  }
+  return status;
+}  // main
+
+void
+write_section(std::ostream & o, corct::str_t_cr title, std::stringstream & s)
+{
+  corct::string_t const text(s.str());
+  if(text.empty()) { return; }
+  o << "-- " << title << "\n" << text;
+  return;
+}  // write_section
+
+// End of file
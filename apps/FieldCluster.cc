@@ -0,0 +1,101 @@
+// FieldCluster.cc
+// Oct 17, 2026
+
+/* Suggest how to split a struct: order its fields so that the function x
+ * field use matrix is nearly block diagonal, then group fields that are used
+ * together. Reads the uses that struct-field-use writes with -bin. */
+
+#include "field_cluster.h"
+#include "field_use_file.h"
+
+#include "llvm/Support/CommandLine.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+using namespace llvm;
+
+const char * addl_help =
+    "Order and cluster the fields of a struct by the functions that use them, "
+    "from a struct-field-use -bin file";
+
+static cl::OptionCategory FCOpts("field-cluster options");
+
+static cl::opt<std::string> uses_file(cl::Positional,
+                                      cl::desc("<struct-field-use -bin file>"),
+                                      cl::Required,
+                                      cl::cat(FCOpts));
+
+static cl::opt<std::string> struct_name(
+    "s",
+    cl::desc("struct to analyze (default: the only one in the file)"),
+    cl::value_desc("struct-name"),
+    cl::cat(FCOpts));
+
+static cl::opt<uint32_t> max_swaps(
+    "swaps",
+    cl::desc("stop the ordering search after this many swaps (default "
+             "100000)"),
+    cl::value_desc("n"),
+    cl::cat(FCOpts),
+    cl::init(100000));
+
+static cl::opt<uint32_t> n_jobs(
+    "j",
+    cl::desc("number of threads for the ordering search (0: one per core; "
+             "default 1)"),
+    cl::value_desc("n-jobs"),
+    cl::cat(FCOpts),
+    cl::init(1));
+
+int
+main(int argc, const char ** argv)
+{
+  using namespace corct;
+  cl::HideUnrelatedOptions(FCOpts);
+  cl::ParseCommandLineOptions(argc, argv, addl_help);
+  field_use_file f;
+  string_t err;
+  if(!f.open(uses_file, err)) {
+    std::cerr << "field-cluster: " << err << "\n";
+    return 1;
+  }
+  uint32_t s_id(0);
+  if(struct_name.empty()) {
+    if(f.n_names(fu_dict::structs) != 1) {
+      std::cerr << "field-cluster: " << uses_file << " has "
+                << f.n_names(fu_dict::structs)
+                << " structs; choose one with -s\n";
+      return 1;
+    }
+  }
+  else if(!f.find(fu_dict::structs, struct_name, s_id)) {
+    std::cerr << "field-cluster: no uses of " << struct_name << " in "
+              << uses_file << "\n";
+    return 1;
+  }
+  use_matrix const m(f, s_id);
+  diagonalizer d(m);
+  diagonalizer::score_t const start = d.score();
+  uint32_t const jobs =
+      n_jobs ? uint32_t(n_jobs)
+             : std::max(1u, std::thread::hardware_concurrency());
+  uint32_t const n_swaps = d.search(max_swaps, jobs);
+  std::cout << "# struct " << f.name(fu_dict::structs, s_id).str() << ": "
+            << m.n_funcs() << " functions, " << m.n_fields() << " fields\n"
+            << "# diagonal score " << start << " -> " << d.score() << " after "
+            << n_swaps << " swaps\n"
+            << "# field order\n";
+  for(auto fld : d.field_order()) { std::cout << m.field_name(fld) << "\n"; }
+  std::cout << "# clusters: score <tab> fields\n";
+  for(auto & c : find_clusters(m, d.field_order())) {
+    std::cout << cluster_score(m, c) << "\t";
+    for(size_t i = 0; i < c.size(); ++i) {
+      std::cout << (i ? "," : "") << m.field_name(c[i]);
+    }
+    std::cout << "\n";
+  }
+  return 0;
+}  // main
+
+// End of file
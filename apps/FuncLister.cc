@@ -13,7 +13,9 @@
 #include "clang/Tooling/Tooling.h"
 #include "function_definition_lister.h"
 #include "llvm/Support/CommandLine.h"
+#include "tool_options.h"
 #include <iostream>
+#include <numeric>
 
 using namespace clang::tooling;
 using namespace llvm;
@@ -34,27 +36,40 @@ const char * addl_help =
 int
 main(int argc, const char ** argv)
 {
+  corct::add_tool_options(flt_cat);
   CommonOptionsParser OptionsParser(argc, argv, flt_cat);
-  ClangTool tool(OptionsParser.getCompilations(),
-                 OptionsParser.getSourcePathList());
+  corct::parallel_tool tool(corct::mk_parallel_tool(OptionsParser));
   // add header search paths to compiler
   ArgumentsAdjuster ardj1 =
       getInsertArgumentAdjuster(corct::clang_inc_dir1.c_str());
   ArgumentsAdjuster ardj2 =
       getInsertArgumentAdjuster(corct::clang_inc_dir2.c_str());
-  tool.appendArgumentsAdjuster(ardj1);
-  tool.appendArgumentsAdjuster(ardj2);
+  tool.append_arguments_adjuster(ardj1);
+  tool.append_arguments_adjuster(ardj2);
   if(verbose_compiler) {
     ArgumentsAdjuster ardj3 = getInsertArgumentAdjuster("-v");
-    tool.appendArgumentsAdjuster(ardj3);
+    tool.append_arguments_adjuster(ardj3);
   }
-  // instantiate callback and matcher
-  corct::FunctionDefLister fl("f_decl");
-  MatchFinder finder;
-  finder.addMatcher(fl.matcher(), &fl);
+  std::vector<size_t> num_funcs(tool.n_jobs(), 0u);
   // go!
-  int rslt = tool.run(newFrontendActionFactory(&finder).get());
-  std::cout << "Reported " << fl.m_num_funcs << " functions\n";
+  int rslt = tool.run(
+      [&](corct::tu_context & tu) {
+        // instantiate callback and matcher
+        corct::FunctionDefLister fl("f_decl", tu.out);
+        tu.add_matcher(fl.matcher(), &fl);
+        int const tu_rslt = tu.run();
+        num_funcs[tu.worker] += fl.m_num_funcs;
+        tu.data() << fl.m_num_funcs << "\n";
+        return tu_rslt;
+      },
+      [&](corct::tu_context & tu, std::istream & data) {
+        size_t n(0);
+        data >> n;
+        num_funcs[tu.worker] += n;
+      });
+  std::cout << "Reported "
+            << std::accumulate(num_funcs.begin(), num_funcs.end(), size_t(0))
+            << " functions\n";
   return rslt;
 }
 
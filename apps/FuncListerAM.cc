@@ -11,20 +11,21 @@
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_os_ostream.h"
+#include "tool_options.h"
 #include <iostream>
+#include <numeric>
 
 using namespace clang::tooling;
 using namespace llvm;
 using namespace clang::ast_matchers;
 
-uint32_t num_funcs = 0;
-uint32_t num_skipped_funcs = 0;
-
 void
-print_func(clang::FunctionDecl const * const fdecl)
+print_func(clang::FunctionDecl const * const fdecl, std::ostream & o)
 {
-  std::cout << "Function '" << (fdecl->getNameAsString()) << "' defined\n";
-  fdecl->dump();
+  o << "Function '" << (fdecl->getNameAsString()) << "' defined\n";
+  llvm::raw_os_ostream ro(o);
+  fdecl->dump(ro);
   return;
 }  // print_func
 
@@ -41,7 +42,7 @@ struct FuncPrinter : public MatchFinder::MatchCallback {
     FunctionDecl const * fdecl = result.Nodes.getNodeAs<FunctionDecl>("fdecl");
     if(fdecl) {
       num_funcs++;
-      print_func(fdecl);
+      print_func(fdecl, o_);
     }
     else {
       std::cerr << "Invalid fdecl\n";
@@ -49,6 +50,10 @@ struct FuncPrinter : public MatchFinder::MatchCallback {
     return;
   }  // run
 
+  explicit FuncPrinter(std::ostream & o) : o_(o) {}
+
+  std::ostream & o_;
+  uint32_t num_funcs = 0;
 };  // FuncPrinter
 
 /* The RAV approach also makes a note when the analysis skips a function
@@ -66,8 +71,8 @@ struct FuncSkipper : public MatchFinder::MatchCallback {
     using namespace clang;
     FunctionDecl const * fdecl = result.Nodes.getNodeAs<FunctionDecl>("fdecl");
     if(fdecl) {
-      std::cout << "Skipping " << fdecl->getNameAsString()
-                << " not from target file\n";
+      o_ << "Skipping " << fdecl->getNameAsString()
+         << " not from target file\n";
       num_skipped_funcs++;
     }
     else {
@@ -75,24 +80,48 @@ struct FuncSkipper : public MatchFinder::MatchCallback {
     }
     return;
   }  // run
-};   // FuncSkipper
+
+  explicit FuncSkipper(std::ostream & o) : o_(o) {}
+
+  std::ostream & o_;
+  uint32_t num_skipped_funcs = 0;
+};  // FuncSkipper
 
 static llvm::cl::OptionCategory flt_cat("func-decl-list-am options");
 
 int
 main(int argc, const char ** argv)
 {
+  corct::add_tool_options(flt_cat);
   CommonOptionsParser OptionsParser(argc, argv, flt_cat);
-  ClangTool Tool(OptionsParser.getCompilations(),
-                 OptionsParser.getSourcePathList());
-  FuncPrinter fp;
-  FuncSkipper fs;
-  MatchFinder finder;
-  finder.addMatcher(mk_fn_decl_matcher(), &fp);
-  finder.addMatcher(mk_fn_skipper_matcher(), &fs);
-  int rslt = Tool.run(newFrontendActionFactory(&finder).get());
-  std::cout << "Reported " << num_funcs << " functions\n";
-  std::cout << "Skipped " << num_skipped_funcs << " functions\n";
+  corct::parallel_tool Tool(corct::mk_parallel_tool(OptionsParser));
+  std::vector<uint32_t> num_funcs(Tool.n_jobs(), 0);
+  std::vector<uint32_t> num_skipped_funcs(Tool.n_jobs(), 0);
+  int rslt = Tool.run(
+      [&](corct::tu_context & tu) {
+        FuncPrinter fp(tu.out);
+        FuncSkipper fs(tu.out);
+        tu.add_matcher(mk_fn_decl_matcher(), &fp);
+        tu.add_matcher(mk_fn_skipper_matcher(), &fs);
+        int const tu_rslt = tu.run();
+        num_funcs[tu.worker] += fp.num_funcs;
+        num_skipped_funcs[tu.worker] += fs.num_skipped_funcs;
+        tu.data() << fp.num_funcs << " " << fs.num_skipped_funcs << "\n";
+        return tu_rslt;
+      },
+      [&](corct::tu_context & tu, std::istream & data) {
+        uint32_t n(0), n_skipped(0);
+        data >> n >> n_skipped;
+        num_funcs[tu.worker] += n;
+        num_skipped_funcs[tu.worker] += n_skipped;
+      });
+  std::cout << "Reported "
+            << std::accumulate(num_funcs.begin(), num_funcs.end(), 0u)
+            << " functions\n";
+  std::cout << "Skipped "
+            << std::accumulate(num_skipped_funcs.begin(),
+                               num_skipped_funcs.end(), 0u)
+            << " functions\n";
   return rslt;
 }
 
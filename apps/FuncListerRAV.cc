@@ -13,17 +13,23 @@
 #include "clang/Frontend/FrontendAction.h"
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/Support/raw_os_ostream.h"
+#include "tool_options.h"
 
 #include <iostream>
 
-uint32_t num_funcs = 0;
-uint32_t num_skipped_funcs = 0;
+/* Counts for one translation unit */
+struct lister_counts {
+  uint32_t num_funcs = 0;
+  uint32_t num_skipped_funcs = 0;
+};
 
 void
-print_func(clang::FunctionDecl * fdecl)
+print_func(clang::FunctionDecl * fdecl, std::ostream & o)
 {
-  std::cout << "Function '" << (fdecl->getNameAsString()) << "' defined\n";
-  fdecl->dump();
+  o << "Function '" << (fdecl->getNameAsString()) << "' defined\n";
+  llvm::raw_os_ostream ro(o);
+  fdecl->dump(ro);
   return;
 }  // print_func
 
@@ -31,8 +37,10 @@ class FunctionLister : public clang::RecursiveASTVisitor<FunctionLister> {
 public:
   clang::ASTContext * ast_ctx_;
 
-  explicit FunctionLister(clang::CompilerInstance * ci)
-      : ast_ctx_(&(ci->getASTContext()))
+  FunctionLister(clang::CompilerInstance * ci,
+                 lister_counts & counts,
+                 std::ostream & o)
+      : ast_ctx_(&(ci->getASTContext())), counts_(counts), o_(o)
   {
   }
 
@@ -43,17 +51,21 @@ public:
     bool const inMainFile(
         sm.isInMainFile(sm.getExpansionLoc(fdecl->getBeginLoc())));
     if(inMainFile) {
-      num_funcs++;
-      print_func(fdecl);
+      counts_.num_funcs++;
+      print_func(fdecl, o_);
     }
     else {
-      std::cout << "Skipping " << fdecl->getNameAsString()
-                << " not from target file\n";
-      num_skipped_funcs++;
+      o_ << "Skipping " << fdecl->getNameAsString()
+         << " not from target file\n";
+      counts_.num_skipped_funcs++;
     }
     return true;
   }  // VisitFunctionDecl
-};   // FunctionLister
+
+private:
+  lister_counts & counts_;
+  std::ostream & o_;
+};  // FunctionLister
 
 class FunctionListerConsumer : public clang::ASTConsumer {
 public:
@@ -62,7 +74,12 @@ public:
     lister_.TraverseDecl(ctx.getTranslationUnitDecl());
   }
 
-  explicit FunctionListerConsumer(clang::CompilerInstance * ci) : lister_(ci) {}
+  FunctionListerConsumer(clang::CompilerInstance * ci,
+                         lister_counts & counts,
+                         std::ostream & o)
+      : lister_(ci, counts, o)
+  {
+  }
 
 private:
   FunctionLister lister_;
@@ -74,21 +91,76 @@ public:
       clang::CompilerInstance & ci,
       llvm::StringRef file)
   {
-    return std::unique_ptr<clang::ASTConsumer>(new FunctionListerConsumer(&ci));
+    return std::unique_ptr<clang::ASTConsumer>(
+        new FunctionListerConsumer(&ci, counts_, o_));
+  }
+
+  FuncListerAction(lister_counts & counts, std::ostream & o)
+      : counts_(counts), o_(o)
+  {
   }
+
+private:
+  lister_counts & counts_;
+  std::ostream & o_;
 };  // FuncListerAction
 
+/* newFrontendActionFactory<T> needs a default constructible action; this
+ * factory hands each action the counts and stream for its TU. */
+class FuncListerActionFactory
+    : public clang::tooling::FrontendActionFactory {
+public:
+  std::unique_ptr<clang::FrontendAction> create() override
+  {
+    return std::make_unique<FuncListerAction>(counts_, o_);
+  }
+
+  FuncListerActionFactory(lister_counts & counts, std::ostream & o)
+      : counts_(counts), o_(o)
+  {
+  }
+
+private:
+  lister_counts & counts_;
+  std::ostream & o_;
+};  // FuncListerActionFactory
+
 static llvm::cl::OptionCategory flt_cat("func-decl-list options");
 
 int
 main(int argc, const char ** argv)
 {
   using namespace clang::tooling;
+  corct::add_tool_options(flt_cat);
   CommonOptionsParser op(argc, argv, flt_cat);
-  ClangTool tool(op.getCompilations(), op.getSourcePathList());
-  int result = tool.run(newFrontendActionFactory<FuncListerAction>().get());
-  std::cout << "Reported " << num_funcs << " functions\n";
-  std::cout << "Skipped " << num_skipped_funcs << " functions\n";
+  corct::parallel_tool tool(corct::mk_parallel_tool(op));
+  std::vector<lister_counts> counts(tool.n_jobs());
+  auto add_counts = [&](uint32_t const worker, lister_counts const & c) {
+    counts[worker].num_funcs += c.num_funcs;
+    counts[worker].num_skipped_funcs += c.num_skipped_funcs;
+  };
+  int result = tool.run(
+      [&](corct::tu_context & tu) {
+        lister_counts tu_counts;
+        FuncListerActionFactory factory(tu_counts, tu.out);
+        int const tu_rslt = tu.run(&factory);
+        add_counts(tu.worker, tu_counts);
+        tu.data() << tu_counts.num_funcs << " " << tu_counts.num_skipped_funcs
+                  << "\n";
+        return tu_rslt;
+      },
+      [&](corct::tu_context & tu, std::istream & data) {
+        lister_counts tu_counts;
+        data >> tu_counts.num_funcs >> tu_counts.num_skipped_funcs;
+        add_counts(tu.worker, tu_counts);
+      });
+  lister_counts total;
+  for(auto & c : counts) {
+    total.num_funcs += c.num_funcs;
+    total.num_skipped_funcs += c.num_skipped_funcs;
+  }
+  std::cout << "Reported " << total.num_funcs << " functions\n";
+  std::cout << "Skipped " << total.num_skipped_funcs << " functions\n";
   return result;
 }
 // End of file
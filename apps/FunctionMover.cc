@@ -6,8 +6,11 @@
  * This application demonstrates matching the function, recovering the source,
  * and cutting the source from the original file. */
 
+#include "apply_replacements.h"
 #include "dump_things.h"
+#include "fix_export.h"
 #include "make_replacement.h"
+#include "tool_options.h"
 #include "types.h"
 #include "utilities.h"
 
@@ -16,6 +19,7 @@
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Refactoring.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
 #include <iostream>
 #include <string>
 
@@ -67,9 +71,9 @@ struct Function_Mover : public clang::ast_matchers::MatchFinder::MatchCallback {
       const char * buff_end(sm.getCharacterData(decl_end_end));
       std::string const func_string(buff_begin, buff_end);
       // now you have original source of declaration, output to new file etc.
-      std::cout << "Captured function " << f_decl->getNameAsString()
-                << " declaration:\n'''\n"
-                << func_string << "\n'''\n";
+      o_ << "Captured function " << f_decl->getNameAsString()
+         << " declaration:\n'''\n"
+         << func_string << "\n'''\n";
       // Generate a replacement to eliminate the function declaration in
       // the original source
       uint32_t const decl_length =
@@ -79,10 +83,7 @@ struct Function_Mover : public clang::ast_matchers::MatchFinder::MatchCallback {
       // declaration was found
       auto ref_filename = sm.getFilename(decl_begin);
       std::string filename{ref_filename.str()};
-      if(repls_[filename].add(repl)) {
-        std::cerr << "Failed to enter replacement to map for file " << filename
-                  << "\n";
-      }
+      corct::add_replacement(repls_[filename], repl);
     }
     else {
       corct::check_ptr(f_decl, "f_decl");
@@ -90,9 +91,12 @@ struct Function_Mover : public clang::ast_matchers::MatchFinder::MatchCallback {
     return;
   }  // run
 
-  explicit Function_Mover(repl_map_t & repls) : repls_(repls) {}
+  Function_Mover(repl_map_t & repls, std::ostream & o) : repls_(repls), o_(o)
+  {
+  }
 
   repl_map_t & repls_;
+  std::ostream & o_;
 };  // struct Function_Mover
 
 static llvm::cl::OptionCategory FMOpts("Common options for function-mover");
@@ -100,29 +104,77 @@ static llvm::cl::OptionCategory FMOpts("Common options for function-mover");
 const char * addl_help =
     "(Incomplete) Demo of moving function from one file to another";
 
+static llvm::cl::opt<std::string> export_dir(
+    "export-fixes",
+    llvm::cl::desc("write each TU's edits to a YAML file in this directory, "
+                   "for apply-fixes, instead of rewriting the sources"),
+    llvm::cl::value_desc("directory"),
+    llvm::cl::cat(FMOpts));
+
 int
 main(int argc, const char ** argv)
 {
   using namespace corct;
+  add_tool_options(FMOpts);
   CommonOptionsParser opt_prs(argc, argv, FMOpts, addl_help);
-  RefactoringTool tool(opt_prs.getCompilations(), opt_prs.getSourcePathList());
-  Function_Mover fm(tool.getReplacements());
-  finder_t finder;
+  parallel_tool tool(mk_parallel_tool(opt_prs));
+  symbol_table rep_syms;
+  std::vector<replacement_set> worker_repls;
+  for(uint32_t w = 0; w < tool.n_jobs(); ++w) {
+    worker_repls.emplace_back(rep_syms);
+  }
   std::string const function_name("foo");  // could get from CL options
-  finder.addMatcher(fm.matcher(function_name), &fm);
-  // runs, reports, does not overwrite:
-  // tool.run(newFrontendActionFactory(&finder).get());
-  // invoke instead to overwrite original source:
-  tool.runAndSave(newFrontendActionFactory(&finder).get());
-
-  for(auto & p : tool.getReplacements()) {
-    auto & fname = p.first;
-    auto & repls = p.second;
-    std::cout << "Replacements collected for file \"" << fname
-              << "\" (not applied):\n";
-    for(auto & r : repls) { std::cout << "\t" << r.toString() << "\n"; }
+  if(!export_dir.empty() &&
+     llvm::sys::fs::create_directories(std::string(export_dir))) {
+    std::cerr << "function-mover: cannot create " << export_dir << "\n";
+    return 1;
+  }
+  tool.add_cache_salt("function-mover");
+  tool.add_cache_salt(export_dir);
+  int const status = tool.run(
+      [&](tu_context & tu) {
+        Function_Mover::repl_map_t tu_repls;
+        Function_Mover fm(tu_repls, tu.out);
+        tu.add_matcher(fm.matcher(function_name), &fm);
+        int const tu_status = tu.run();
+        if(export_dir.empty()) {
+          string_t const dir = tu.working_directory();
+          add_replacements(worker_repls[tu.worker], tu_repls, tu.source, dir);
+          // a journaled TU's edits come back through the replay below
+          if(tool.keeps_tu_data()) {
+            write_fixes(tu.data(), tu.source, tu_repls, dir);
+          }
+          return tu_status;
+        }
+        std::string err;
+        if(!export_fixes(export_dir, tu.run_index, tu.source, tu_repls, err)) {
+          std::cerr << "function-mover: " << err << "\n";
+          return 1;
+        }
+        return tu_status;
+      },
+      [&](tu_context & tu, std::istream & data) {
+        // with -export-fixes, the TU's fixes file was written last time
+        std::string err;
+        if(export_dir.empty() &&
+           !read_fixes(data, worker_repls[tu.worker], err)) {
+          std::cerr << "function-mover: " << tu.source << ": " << err << "\n";
+        }
+      });
+  if(!export_dir.empty()) { return status; }
+  replacement_set & all_repls(worker_repls[0]);
+  for(uint32_t w = 1; w < worker_repls.size(); ++w) {
+    all_repls.merge(worker_repls[w]);
+  }
+  std::cout << "Replacements collected:\n";
+  all_repls.write(std::cout);
+  if(!all_repls.conflicts().empty()) {
+    all_repls.write_conflicts(std::cerr);
+    std::cerr << "function-mover: replacements conflict; nothing written\n";
+    return 1;
   }
-  return 0;
+  // comment this out to run and report without overwriting:
+  return all_repls.apply() != 0 ? 1 : status;
 }  // main
 
 void
@@ -6,6 +6,7 @@
 
 #include "dump_things.h"
 #include "make_replacement.h"
+#include "tool_options.h"
 #include "types.h"
 #include "utilities.h"
 
@@ -61,16 +62,20 @@ struct Function_Printer
       const char * buff_begin(sm.getCharacterData(decl_begin));
       const char * buff_end(sm.getCharacterData(decl_end_end));
       std::string const func_string(buff_begin, buff_end);
-      std::cout << "Captured function " << f_decl->getNameAsString()
-                << " declaration:\n'''\n"
-                << func_string << "\n'''\n";
+      o_ << "Captured function " << f_decl->getNameAsString()
+         << " declaration:\n'''\n"
+         << func_string << "\n'''\n";
     }
     else {
       corct::check_ptr(f_decl, "f_decl");
     }
     return;
   }  // run
-};   // struct Function_Printer
+
+  explicit Function_Printer(std::ostream & o) : o_(o) {}
+
+  std::ostream & o_;
+};  // struct Function_Printer
 
 static llvm::cl::OptionCategory FPOpts("Common options for function-printer");
 
@@ -87,12 +92,14 @@ int
 main(int argc, const char ** argv)
 {
   using namespace corct;
+  add_tool_options(FPOpts);
   CommonOptionsParser opt_prs(argc, argv, FPOpts, addl_help);
-  RefactoringTool Tool(opt_prs.getCompilations(), opt_prs.getSourcePathList());
-  Function_Printer fp;
-  finder_t finder;
-  finder.addMatcher(fp.matcher(function_name), &fp);
-  Tool.run(newFrontendActionFactory(&finder).get());
+  parallel_tool Tool(mk_parallel_tool(opt_prs));
+  Tool.run([&](tu_context & tu) {
+    Function_Printer fp(tu.out);
+    tu.add_matcher(fp.matcher(function_name), &fp);
+    return tu.run();
+  });
   return 0;
 }  // main
 
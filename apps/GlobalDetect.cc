@@ -7,7 +7,9 @@
 #include "global_matchers.h"
 #include "llvm/Support/CommandLine.h"
 #include "summarize_command_line.h"
+#include "tool_options.h"
 #include <iostream>
+#include <vector>
 
 using namespace clang::tooling;
 using namespace llvm;
@@ -33,6 +35,20 @@ static cl::opt<bool> report_functions(
     cl::cat(GDOpts),
     cl::init(false));
 
+static cl::opt<bool> jsonl(
+    "jsonl",
+    cl::desc("write one JSON object per reference (file, line, col, "
+             "function, symbol) instead of sentences"),
+    cl::cat(GDOpts),
+    cl::init(false));
+
+static cl::opt<bool> track_scope(
+    "track-scope",
+    cl::desc("find each use's enclosing function while walking the AST, "
+             "instead of searching its ancestors (faster, less memory)"),
+    cl::cat(GDOpts),
+    cl::init(false));
+
 static cl::opt<bool> export_opts("xp",
                                  cl::desc("export command line options"),
                                  cl::value_desc("bool"),
@@ -43,29 +59,69 @@ int
 main(int argc, const char ** argv)
 {
   using namespace corct;
+  add_tool_options(GDOpts);
   CommonOptionsParser OptionsParser(argc, argv, GDOpts, addl_help);
-  ClangTool Tool(OptionsParser.getCompilations(),
-                 OptionsParser.getSourcePathList());
+  parallel_tool Tool(mk_parallel_tool(OptionsParser));
 
   if(export_opts) {
     summarize_command_line("global-detect", addl_help);
     return 0;
   }
 
-  Global_Printer printer(std::cout);
   StatementMatcher global_var_matcher =
       (old_var_string == "") ? all_global_var_matcher()
                              : mk_global_var_matcher(old_var_string);
+  StatementMatcher scoped_var_matcher =
+      mk_scoped_global_var_matcher(old_var_string);
   DeclarationMatcher global_func_matcher =
       (old_var_string == "") ? all_global_fn_matcher()
                              : mk_global_fn_matcher(old_var_string);
 
-  clang::ast_matchers::MatchFinder finder;
-  if(report_functions) { finder.addMatcher(global_func_matcher, &printer); }
-  else {
-    finder.addMatcher(global_var_matcher, &printer);
+  symbol_table syms;
+  // each worker's uses of globals, for -partial
+  std::vector<Global_Printer> totals;
+  for(uint32_t w = 0; w < Tool.n_jobs(); ++w) {
+    totals.emplace_back(std::cout, syms);
+  }
+  // ":2": TU data holds the uses, not nothing
+  Tool.add_cache_salt("global-detect:2");
+  Tool.add_cache_salt(old_var_string);
+  Tool.add_cache_salt(report_functions ? "functions" : "references");
+  Tool.add_cache_salt(jsonl ? "jsonl" : "text");
+  Tool.add_cache_salt(track_scope ? "scope" : "ancestor");
+  int const status = Tool.run(
+      [&](tu_context & tu) {
+        Global_Printer printer(tu.out, syms);
+        if(jsonl) { printer.set_format(output_format::jsonl); }
+        int tu_status(0);
+        if(report_functions) {
+          tu.add_matcher(global_func_matcher, &printer);
+          tu_status = tu.run();
+        }
+        else if(track_scope) {
+          function_scope_finder fsf;
+          fsf.add_matcher(scoped_var_matcher, &printer);
+          printer.use_scope(fsf.scope());
+          fsf.register_with(tu);
+          tu_status = tu.run();
+        }
+        else {
+          tu.add_matcher(global_var_matcher, &printer);
+          tu_status = tu.run();
+        }
+        totals[tu.worker].merge(printer);
+        if(Tool.keeps_tu_data()) { printer.write(tu.data()); }
+        return tu_status;
+      },
+      [&](tu_context & tu, std::istream & data) {
+        totals[tu.worker].read(data);
+      });
+  if(!partial_path().empty()) {
+    for(uint32_t w = 1; w < totals.size(); ++w) { totals[0].merge(totals[w]); }
+    auto write = [&totals](std::ostream & o) { totals[0].write(o); };
+    return write_partial("global-detect", write) ? status : 1;
   }
-  return Tool.run(newFrontendActionFactory(&finder).get());
+  return status;
 }  // main
 
 // End of file
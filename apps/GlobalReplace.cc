@@ -4,11 +4,15 @@
 
 /* Like GlobalDetect, only now we're trying to replace some stuff. */
 
+#include "apply_replacements.h"
 #include "callsite_expander.h"
 #include "dump_things.h"
+#include "fix_export.h"
 #include "function_signature_expander.h"
 #include "global_variable_replacer.h"
 #include "make_replacement.h"
+#include "parameter_threading.h"
+#include "rewrite_manifest.h"
 #include "utilities.h"
 
 #include "clang/AST/ASTContext.h"
@@ -22,7 +26,9 @@
 #include "clang/Tooling/Refactoring.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
 #include "summarize_command_line.h"
+#include "tool_options.h"
 #include <iostream>
 #include <vector>
 
@@ -106,11 +112,51 @@ static cl::opt<std::string> target_func_string(
     cl::value_desc("target-function-string"),
     cl::cat(CompilationOpts));
 
+static cl::opt<std::string> call_graph_path(
+    "call-graph",
+    cl::desc("with -Xpnd, find the target functions instead of taking them "
+             "from -tf: every function that uses one of the -gvar globals, "
+             "and all their callers up to the -entry functions, using this "
+             "call graph (see call-graph)"),
+    cl::value_desc("file"),
+    cl::cat(CompilationOpts));
+
+static cl::opt<std::string> entry_func_string(
+    "entry",
+    cl::desc("with -call-graph, the functions where threading stops; they "
+             "declare the new local and are not expanded (default: main)"),
+    cl::value_desc("functions"),
+    cl::cat(CompilationOpts),
+    cl::init("main"));
+
+static cl::opt<std::string> manifest_path(
+    "manifest",
+    cl::desc("carry out every rewrite listed in this JSON file in one pass "
+             "(see rewrite_manifest.h), instead of -R or -Xpnd; with -d, "
+             "check the rewrites for conflicts without writing them"),
+    cl::value_desc("file"),
+    cl::cat(CompilationOpts));
+
+static cl::opt<std::string> export_dir(
+    "export-fixes",
+    cl::desc("instead of rewriting the sources, write each TU's edits to a "
+             "YAML file in this directory as soon as the TU is done; apply "
+             "them later with apply-fixes or clang-apply-replacements"),
+    cl::value_desc("directory"),
+    cl::cat(CompilationOpts));
+
 static cl::opt<bool> dry_run("d",
                              cl::desc("dry run"),
                              cl::cat(CompilationOpts),
                              cl::init(false));
 
+static cl::opt<bool> combined(
+    "combined",
+    cl::desc("use one matcher for all targets of each kind, rather than one "
+             "matcher per target; much faster with many targets"),
+    cl::cat(CompilationOpts),
+    cl::init(false));
+
 static cl::opt<bool> export_opts("xp",
                                  cl::desc("export command line options"),
                                  cl::value_desc("bool"),
@@ -140,72 +186,348 @@ list_compilations(CommonOptionsParser & opt_prs)
   return;
 }
 
+/**\brief Add to targ_fns the functions that use one of g_vars, and their
+ * transitive callers from the -call-graph file, in one pass over the
+ * sources. */
+bool
+thread_targets(corct::parallel_tool & tool,
+               vec_str const & g_vars,
+               vec_str & targ_fns)
+{
+  using corct::global_user_finder;
+  corct::call_graph_file g;
+  std::string err;
+  if(!g.open(call_graph_path, err)) {
+    std::cerr << "global-replace: " << err << "\n";
+    return false;
+  }
+  std::vector<global_user_finder> finders(tool.n_jobs());
+  auto const matcher = global_user_finder::matcher(g_vars);
+  tool.add_cache_salt("global-users:" + old_var_string);
+  int const status = tool.run(
+      [&](corct::tu_context & tu) {
+        if(!tool.keeps_tu_data()) {
+          tu.add_matcher(matcher, &finders[tu.worker]);
+          return tu.run();
+        }
+        // keep this TU's users separate, so they can be cached
+        global_user_finder tu_finder;
+        tu.add_matcher(matcher, &tu_finder);
+        int const tu_status = tu.run();
+        tu_finder.write(tu.data());
+        finders[tu.worker].merge(tu_finder);
+        return tu_status;
+      },
+      [&](corct::tu_context & tu, std::istream & data) {
+        finders[tu.worker].read(data);
+      });
+  if(status != 0) {
+    std::cerr << "global-replace: errors while finding users of globals\n";
+  }
+  for(uint32_t w = 1; w < finders.size(); ++w) { finders[0].merge(finders[w]); }
+  vec_str const found = corct::threading_targets(
+      g, finders[0].users(), corct::split(entry_func_string, ','));
+  std::cout << finders[0].users().size() << " functions use the globals, "
+            << found.size() << " need the new parameter\n";
+  targ_fns.insert(targ_fns.end(), found.begin(), found.end());
+  return true;
+}  // thread_targets
+
+/**\brief With -export-fixes, write a TU's edits to the export directory.
+ * \return false if they could not be written */
+bool
+export_tu(corct::tu_context const & tu, corct::vec_repl const & reps)
+{
+  std::string err;
+  if(corct::export_fixes(export_dir, tu.run_index, tu.source, reps, err)) {
+    return true;
+  }
+  std::cerr << "global-replace: " << err << "\n";
+  return false;
+}  // export_tu
+
+/**\brief After an -export-fixes run, say where the edits went. */
+int
+report_export(int const status)
+{
+  std::cout << "Edits written to " << export_dir << "; apply them with "
+            << "'apply-fixes " << export_dir << "'\n";
+  return status;
+}
+
+/**\brief Restore the edits a journaled (or cached) TU wrote to its data()
+ * as fixes. With -export-fixes, its fixes file was written last time. */
+void
+replay_fixes(corct::tu_context const & tu,
+             std::istream & data,
+             corct::replacement_set & set)
+{
+  std::string err;
+  if(export_dir.empty() && !corct::read_fixes(data, set, err)) {
+    std::cerr << "global-replace: " << tu.source << ": " << err << "\n";
+  }
+  return;
+}
+
+using v_replacer_t = corct::global_variable_replacer;
+using f_expander_t = corct::function_signature_expander;
+using s_expander_t = corct::expand_callsite;
+
+/**\brief Carry out every rewrite in the -manifest file. Each TU is parsed
+ * once, with the matchers of all the specs. Nothing is written if any two
+ * edits conflict, whether from two specs or from two TUs. */
+int
+run_manifest(corct::parallel_tool & tool)
+{
+  using namespace corct;
+  rewrite_specs_t specs;
+  std::string err;
+  if(!read_manifest(manifest_path, specs, err)) {
+    std::cerr << "global-replace: " << err << "\n";
+    return -1;
+  }
+  if(check_manifest(specs) > 0) {
+    std::cerr << "global-replace: specs in " << manifest_path
+              << " conflict; nothing done\n";
+    return -1;
+  }
+  size_t const n_specs = specs.size();
+  uint32_t const n_jobs = tool.n_jobs();
+  /* Callbacks and replacement maps for spec s and worker w are at
+   * s * n_jobs + w. Edits are always gathered, so that -d can check them. */
+  std::vector<replacements_map_t> rep_maps(n_specs * n_jobs);
+  std::vector<std::unique_ptr<v_replacer_t>> v_replacers(rep_maps.size());
+  std::vector<std::unique_ptr<f_expander_t>> f_expanders(rep_maps.size());
+  std::vector<std::unique_ptr<s_expander_t>> s_expanders(rep_maps.size());
+  std::vector<v_replacer_t::matchers_t> ref_matchers(n_specs);
+  std::vector<f_expander_t::matchers_t> exp_matchers(n_specs);
+  std::vector<s_expander_t::matchers_t> site_matchers(n_specs);
+  symbol_table rep_syms;
+  std::vector<replacement_set> rep_sets;
+  for(uint32_t w = 0; w < n_jobs; ++w) { rep_sets.emplace_back(rep_syms); }
+  for(size_t s = 0; s < n_specs; ++s) {
+    rewrite_spec const & spec(specs[s]);
+    for(uint32_t w = 0; w < n_jobs; ++w) {
+      size_t const i = s * n_jobs + w;
+      if(spec.replaces()) {
+        v_replacers[i] = std::make_unique<v_replacer_t>(
+            rep_maps[i], spec.gvars, spec.lvars, false);
+      }
+      if(spec.expands()) {
+        f_expanders[i] = std::make_unique<f_expander_t>(
+            rep_maps[i], spec.targets, spec.new_param, false);
+        s_expanders[i] = std::make_unique<s_expander_t>(
+            rep_maps[i], spec.targets, spec.new_arg, false);
+      }
+    }
+    size_t const i0 = s * n_jobs;
+    if(spec.replaces()) {
+      ref_matchers[s] = v_replacers[i0]->combined_matchers();
+    }
+    if(spec.expands()) {
+      exp_matchers[s] = f_expanders[i0]->combined_fn_matchers();
+      site_matchers[s] = s_expanders[i0]->combined_fn_matchers();
+    }
+  }
+  std::cout << n_specs << " rewrites from " << manifest_path << "\n";
+  // the specs, not the path: an edited manifest must not replay old edits
+  tool.add_cache_salt("manifest:" + manifest_salt(specs));
+  tool.add_cache_salt(export_dir);
+  int const status = tool.run(
+      [&](tu_context & tu) {
+        for(size_t s = 0; s < n_specs; ++s) {
+          size_t const i = s * n_jobs + tu.worker;
+          for(auto & m : ref_matchers[s]) {
+            tu.add_matcher(m, v_replacers[i].get());
+          }
+          for(auto & m : site_matchers[s]) {
+            tu.add_matcher(m, s_expanders[i].get());
+          }
+          for(auto & m : exp_matchers[s]) {
+            tu.add_matcher(m, f_expanders[i].get());
+          }
+        }
+        int const tu_status = tu.run();
+        if(!export_dir.empty()) {
+          vec_repl tu_reps;
+          for(size_t s = 0; s < n_specs; ++s) {
+            size_t const i = s * n_jobs + tu.worker;
+            vec_repl const spec_reps(flatten(rep_maps[i]));
+            tu_reps.insert(tu_reps.end(), spec_reps.begin(), spec_reps.end());
+            rep_maps[i].clear();
+          }
+          return export_tu(tu, tu_reps) ? tu_status : 1;
+        }
+        // edits are tagged with spec and TU, so conflicts name both
+        string_t const dir = tu.working_directory();
+        for(size_t s = 0; s < n_specs; ++s) {
+          size_t const i = s * n_jobs + tu.worker;
+          string_t const source = specs[s].name + " (" + tu.source + ")";
+          add_replacements(rep_sets[tu.worker], rep_maps[i], source, dir);
+          // one fixes document per spec, so replay keeps the tags
+          if(tool.keeps_tu_data()) {
+            write_fixes(tu.data(), source, rep_maps[i], dir);
+          }
+          rep_maps[i].clear();
+        }
+        return tu_status;
+      },
+      [&](tu_context & tu, std::istream & data) {
+        replay_fixes(tu, data, rep_sets[tu.worker]);
+      });
+  if(!export_dir.empty()) { return report_export(status); }
+
+  replacement_set & reps(rep_sets[0]);
+  for(uint32_t w = 1; w < n_jobs; ++w) { reps.merge(rep_sets[w]); }
+  std::cout << reps.n_edits() << " edits to " << reps.n_files() << " files ("
+            << reps.n_duplicates() << " duplicates dropped)\n";
+  if(!reps.conflicts().empty()) {
+    reps.write_conflicts(std::cerr);
+    std::cerr << "global-replace: rewrites conflict; nothing written\n";
+    return 1;
+  }
+  if(dry_run) { return status; }
+  return reps.apply() != 0 ? 1 : status;
+}  // run_manifest
+
 int
 main(int argc, const char ** argv)
 {
   using corct::replacements_map_t;
   using corct::split;
+  corct::add_tool_options(CompilationOpts);
   CommonOptionsParser opt_prs(argc, argv, CompilationOpts, addl_help);
   if(export_opts) {
     corct::summarize_command_line("global-replace", addl_help);
     return 0;
   }
-  RefactoringTool tool(opt_prs.getCompilations(), opt_prs.getSourcePathList());
+  corct::parallel_tool tool(corct::mk_parallel_tool(opt_prs));
 
   announce_dry(dry_run);
   list_compilations(opt_prs);
+  if(!export_dir.empty() &&
+     llvm::sys::fs::create_directories(std::string(export_dir))) {
+    std::cerr << "global-replace: cannot create " << export_dir << "\n";
+    return -1;
+  }
+  if(!manifest_path.empty()) {
+    if(rep_refs || expand_func) {
+      std::cerr << "-manifest replaces -R and -Xpnd\n";
+      return -1;
+    }
+    return run_manifest(tool);
+  }
 
   vec_str old_var_strings(split(old_var_string, ','));
   vec_str new_var_strings(split(new_var_string, ','));
-  if(old_var_strings.size() != new_var_strings.size()) {
+  bool const thread_params = expand_func && !call_graph_path.empty();
+  if(thread_params && (rep_refs || old_var_strings.empty())) {
+    std::cerr << "-call-graph needs -Xpnd and -gvar, and not -R\n";
+    return -1;
+  }
+  // with -call-graph, -gvar only picks out the targets, so -lvar is optional
+  if(old_var_strings.size() != new_var_strings.size() && !thread_params) {
     std::cerr << "Must have one replacement for each global variable!\n";
     return -1;
   }
 
-  replacements_map_t & rep_map = tool.getReplacements();
-
-  corct::global_variable_replacer v_replacer(rep_map, old_var_strings,
-                                             new_var_strings, dry_run);
-
   // sort out target functions
   vec_str targ_fns(split(target_func_string, ','));
+  if(thread_params) {
+    if(!thread_targets(tool, old_var_strings, targ_fns)) { return -1; }
+    old_var_strings.clear();
+    new_var_strings.clear();
+  }
 
-  corct::function_signature_expander f_expander(rep_map, targ_fns,
-                                                new_func_param_string, dry_run);
-
-  corct::expand_callsite s_expander(rep_map, targ_fns, new_func_arg_string,
-                                    dry_run);
-
-  clang::ast_matchers::MatchFinder finder;
+  /* Each worker gathers a TU's replacements in its own map, with its own
+   * callbacks, then moves them to its replacement_set. The sets are merged
+   * and written after all TUs have been processed. */
+  std::vector<replacements_map_t> rep_maps(tool.n_jobs());
+  corct::symbol_table rep_syms;
+  std::vector<corct::replacement_set> rep_sets;
+  for(uint32_t w = 0; w < tool.n_jobs(); ++w) {
+    rep_sets.emplace_back(rep_syms);
+  }
+  std::vector<std::unique_ptr<v_replacer_t>> v_replacers;
+  std::vector<std::unique_ptr<f_expander_t>> f_expanders;
+  std::vector<std::unique_ptr<s_expander_t>> s_expanders;
+  for(auto & rep_map : rep_maps) {
+    v_replacers.emplace_back(std::make_unique<v_replacer_t>(
+        rep_map, old_var_strings, new_var_strings, dry_run));
+    f_expanders.emplace_back(std::make_unique<f_expander_t>(
+        rep_map, targ_fns, new_func_param_string, dry_run));
+    s_expanders.emplace_back(std::make_unique<s_expander_t>(
+        rep_map, targ_fns, new_func_arg_string, dry_run));
+  }
 
-  corct::global_variable_replacer::matchers_t global_ref_matchers =
-      v_replacer.matchers();
-  corct::function_signature_expander::matchers_t exp_matchers =
-      f_expander.fn_matchers();
-  corct::expand_callsite::matchers_t site_matchers = s_expander.fn_matchers();
+  // computed target lists are long, so use one matcher for all of them
+  bool const one_matcher = combined || thread_params;
+  v_replacer_t::matchers_t global_ref_matchers =
+      one_matcher ? v_replacers[0]->combined_matchers()
+                  : v_replacers[0]->matchers();
+  f_expander_t::matchers_t exp_matchers =
+      one_matcher ? f_expanders[0]->combined_fn_matchers()
+                  : f_expanders[0]->fn_matchers();
+  s_expander_t::matchers_t site_matchers =
+      one_matcher ? s_expanders[0]->combined_fn_matchers()
+                  : s_expanders[0]->fn_matchers();
 
   std::cout << targ_fns.size() << " targets, along with " << exp_matchers.size()
             << " matchers\n";
 
-  if(rep_refs) {
-    for(auto & m : global_ref_matchers) { finder.addMatcher(m, &v_replacer); }
-  }
-  else if(expand_func) {
-    std::cout << "Expanding functions\n";
-    for(uint32_t i = 0; i < site_matchers.size(); ++i) {
-      finder.addMatcher(site_matchers[i], &s_expander);
-      finder.addMatcher(exp_matchers[i], &f_expander);
-    }
-  }
-
-  tool.runAndSave(newFrontendActionFactory(&finder).get());
-
-  llvm::outs() << "Replacements collected: \n";
-  for(auto & p : tool.getReplacements()) {
-    llvm::outs() << "file: " << p.first << ":\n";
-    for(auto & r : p.second) { llvm::outs() << r.toString() << "\n"; }
+  if(expand_func && !rep_refs) { std::cout << "Expanding functions\n"; }
+  // everything that changes the edits, so a -resume can't mix settings
+  tool.add_cache_salt(rep_refs ? "replace" : (expand_func ? "expand" : ""));
+  tool.add_cache_salt(old_var_string + "/" + new_var_string);
+  tool.add_cache_salt(new_func_param_string + "/" + new_func_arg_string);
+  for(auto & f : targ_fns) { tool.add_cache_salt(f); }
+  tool.add_cache_salt(export_dir);
+  int const status = tool.run(
+      [&](corct::tu_context & tu) {
+        uint32_t const w = tu.worker;
+        if(rep_refs) {
+          for(auto & m : global_ref_matchers) {
+            tu.add_matcher(m, v_replacers[w].get());
+          }
+        }
+        else if(expand_func) {
+          for(uint32_t i = 0; i < site_matchers.size(); ++i) {
+            tu.add_matcher(site_matchers[i], s_expanders[w].get());
+            tu.add_matcher(exp_matchers[i], f_expanders[w].get());
+          }
+        }
+        int tu_status = tu.run();
+        if(!export_dir.empty()) {
+          if(!export_tu(tu, corct::flatten(rep_maps[w]))) { tu_status = 1; }
+        }
+        else {
+          // hand this TU's edits to the worker's set, which keeps one copy
+          // of each
+          corct::string_t const dir = tu.working_directory();
+          corct::add_replacements(rep_sets[w], rep_maps[w], tu.source, dir);
+          if(tool.keeps_tu_data()) {
+            corct::write_fixes(tu.data(), tu.source, rep_maps[w], dir);
+          }
+        }
+        rep_maps[w].clear();
+        return tu_status;
+      },
+      [&](corct::tu_context & tu, std::istream & data) {
+        replay_fixes(tu, data, rep_sets[tu.worker]);
+      });
+  if(!export_dir.empty()) { return report_export(status); }
+
+  corct::replacement_set & reps(rep_sets[0]);
+  for(uint32_t w = 1; w < rep_sets.size(); ++w) { reps.merge(rep_sets[w]); }
+  std::cout << "Replacements collected: \n";
+  reps.write(std::cout);
+  if(!reps.conflicts().empty()) {
+    reps.write_conflicts(std::cerr);
+    std::cerr << "global-replace: replacements conflict; nothing written\n";
+    return 1;
   }
-  return 0;
+  if(dry_run) { return status; }
+  return reps.apply() != 0 ? 1 : status;
 }  // main
 
 // End of file
@@ -11,8 +11,10 @@
 #include "clang/Tooling/Tooling.h"
 #include "dump_things.h"
 #include "llvm/Support/CommandLine.h"
+#include "tool_options.h"
 #include "utilities.h"
 #include <iostream>
+#include <numeric>
 
 using namespace clang::tooling;
 using namespace llvm;
@@ -54,9 +56,9 @@ struct CallPrinter : public MatchFinder::MatchCallback {
       num_calls++;
       auto const method_name(call->getMethodDecl()->getNameAsString());
       auto const callee_name(call->getRecordDecl()->getNameAsString());
-      std::cout << "Method '" << method_name << "' invoked by object of type '"
-                << callee_name << "' at "
-                << corct::locationAsString(call->getBeginLoc(), &sm) << "\n";
+      o_ << "Method '" << method_name << "' invoked by object of type '"
+         << callee_name << "' at "
+         << corct::locationAsString(call->getBeginLoc(), &sm) << "\n";
     }
     else {
       corct::check_ptr(call, "call");
@@ -64,6 +66,9 @@ struct CallPrinter : public MatchFinder::MatchCallback {
     return;
   }  // run
 
+  explicit CallPrinter(std::ostream & o) : o_(o) {}
+
+  std::ostream & o_;
   uint32_t num_calls = 0;
 };  // CallPrinter
 
@@ -78,15 +83,29 @@ static cl::opt<std::string> ns_name_string("ns",
 int
 main(int argc, const char ** argv)
 {
+  corct::add_tool_options(mem_cat);
   CommonOptionsParser OptionsParser(argc, argv, mem_cat);
-  ClangTool Tool(OptionsParser.getCompilations(),
-                 OptionsParser.getSourcePathList());
-  CallPrinter cp;
-  MatchFinder finder;
+  corct::parallel_tool Tool(corct::mk_parallel_tool(OptionsParser));
+  std::vector<uint32_t> num_calls(Tool.n_jobs(), 0);
+  auto const call_matcher(mk_call_expr_matcher(ns_name_string));
 
-  finder.addMatcher(mk_call_expr_matcher(ns_name_string), &cp);
-  int rslt = Tool.run(newFrontendActionFactory(&finder).get());
-  std::cout << "Reported " << cp.num_calls << " member calls\n";
+  int rslt = Tool.run(
+      [&](corct::tu_context & tu) {
+        CallPrinter cp(tu.out);
+        tu.add_matcher(call_matcher, &cp);
+        int const tu_rslt = tu.run();
+        num_calls[tu.worker] += cp.num_calls;
+        tu.data() << cp.num_calls << "\n";
+        return tu_rslt;
+      },
+      [&](corct::tu_context & tu, std::istream & data) {
+        uint32_t n(0);
+        data >> n;
+        num_calls[tu.worker] += n;
+      });
+  std::cout << "Reported "
+            << std::accumulate(num_calls.begin(), num_calls.end(), 0u)
+            << " member calls\n";
   return rslt;
 }
 
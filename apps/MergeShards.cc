@@ -0,0 +1,146 @@
+// MergeShards.cc
+// Oct 17, 2026
+
+/* Combine the -partial files written by the shards of a run (-shard=i/N)
+ * into whole-program results. The tool that wrote the files is read from
+ * their headers. For struct-field-use and template-vars-report, that is the
+ * report one process over all the sources would have written. For
+ * global-detect it is each function/global pair, and for callsite-lister
+ * each caller-callee edge with its call count: the per-site lines those
+ * tools print are in each shard's own output, and are not repeated. */
+
+#include "callsite_lister.h"
+#include "field_use_file.h"
+#include "global_matchers.h"
+#include "shard.h"
+#include "struct_field_user.h"
+#include "template_var_matchers.h"
+
+#include "llvm/Support/CommandLine.h"
+#include <fstream>
+#include <iostream>
+
+using namespace llvm;
+
+const char * addl_help =
+    "Merge the partial results of a sharded run: struct field uses or "
+    "template argument types as their tools report them, the globals each "
+    "function uses, or caller-callee edges with call counts";
+
+static cl::OptionCategory MSOpts("merge-shards options");
+
+static cl::list<std::string> partial_paths(
+    cl::Positional,
+    cl::desc("<partial-results file> ..."),
+    cl::OneOrMore,
+    cl::cat(MSOpts));
+
+static cl::opt<std::string> bin_file(
+    "bin",
+    cl::desc("struct-field-use results: write the uses to this file in the "
+             "binary columnar format instead of printing them"),
+    cl::value_desc("file"),
+    cl::cat(MSOpts));
+
+static cl::opt<bool> jsonl(
+    "jsonl",
+    cl::desc("callsite-lister results: write the edges as JSON Lines"),
+    cl::cat(MSOpts),
+    cl::init(false));
+
+/**\brief Read every partial file, which must all come from 'kind', into
+ * acc.
+ * \return false, after reporting the problem, if any can't be read */
+template <typename Acc_t>
+bool
+read_partials(corct::str_t_cr kind, Acc_t & acc)
+{
+  for(auto & path : partial_paths) {
+    std::ifstream in(path);
+    std::string file_kind;
+    if(!in || !corct::read_shard_header(in, file_kind)) {
+      std::cerr << "merge-shards: " << path
+                << " is not a partial-results file\n";
+      return false;
+    }
+    if(file_kind != kind) {
+      std::cerr << "merge-shards: " << path << " is from " << file_kind
+                << ", not " << kind << "\n";
+      return false;
+    }
+    if(!acc.read(in)) {
+      std::cerr << "merge-shards: error reading " << path << "\n";
+      return false;
+    }
+  }
+  return true;
+}  // read_partials
+
+int
+main(int argc, const char ** argv)
+{
+  using namespace corct;
+  cl::HideUnrelatedOptions(MSOpts);
+  cl::ParseCommandLineOptions(argc, argv, addl_help);
+  std::string kind;
+  {
+    std::ifstream in(partial_paths[0]);
+    if(!read_shard_header(in, kind)) {
+      std::cerr << "merge-shards: " << partial_paths[0]
+                << " is not a partial-results file\n";
+      return 1;
+    }
+  }
+  if("struct-field-use" == kind) {
+    vec_str no_targets;
+    struct_field_user s_finder(no_targets);
+    if(!read_partials(kind, s_finder)) { return 1; }
+    if(!bin_file.empty()) {
+      std::ofstream o(bin_file, std::ios::binary);
+      write_field_uses(s_finder.lhs_uses(), s_finder.non_lhs_uses(), o);
+      if(!o) {
+        std::cerr << "merge-shards: error writing " << bin_file << "\n";
+        return 1;
+      }
+      return 0;
+    }
+    std::cout << "Fields written:\n";
+    print_fields(s_finder.lhs_uses());
+    std::cout << "Fields accessed, but not written:\n";
+    print_fields(s_finder.non_lhs_uses());
+    return 0;
+  }
+  if("template-vars-report" == kind) {
+    template_var_reporter tr("");
+    if(!read_partials(kind, tr)) { return 1; }
+    process_type_set(collate_types(tr.args_), std::cout);
+    return 0;
+  }
+  if("global-detect" == kind) {
+    Global_Printer printer(std::cout);
+    if(!read_partials(kind, printer)) { return 1; }
+    for(auto & f_it : printer.named_uses()) {
+      for(auto & v : f_it.second) {
+        std::cout << f_it.first << "\t" << v << "\n";
+      }
+    }
+    std::cout << "Reported " << printer.n_matches_
+              << " references to globals\n";
+    return 0;
+  }
+  if("callsite-lister" == kind) {
+    callsite_lister csl{vec_str()};
+    if(jsonl) { csl.set_format(output_format::jsonl); }
+    if(!read_partials(kind, csl)) { return 1; }
+    csl.write_edges(std::cout);
+    // keep stdout pure JSON Lines
+    std::ostream & summary(jsonl ? std::cerr : std::cout);
+    summary << "Reported " << csl.m_num_calls << " calls\n";
+    return 0;
+  }
+  std::cerr << "merge-shards: don't know how to merge " << kind
+            << " results\n";
+  return 1;
+}  // main
+
+// End of file
@@ -5,15 +5,18 @@
 /* Find which functions use which fields. */
 
 #include "dump_things.h"
+#include "field_use_file.h"
 #include "make_replacement.h"
 #include "struct_field_user.h"
 #include "summarize_command_line.h"
+#include "tool_options.h"
 #include "utilities.h"
 
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Refactoring.h"
 #include "llvm/Support/CommandLine.h"
+#include <fstream>
 #include <iostream>
 
 using namespace clang::tooling;
@@ -31,58 +34,112 @@ static cl::opt<std::string> target_struct_string(
     cl::value_desc("target-struct-string"),
     cl::cat(SFUOpts));
 
+static cl::opt<std::string> bin_file(
+    "bin",
+    cl::desc("write the uses to this file in the binary columnar format (see "
+             "field_use_file.h) instead of printing them"),
+    cl::value_desc("file"),
+    cl::cat(SFUOpts));
+
+static cl::opt<bool> co_usage(
+    "co-usage",
+    cl::desc("also print, for each struct, how many functions use each pair "
+             "of fields"),
+    cl::cat(SFUOpts),
+    cl::init(false));
+
+static cl::opt<bool> track_scope(
+    "track-scope",
+    cl::desc("find each use's enclosing function while walking the AST, "
+             "instead of searching its ancestors (faster, less memory)"),
+    cl::cat(SFUOpts),
+    cl::init(false));
+
 static cl::opt<bool> export_opts("xp",
                                  cl::desc("export command line options"),
                                  cl::value_desc("bool"),
                                  cl::cat(SFUOpts),
                                  cl::init(false));
 
-/** Print out in various possibly useful ways. */
-template <typename MapOMapOSet>
-void
-print_fields(MapOMapOSet const & m);
-
 int
 main(int argc, const char ** argv)
 {
   using namespace corct;
+  add_tool_options(SFUOpts);
   CommonOptionsParser opt_prs(argc, argv, SFUOpts, addl_help);
   if(export_opts) {
     summarize_command_line("struct-field-use", addl_help);
     return 0;
   }
-  RefactoringTool Tool(opt_prs.getCompilations(), opt_prs.getSourcePathList());
+  parallel_tool Tool(mk_parallel_tool(opt_prs));
   vec_str targ_fns(split(target_struct_string, ','));
-  struct_field_user s_finder(targ_fns);
-  struct_field_user::matchers_t field_matchers = s_finder.matchers();
-  finder_t finder;
-  for(auto m : field_matchers) { finder.addMatcher(m, &s_finder); }
-  Tool.run(newFrontendActionFactory(&finder).get());
+  // one field user per worker thread, merged after the run
+  symbol_table syms;
+  std::vector<struct_field_user> s_finders;
+  for(uint32_t w = 0; w < Tool.n_jobs(); ++w) {
+    s_finders.emplace_back(targ_fns, syms);
+    s_finders.back().track_use_matrices(co_usage);
+  }
+  struct_field_user::matchers_t field_matchers =
+      s_finders[0].matchers(!track_scope);
+  // Register the field matchers for one TU, and run it
+  auto run_tu = [&](tu_context & tu, struct_field_user & finder) {
+    if(!track_scope) {
+      for(auto m : field_matchers) { tu.add_matcher(m, &finder); }
+      return tu.run();
+    }
+    function_scope_finder fsf;
+    for(auto m : field_matchers) { fsf.add_matcher(m, &finder); }
+    finder.use_scope(fsf.scope());
+    fsf.register_with(tu);
+    return tu.run();
+  };
+  Tool.add_cache_salt("struct-field-use");
+  Tool.add_cache_salt(target_struct_string);
+  Tool.add_cache_salt(track_scope ? "scope" : "ancestor");
+  Tool.run(
+      [&](tu_context & tu) {
+        if(!Tool.keeps_tu_data()) { return run_tu(tu, s_finders[tu.worker]); }
+        // keep this TU's uses separate, so they can be cached
+        struct_field_user tu_finder(targ_fns, syms);
+        int const status = run_tu(tu, tu_finder);
+        tu_finder.write(tu.data());
+        s_finders[tu.worker].merge(tu_finder);
+        return status;
+      },
+      [&](tu_context & tu, std::istream & data) {
+        s_finders[tu.worker].read(data);
+      });
+  struct_field_user & s_finder(s_finders[0]);
+  for(uint32_t w = 1; w < s_finders.size(); ++w) {
+    s_finder.merge(s_finders[w]);
+  }
+  if(!partial_path().empty()) {
+    if(co_usage) {
+      std::cerr << "struct-field-use: -co-usage is not kept in -partial "
+                   "results\n";
+    }
+    auto write = [&s_finder](std::ostream & o) { s_finder.write(o); };
+    return write_partial("struct-field-use", write) ? 0 : 1;
+  }
+  if(!bin_file.empty()) {
+    std::ofstream o(bin_file, std::ios::binary);
+    write_field_uses(s_finder.lhs_uses(), s_finder.non_lhs_uses(), o);
+    if(!o) {
+      std::cerr << "struct-field-use: error writing " << bin_file << "\n";
+      return 1;
+    }
+    return 0;
+  }
   std::cout << "Fields written:\n";
-  print_fields(s_finder.lhs_uses_);
+  print_fields(s_finder.lhs_uses());
   std::cout << "Fields accessed, but not written:\n";
-  print_fields(s_finder.non_lhs_uses_);
+  print_fields(s_finder.non_lhs_uses());
+  if(co_usage) {
+    std::cout << "Functions using both fields:\n";
+    s_finder.write_co_usage(std::cout);
+  }
   return 0;
 }  // main
 
-template <typename MapOMapOSet>
-void
-print_fields(MapOMapOSet const & m)
-{
-  using corct::string_t;
-  corct::string_t tabs("");
-  for(auto map_it : m) {
-    string_t const s_name = (map_it.first);
-    for(auto mm_it : (map_it.second)) {
-      string_t const f_name = mm_it.first;
-      // tabs = corct::add_tab(tabs);
-      for(auto membr : mm_it.second) {
-        std::cout << tabs << f_name << " " << s_name << " " << membr << "\n";
-      }
-      // tabs = corct::remove_tab(tabs);
-    }
-  }
-  return;
-}  // print_fields
-
 // End of file
@@ -7,6 +7,7 @@
 
 #include "dump_things.h"
 #include "make_replacement.h"
+#include "tool_options.h"
 #include "types.h"
 #include "utilities.h"
 
@@ -64,10 +65,10 @@ struct TemplateType_Reporter
           argName = t.getAsString();
         }
         // Could do similar for integral args, etc...
-        std::cout << "For variable declared at "
-                  << corct::sourceRangeAsString(var_decl->getSourceRange(), &sm)
-                  << ":" << spec_decl->getNameAsString() << ": template arg "
-                  << (i + 1) << ": " << argName << std::endl;
+        o_ << "For variable declared at "
+           << corct::sourceRangeAsString(var_decl->getSourceRange(), &sm)
+           << ":" << spec_decl->getNameAsString() << ": template arg "
+           << (i + 1) << ": " << argName << std::endl;
       }
     }
     else {
@@ -76,7 +77,11 @@ struct TemplateType_Reporter
     }
     return;
   }  // run
-};   // struct Typedef_Reporter
+
+  explicit TemplateType_Reporter(std::ostream & o) : o_(o) {}
+
+  std::ostream & o_;
+};  // struct Typedef_Reporter
 
 static llvm::cl::OptionCategory TROpts("Common options for temp-type-report");
 
@@ -87,12 +92,14 @@ int
 main(int argc, const char ** argv)
 {
   using namespace corct;
+  add_tool_options(TROpts);
   CommonOptionsParser opt_prs(argc, argv, TROpts, addl_help);
-  RefactoringTool Tool(opt_prs.getCompilations(), opt_prs.getSourcePathList());
-  TemplateType_Reporter tr;
-  finder_t finder;
-  finder.addMatcher(tr.matcher(), &tr);
-  Tool.run(newFrontendActionFactory(&finder).get());
+  parallel_tool Tool(mk_parallel_tool(opt_prs));
+  Tool.run([&](tu_context & tu) {
+    TemplateType_Reporter tr(tu.out);
+    tu.add_matcher(tr.matcher(), &tr);
+    return tu.run();
+  });
   return 0;
 }  // main
 
@@ -11,6 +11,7 @@
  * std::vector<double>: this produces tuple<int,string,double> (order not
  * guaranteed). */
 #include "template_var_matchers.h"
+#include "tool_options.h"
 #include "types.h"
 #include "utilities.h"
 
@@ -20,7 +21,6 @@
 #include "clang/Tooling/Refactoring.h"
 #include "llvm/Support/CommandLine.h"
 #include <iostream>
-#include <set>
 #include <sstream>
 
 using namespace llvm;
@@ -47,112 +47,58 @@ static cl::opt<std::string> namespace_name(
     cl::cat(TVFOpts),
     cl::init(""));
 
-using type_set_t = std::set<corct::string_t>;
-using map_args_t = corct::template_var_reporter::map_args_t;
-using vec_strs_t = corct::template_var_reporter::vec_strs_t;
-
-// Functions that process the results
-/**\brief distill the results into a set*/
-type_set_t
-collate_types(map_args_t const & args);
-
-/** \brief Remove 'class ', 'struct ', '__1::', and ' ' */
-void
-fix_class(corct::string_t & s);
-
-/**\brief Remove substring from s. */
-void
-seek_and_remove(corct::string_t & s, corct::string_t const & substr);
-
-/**\brief process the set of types into result, in this case a tuple written
- * to a stringstream. */
-void
-process_type_set(type_set_t const & ts, std::ostream & s);
-
 int
 main(int argc, const char ** argv)
 {
   using namespace corct;
   using namespace clang::tooling;
   using tvr_t = template_var_reporter;
+  add_tool_options(TVFOpts);
   CommonOptionsParser opt_prs(argc, argv, TVFOpts, addl_help);
-  RefactoringTool tool(opt_prs.getCompilations(), opt_prs.getSourcePathList());
+  parallel_tool tool(mk_parallel_tool(opt_prs));
   // Alert the compiler instance to std lib header locations
   ArgumentsAdjuster ardj1 = getInsertArgumentAdjuster(clang_inc_dir1.c_str());
   ArgumentsAdjuster ardj2 = getInsertArgumentAdjuster(clang_inc_dir2.c_str());
-  tool.appendArgumentsAdjuster(ardj1);
-  tool.appendArgumentsAdjuster(ardj2);
+  tool.append_arguments_adjuster(ardj1);
+  tool.append_arguments_adjuster(ardj2);
   // examine command line arguments
   if(template_name.empty()) {
     printf("%s:%i Must specify a template to search for!\n", __FUNCTION__,
            __LINE__);
     return -1;
   }
-  // Configure the callback object, matchers, finder
-  tvr_t tr(template_name);
-  if(!namespace_name.empty()) { tr.namespace_name_ = namespace_name; }
-  finder_t finder;
-  tvr_t::matchers_t ms(tr.matchers());
-  for(auto & m : ms) { finder.addMatcher(m, &tr); }
+  // Configure the callback objects (one per worker) and matchers
+  std::vector<tvr_t> trs(tool.n_jobs(), tvr_t(template_name, namespace_name));
+  tvr_t::matchers_t ms(trs[0].matchers());
   // run the tool
-  tool.run(newFrontendActionFactory(&finder).get());
+  tool.run(
+      [&](tu_context & tu) {
+        if(!tool.keeps_tu_data()) {
+          for(auto & m : ms) { tu.add_matcher(m, &trs[tu.worker]); }
+          return tu.run();
+        }
+        // keep this TU's variables separate, so they can be journaled
+        tvr_t tu_tr(template_name, namespace_name);
+        for(auto & m : ms) { tu.add_matcher(m, &tu_tr); }
+        int const status = tu.run();
+        tu_tr.write(tu.data());
+        trs[tu.worker].merge(tu_tr);
+        return status;
+      },
+      [&](tu_context & tu, std::istream & data) {
+        trs[tu.worker].read(data);
+      });
   // process the results
-  type_set_t t(collate_types(tr.args_));
+  for(size_t w = 1; w < trs.size(); ++w) { trs[0].merge(trs[w]); }
+  if(!partial_path().empty()) {
+    auto write = [&trs](std::ostream & o) { trs[0].write(o); };
+    return write_partial("template-vars-report", write) ? 0 : 1;
+  }
+  type_set_t t(collate_types(trs[0].args_));
   std::stringstream s;
   process_type_set(t, s);
   std::cout << s.str();
   return 0;
 }  // main
 
-type_set_t
-collate_types(map_args_t const & args)
-{
-  std::set<corct::string_t> type_set;
-  for(auto p : args) {
-    vec_strs_t const & type_args(p.second);
-    for(auto & t : type_args) { type_set.insert(t); }
-  }
-  return type_set;
-}  // collate_types
-
-void
-fix_class(corct::string_t & s)
-{
-  corct::string_t struct_str("struct ");
-  corct::string_t class_str("class ");
-  corct::string_t ns_str("__1::");
-  seek_and_remove(s, struct_str);
-  seek_and_remove(s, class_str);
-  seek_and_remove(s, ns_str);
-  seek_and_remove(s, " ");
-  return;
-}  // fix_class
-
-void
-seek_and_remove(corct::string_t & s, corct::string_t const & substr)
-{
-  size_t n = s.find(substr);
-  if(n != std::string::npos) {
-    s.replace(n, substr.size(), "");
-    return fix_class(s);
-  }
-  return;
-}
-
-void
-process_type_set(type_set_t const & ts, std::ostream & s)
-{
-  s << "using types = std::tuple<\n";
-  size_t n_ts(ts.size());
-  size_t i(0);
-  for(auto & t1 : ts) {
-    std::string t(t1);
-    fix_class(t);
-    s << "\t" << t;
-    if(i++ < (n_ts - 1)) { s << ",\n"; }
-  }
-  s << ">;\n";
-  return;
-}  // process_type_set
-
 // End of file
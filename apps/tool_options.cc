@@ -0,0 +1,156 @@
+// tool_options.cc
+// Oct 17, 2026
+
+#include "tool_options.h"
+
+#include "shard.h"
+
+#include "llvm/Support/Path.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace corct {
+
+namespace {
+llvm::cl::opt<uint32_t> n_jobs(
+    "j",
+    llvm::cl::desc("number of translation units to process concurrently "
+                   "(0: one per core; default 1)"),
+    llvm::cl::value_desc("n-jobs"),
+    llvm::cl::init(1));
+
+llvm::cl::opt<std::string> pch_header(
+    "pch-header",
+    llvm::cl::desc("header included by every source: precompile it once, "
+                   "then load the PCH in each translation unit"),
+    llvm::cl::value_desc("header"));
+
+llvm::cl::opt<std::string> pch_file(
+    "pch",
+    llvm::cl::desc("where to write (or find) the precompiled header for "
+                   "-pch-header; default <header name>.pch in the current "
+                   "directory"),
+    llvm::cl::value_desc("pch-file"));
+
+llvm::cl::opt<std::string> cache_dir(
+    "cache",
+    llvm::cl::desc("keep per-translation-unit results in this directory, and "
+                   "reuse them for translation units that have not changed "
+                   "(tools that support it)"),
+    llvm::cl::value_desc("dir"));
+
+llvm::cl::opt<std::string> cost_file(
+    "costs",
+    llvm::cl::desc("with -j, start translation units in order of the run "
+                   "times recorded in this file, slowest first, and record "
+                   "this run's times in it (default: estimate from source "
+                   "size and #include count)"),
+    llvm::cl::value_desc("file"));
+
+llvm::cl::opt<std::string> journal_dir(
+    "journal",
+    llvm::cl::desc("record each completed translation unit, and its results, "
+                   "in this directory, so that an interrupted run can be "
+                   "resumed"),
+    llvm::cl::value_desc("dir"));
+
+llvm::cl::opt<bool> resume(
+    "resume",
+    llvm::cl::desc("skip the translation units that the -journal records as "
+                   "complete, and merge their results with the new ones"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<std::string> shard(
+    "shard",
+    llvm::cl::desc("process only shard i of N of the sources, 0 <= i < N; "
+                   "give every shard the same sources"),
+    llvm::cl::value_desc("i/N"));
+
+llvm::cl::opt<std::string> partial_file(
+    "partial",
+    llvm::cl::desc("write mergeable results to this file instead of the "
+                   "whole-program report, for merge-shards (tools that "
+                   "support it)"),
+    llvm::cl::value_desc("file"));
+
+llvm::cl::opt<bool> profile(
+    "profile",
+    llvm::cl::desc("time each matcher and translation unit, count matches, "
+                   "and write the tables to stderr at exit"),
+    llvm::cl::init(false));
+}  // namespace
+
+void
+add_tool_options(llvm::cl::OptionCategory & cat)
+{
+  n_jobs.addCategory(cat);
+  pch_header.addCategory(cat);
+  pch_file.addCategory(cat);
+  cache_dir.addCategory(cat);
+  cost_file.addCategory(cat);
+  journal_dir.addCategory(cat);
+  resume.addCategory(cat);
+  shard.addCategory(cat);
+  partial_file.addCategory(cat);
+  profile.addCategory(cat);
+  return;
+}
+
+parallel_tool
+mk_parallel_tool(clang::tooling::CommonOptionsParser & opt_prs)
+{
+  vec_str sources(expand_ast_dirs(opt_prs.getSourcePathList()));
+  std::vector<size_t> run_indices;  // of the shard's sources, in the run
+  if(!shard.empty()) {
+    uint32_t index(0), count(1);
+    string_t err;
+    if(!parse_shard(shard, index, count, err)) {
+      std::cerr << "-shard: " << err << "\n";
+      std::exit(1);
+    }
+    sources = shard_sources(sources, index, count, &run_indices);
+  }
+  parallel_tool tool(opt_prs.getCompilations(), sources, n_jobs);
+  // so shards sharing an -export-fixes directory don't reuse file names
+  tool.set_run_indices(run_indices);
+  if(!pch_header.empty()) {
+    string_t const pch_path =
+        pch_file.empty()
+            ? llvm::sys::path::filename(pch_header).str() + ".pch"
+            : string_t(pch_file);
+    tool.use_pch(pch_header, pch_path);
+  }
+  if(!cache_dir.empty()) { tool.use_cache(cache_dir); }
+  if(!cost_file.empty()) { tool.use_cost_file(cost_file); }
+  if(!journal_dir.empty()) { tool.use_journal(journal_dir, resume); }
+  else if(resume) {
+    std::cerr << "-resume needs -journal=dir; processing every source\n";
+  }
+  if(profile) { tool.enable_profiling(std::cerr); }
+  return tool;
+}
+
+string_t
+partial_path()
+{
+  return partial_file;
+}
+
+bool
+write_partial(str_t_cr kind, std::function<void(std::ostream &)> const & body)
+{
+  std::ofstream o(partial_file);
+  write_shard_header(o, kind);
+  body(o);
+  o.close();
+  if(!o) {
+    std::cerr << kind << ": error writing " << partial_file << "\n";
+    return false;
+  }
+  return true;
+}  // write_partial
+
+}  // namespace corct
+
+// End of file
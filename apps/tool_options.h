@@ -0,0 +1,45 @@
+// tool_options.h
+// Oct 17, 2026
+
+/* Command line options shared by all the CoARCT drivers. */
+
+#ifndef TOOL_OPTIONS_H
+#define TOOL_OPTIONS_H
+
+#include "parallel_tool.h"
+#include "types.h"
+
+#include "clang/Tooling/CommonOptionsParser.h"
+#include "llvm/Support/CommandLine.h"
+#include <functional>
+#include <iostream>
+
+namespace corct {
+
+/**\brief List the shared options (-j, ...) in an app's option category, so
+ * that they show up in its help. Call before constructing the
+ * CommonOptionsParser. */
+void
+add_tool_options(llvm::cl::OptionCategory & cat);
+
+/**\brief Create a parallel_tool for the parsed sources, configured from the
+ * shared options. */
+parallel_tool
+mk_parallel_tool(clang::tooling::CommonOptionsParser & opt_prs);
+
+/**\brief The -partial file, or "" if results should be reported as usual.
+ */
+string_t
+partial_path();
+
+/**\brief Write the -partial file: a shard header naming 'kind' (the tool),
+ * then whatever body writes. Reports errors on stderr.
+ * \return false if the file could not be written */
+bool
+write_partial(str_t_cr kind, std::function<void(std::ostream &)> const & body);
+
+}  // namespace corct
+
+#endif  // include guard
+
+// End of file
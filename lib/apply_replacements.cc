@@ -0,0 +1,50 @@
+// apply_replacements.cc
+// Oct 17, 2026
+
+#include "apply_replacements.h"
+
+#include "llvm/Support/Error.h"
+
+namespace corct {
+
+bool
+add_replacement(replacements_t & reps,
+                replacement_t const & r,
+                std::ostream & errs)
+{
+  bool ok(true);
+  llvm::Error rest = llvm::handleErrors(
+      reps.add(r), [&](clang::tooling::ReplacementError const & e) {
+        auto const & existing = e.getExistingReplacement();
+        if(existing && *existing == r) { return; }
+        errs << "dropping conflicting replacement: " << e.message() << "\n";
+        ok = false;
+      });
+  if(rest) {
+    errs << "dropping replacement " << r.toString() << ": "
+         << llvm::toString(std::move(rest)) << "\n";
+    ok = false;
+  }
+  return ok;
+}  // add_replacement
+
+uint32_t
+add_replacements(replacement_set & set,
+                 replacements_map_t const & reps,
+                 llvm::StringRef source,
+                 llvm::StringRef working_dir)
+{
+  uint32_t n_conflicts(0);
+  for(auto & p : reps) {
+    for(auto & r : p.second) {
+      auto const res = set.add(r.getFilePath(), r.getOffset(), r.getLength(),
+                               r.getReplacementText(), source, working_dir);
+      if(res == replacement_set::add_result::conflict) { n_conflicts++; }
+    }
+  }
+  return n_conflicts;
+}  // add_replacements
+
+}  // namespace corct
+
+// End of file
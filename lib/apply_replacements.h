@@ -0,0 +1,40 @@
+// apply_replacements.h
+// Oct 17, 2026
+
+/* Move the replacements that callbacks gather into a replacement_set, which
+ * keeps each edit once, reports conflicts, and writes the files. */
+
+#pragma once
+
+#include "replacement_set.h"
+#include "types.h"
+
+#include "clang/Tooling/Core/Replacement.h"
+#include "llvm/ADT/StringRef.h"
+#include <iostream>
+
+namespace corct {
+
+/**\brief Add r to reps, as a callback does for each edit it makes.
+ *
+ * An identical edit already in reps is not an error. One that conflicts is
+ * reported to errs, with the edit it conflicts with, and dropped.
+ * \return false if r conflicted */
+bool
+add_replacement(replacements_t & reps,
+                replacement_t const & r,
+                std::ostream & errs = std::cerr);
+
+/**\brief Add every edit in reps to set, noting source (e.g. the TU) as where
+ * it came from. Each edit goes to the file it names, taken from working_dir
+ * (the TU's, see tu_context::working_directory) if relative.
+ * \return number of edits that conflicted with one already in set */
+uint32_t
+add_replacements(replacement_set & set,
+                 replacements_map_t const & reps,
+                 llvm::StringRef source,
+                 llvm::StringRef working_dir = "");
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,151 @@
+// binary_layout.h
+// Oct 17, 2026
+
+/* Helpers shared by the memory-mappable binary files (field_use_file,
+ * call_graph_file): building sections in a byte buffer, checking them when a
+ * file is opened, and looking up names in a string dictionary.
+ *
+ * A dictionary is two sections: uint32_t offsets[n + 1], then the names, each
+ * followed by a NUL; name i is chars[offsets[i]..offsets[i+1] - 1). */
+
+#pragma once
+
+#include "types.h"
+
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+
+namespace corct {
+
+/**\brief Pad b with NULs to a multiple of 8 bytes. */
+inline void
+pad8(string_t & b)
+{
+  b.resize((b.size() + 7) & ~size_t(7), '\0');
+}
+
+/**\brief Append the bytes of v to b. */
+template <typename T>
+void
+append_pod(string_t & b, T const & v)
+{
+  b.append(reinterpret_cast<char const *>(&v), sizeof(T));
+}
+
+/**\brief Append an 8-byte aligned section holding [first, last) to b.
+ * \return file offset of the section */
+template <typename It>
+uint64_t
+append_section(string_t & b, It first, It const last)
+{
+  uint64_t const off = b.size();
+  for(; first != last; ++first) { append_pod(b, *first); }
+  pad8(b);
+  return off;
+}
+
+/**\brief Append a dictionary of names (any range of strings) to b, and
+ * record where its two sections start. */
+template <typename Names>
+void
+append_dict(string_t & b,
+            Names const & names,
+            uint64_t & offsets_pos,
+            uint64_t & chars_pos)
+{
+  offsets_pos = b.size();
+  uint32_t off(0);
+  for(auto & n : names) {
+    append_pod(b, off);
+    off += static_cast<uint32_t>(n.size() + 1);
+  }
+  append_pod(b, off);
+  pad8(b);
+  chars_pos = b.size();
+  for(auto & n : names) { b.append(n.c_str(), n.size() + 1); }
+  pad8(b);
+  return;
+}
+
+/**\brief Is [off, off + n * elem) inside a buffer of 'size' bytes? */
+inline bool
+in_bounds(uint64_t const off,
+          uint64_t const n,
+          uint64_t const elem,
+          uint64_t const size)
+{
+  return off <= size && n <= (size - off) / elem;
+}
+
+/**\brief Is an array of n T's at off inside the buffer, and aligned? */
+template <typename T>
+bool
+valid_array(uint64_t const off, uint64_t const n, uint64_t const size)
+{
+  return in_bounds(off, n, sizeof(T), size) && 0 == (off % alignof(T));
+}
+
+/**\brief Does a dictionary of n names fit in the buffer at base, with each
+ * name in order after the last and ending in a NUL? Then dict_name can't
+ * read outside the buffer. */
+inline bool
+valid_dict(char const * const base,
+           uint64_t const size,
+           uint64_t const n,
+           uint64_t const offsets_pos,
+           uint64_t const chars_pos)
+{
+  if(n >= UINT32_MAX || !valid_array<uint32_t>(offsets_pos, n + 1, size)) {
+    return false;
+  }
+  auto const offs = reinterpret_cast<uint32_t const *>(base + offsets_pos);
+  if(!in_bounds(chars_pos, offs[n], 1, size)) { return false; }
+  char const * const chars = base + chars_pos;
+  for(uint64_t i = 0; i < n; ++i) {
+    if(offs[i] >= offs[i + 1] || '\0' != chars[offs[i + 1] - 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**\brief Name id of a dictionary at base (see valid_dict). */
+inline llvm::StringRef
+dict_name(char const * const base,
+          uint64_t const offsets_pos,
+          uint64_t const chars_pos,
+          uint32_t const id)
+{
+  auto const offs = reinterpret_cast<uint32_t const *>(base + offsets_pos);
+  char const * const chars = base + chars_pos;
+  return llvm::StringRef(chars + offs[id], offs[id + 1] - offs[id] - 1);
+}
+
+/**\brief Binary search a sorted dictionary of n names for nm.
+ * \return true, with its id, if found */
+inline bool
+dict_find(char const * const base,
+          uint64_t const n,
+          uint64_t const offsets_pos,
+          uint64_t const chars_pos,
+          llvm::StringRef nm,
+          uint32_t & id)
+{
+  uint32_t lo(0), hi(static_cast<uint32_t>(n));
+  while(lo < hi) {
+    uint32_t const mid = lo + (hi - lo) / 2;
+    if(dict_name(base, offsets_pos, chars_pos, mid) < nm) { lo = mid + 1; }
+    else {
+      hi = mid;
+    }
+  }
+  if(lo < n && dict_name(base, offsets_pos, chars_pos, lo) == nm) {
+    id = lo;
+    return true;
+  }
+  return false;
+}  // dict_find
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,145 @@
+// call_graph_builder.cc
+// Oct 17, 2026
+
+#include "call_graph_builder.h"
+
+#include "callsite_common.h"
+#include "utilities.h"
+
+#include "clang/Index/USRGeneration.h"
+#include "llvm/ADT/SmallString.h"
+
+namespace corct {
+
+namespace {
+string_t const cs_bd_name = "callsite";
+string_t const mt_bd_name = "m_decl";
+string_t const fn_bd_name = "f_decl";
+string_t const caller_bd_name = "caller";
+}  // namespace
+
+string_t
+function_usr(clang::FunctionDecl const * f)
+{
+  llvm::SmallString<128> usr;
+  // generateUSRForDecl returns true if it could not make a USR
+  if(clang::index::generateUSRForDecl(f, usr)) {
+    return f->getQualifiedNameAsString();
+  }
+  return usr.str().str();
+}  // function_usr
+
+call_graph_builder::matcher_t
+call_graph_builder::matcher()
+{
+  using namespace clang::ast_matchers;
+  return functionDecl(
+             isDefinition(),
+             forEachDescendant(
+                 mk_callsite_matcher(cs_bd_name, mt_bd_name, fn_bd_name)))
+      .bind(caller_bd_name);
+}  // matcher
+
+void
+call_graph_builder::run(result_t const & result)
+{
+  using namespace clang;
+  FunctionDecl const * caller =
+      result.Nodes.getNodeAs<FunctionDecl>(caller_bd_name);
+  FunctionDecl const * callee =
+      result.Nodes.getNodeAs<CXXMethodDecl>(mt_bd_name);
+  if(!callee) { callee = result.Nodes.getNodeAs<FunctionDecl>(fn_bd_name); }
+  if(caller && callee) { edges_.emplace(node(caller), node(callee)); }
+  else {
+    check_ptr(caller, "caller");
+    check_ptr(callee, "callee");
+  }
+  return;
+}  // run
+
+sym_id_t
+call_graph_builder::node(clang::FunctionDecl const * f)
+{
+  sym_id_t const usr = cache_.get(f, [f] { return function_usr(f); });
+  if(names_.find(usr) == names_.end()) {
+    add_node(usr, syms().intern(f->getQualifiedNameAsString()));
+  }
+  return usr;
+}  // node
+
+void
+call_graph_builder::merge(call_graph_builder const & other)
+{
+  symbol_table & syms(this->syms());
+  symbol_table const & from_syms(other.syms());
+  bool const same_table = &syms == &from_syms;
+  auto xlate = [&](sym_id_t const id) {
+    return same_table ? id : syms.intern(from_syms.name(id));
+  };
+  for(auto & n : other.names_) { add_node(xlate(n.first), xlate(n.second)); }
+  for(auto & e : other.edges_) {
+    edges_.emplace(xlate(e.first), xlate(e.second));
+  }
+  return;
+}  // merge
+
+void
+call_graph_builder::write(std::ostream & o) const
+{
+  symbol_table const & syms(this->syms());
+  for(auto & n : names_) {
+    o << "node\t" << syms.name(n.first) << "\t" << syms.name(n.second) << "\n";
+  }
+  for(auto & e : edges_) {
+    o << "edge\t" << syms.name(e.first) << "\t" << syms.name(e.second)
+      << "\n";
+  }
+  return;
+}  // write
+
+bool
+call_graph_builder::read(std::istream & i)
+{
+  symbol_table & syms(this->syms());
+  string_t line;
+  while(std::getline(i, line)) {
+    vec_str const fs(split(line, '\t'));
+    if(fs.size() == 3 && fs[0] == "node") {
+      add_node(syms.intern(fs[1]), syms.intern(fs[2]));
+    }
+    else if(fs.size() == 3 && fs[0] == "edge") {
+      edges_.emplace(syms.intern(fs[1]), syms.intern(fs[2]));
+    }
+    else {
+      std::cerr << "call_graph_builder::read: malformed line '" << line
+                << "'\n";
+      return false;
+    }
+  }
+  return true;
+}  // read
+
+call_graph_data
+call_graph_builder::data() const
+{
+  symbol_table const & syms(this->syms());
+  call_graph_data g;
+  for(auto & n : names_) {
+    g.names[syms.name(n.first)] = syms.name(n.second);
+  }
+  for(auto & e : edges_) {
+    g.edges.emplace(syms.name(e.first), syms.name(e.second));
+  }
+  return g;
+}  // data
+
+call_graph_builder::call_graph_builder()
+    : own_syms_(new symbol_table), cache_(*own_syms_)
+{
+}
+
+call_graph_builder::call_graph_builder(symbol_table & syms) : cache_(syms) {}
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,94 @@
+// call_graph_builder.h
+// Oct 17, 2026
+
+/* Gather caller -> callee edges, keyed by USR, for a whole-program call graph
+ * (see call_graph_file). */
+
+#pragma once
+
+#include "call_graph_file.h"
+#include "symbol_table.h"
+#include "types.h"
+
+#include "clang/AST/Decl.h"
+#include "clang/ASTMatchers/ASTMatchers.h"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+
+namespace corct {
+
+/**\brief USR of a function, or its qualified name if no USR can be made. */
+string_t
+function_usr(clang::FunctionDecl const * f);
+
+/**\brief Record every call from every function definition, with caller and
+ * callee identified by USR, so that the same function is one node however
+ * many TUs declare it.
+ *
+ * USRs and display (qualified) names are interned in a symbol_table, which
+ * may be shared. Like struct_field_user, a builder is not thread-safe: give
+ * each worker its own, then merge(). Builders can also be written to a
+ * stream and read back, e.g. for a result cache.
+ */
+class call_graph_builder : public callback_t {
+public:
+  using matcher_t = clang::ast_matchers::DeclarationMatcher;
+  using edges_t = std::set<std::pair<sym_id_t, sym_id_t>>;  // caller, callee
+
+  /**\brief Matches each function definition once per call site in it (see
+   * callsite_lister). */
+  static matcher_t matcher();
+
+  llvm::StringRef getID() const override { return "call_graph_builder"; }
+
+  void run(result_t const & result) override;
+
+  /**\brief AST addresses are reused between TUs, so forget them. */
+  void onEndOfTranslationUnit() override { cache_.clear(); }
+
+  /**\brief Fold the edges recorded by another builder into this one. */
+  void merge(call_graph_builder const & other);
+
+  /**\brief Write nodes and edges, one per line:
+   *   'node' <tab> USR <tab> name
+   *   'edge' <tab> caller USR <tab> callee USR */
+  void write(std::ostream & o) const;
+
+  /**\brief Read what write() wrote, merging it into this builder.
+   * \return false if a malformed line was encountered */
+  bool read(std::istream & i);
+
+  /**\brief The graph, resolved to strings, for write_call_graph. */
+  call_graph_data data() const;
+
+  size_t n_edges() const { return edges_.size(); }
+
+  symbol_table & syms() const { return cache_.table(); }
+
+  /**\brief Construct with a private symbol table. */
+  call_graph_builder();
+
+  /**\brief Construct with a symbol table shared with other builders. */
+  explicit call_graph_builder(symbol_table & syms);
+
+private:
+  /**\brief Node for f: its USR's symbol. Records its name the first time. */
+  sym_id_t node(clang::FunctionDecl const * f);
+
+  void add_node(sym_id_t const usr, sym_id_t const name)
+  {
+    names_.emplace(usr, name);
+  }
+
+  std::map<sym_id_t, sym_id_t> names_;  // USR -> display name
+  edges_t edges_;
+  std::shared_ptr<symbol_table> own_syms_;
+  symbol_cache cache_;
+};  // call_graph_builder
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,239 @@
+// call_graph_file.cc
+// Oct 17, 2026
+
+#include "call_graph_file.h"
+
+#include "binary_layout.h"
+#include "llvm/ADT/StringMap.h"
+#include <algorithm>
+#include <cstring>
+
+namespace corct {
+
+namespace {
+char const cg_magic[8] = {'C', 'O', 'R', 'C', 'T', 'C', 'G', '\0'};
+uint32_t const cg_version = 1;
+uint32_t const cg_byte_order = 0x01020304;
+
+/* CSR arrays from (from, to) pairs sorted by from, then to. */
+void
+mk_csr(std::vector<std::pair<uint32_t, uint32_t>> const & edges,
+       uint32_t const n_nodes,
+       std::vector<uint32_t> & start,
+       std::vector<uint32_t> & adj)
+{
+  start.assign(n_nodes + 1, 0);
+  adj.clear();
+  adj.reserve(edges.size());
+  for(auto & e : edges) {
+    start[e.first + 1]++;
+    adj.push_back(e.second);
+  }
+  for(uint32_t n = 0; n < n_nodes; ++n) { start[n + 1] += start[n]; }
+  return;
+}
+}  // namespace
+
+void
+write_call_graph(call_graph_data const & g, std::ostream & o)
+{
+  // nodes: every USR, sorted
+  std::set<string_t> usrs;
+  for(auto & n : g.names) { usrs.insert(n.first); }
+  for(auto & e : g.edges) {
+    usrs.insert(e.first);
+    usrs.insert(e.second);
+  }
+  llvm::StringMap<uint32_t> ids;
+  vec_str names;
+  for(auto & u : usrs) {
+    ids[u] = static_cast<uint32_t>(names.size());
+    auto const n_it = g.names.find(u);
+    names.push_back(n_it == g.names.end() ? u : n_it->second);
+  }
+  uint32_t const n_nodes = static_cast<uint32_t>(usrs.size());
+  std::vector<std::pair<uint32_t, uint32_t>> out, in;
+  for(auto & e : g.edges) {
+    uint32_t const from = ids[e.first], to = ids[e.second];
+    out.emplace_back(from, to);
+    in.emplace_back(to, from);
+  }
+  std::sort(out.begin(), out.end());
+  std::sort(in.begin(), in.end());
+
+  call_graph_header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, cg_magic, sizeof(cg_magic));
+  h.version = cg_version;
+  h.byte_order = cg_byte_order;
+  h.n_nodes = n_nodes;
+  h.n_edges = out.size();
+  string_t b(sizeof(h), '\0');
+  pad8(b);
+  append_dict(b, usrs, h.usr_offsets, h.usr_chars);
+  append_dict(b, names, h.name_offsets, h.name_chars);
+  std::vector<uint32_t> start, adj;
+  mk_csr(out, n_nodes, start, adj);
+  h.out_start = append_section(b, start.begin(), start.end());
+  h.out_adj = append_section(b, adj.begin(), adj.end());
+  mk_csr(in, n_nodes, start, adj);
+  h.in_start = append_section(b, start.begin(), start.end());
+  h.in_adj = append_section(b, adj.begin(), adj.end());
+  std::memcpy(&b[0], &h, sizeof(h));
+  o.write(b.data(), b.size());
+  return;
+}  // write_call_graph
+
+bool
+call_graph_file::open(str_t_cr path, string_t & err)
+{
+  auto buf = llvm::MemoryBuffer::getFile(path, -1, false);
+  if(!buf) {
+    err = path + ": " + buf.getError().message();
+    return false;
+  }
+  if(!open(std::move(*buf), err)) {
+    err = path + ": " + err;
+    return false;
+  }
+  return true;
+}  // open
+
+bool
+call_graph_file::open(std::unique_ptr<llvm::MemoryBuffer> buf, string_t & err)
+{
+  h_ = nullptr;
+  buf_ = std::move(buf);
+  uint64_t const size = buf_->getBufferSize();
+  if(size < sizeof(call_graph_header)) {
+    err = "too short for a call graph file";
+    return false;
+  }
+  if(0 != (reinterpret_cast<uintptr_t>(base()) & 7)) {
+    err = "buffer is not 8-byte aligned";
+    return false;
+  }
+  auto const h = reinterpret_cast<call_graph_header const *>(base());
+  if(0 != std::memcmp(h->magic, cg_magic, sizeof(cg_magic))) {
+    err = "not a call graph file";
+    return false;
+  }
+  if(h->byte_order != cg_byte_order) {
+    err = "written with a different byte order";
+    return false;
+  }
+  if(h->version != cg_version) {
+    err = "unsupported version " + std::to_string(h->version);
+    return false;
+  }
+  uint64_t const n = h->n_nodes, m = h->n_edges;
+  if(!valid_dict(base(), size, n, h->usr_offsets, h->usr_chars) ||
+     !valid_dict(base(), size, n, h->name_offsets, h->name_chars)) {
+    err = "bad name dictionary";
+    return false;
+  }
+  uint64_t const starts[2] = {h->out_start, h->in_start};
+  uint64_t const adjs[2] = {h->out_adj, h->in_adj};
+  for(uint32_t d = 0; d < 2; ++d) {
+    if(m >= UINT32_MAX || !valid_array<uint32_t>(starts[d], n + 1, size) ||
+       !valid_array<uint32_t>(adjs[d], m, size)) {
+      err = "bad adjacency arrays";
+      return false;
+    }
+    // offsets must be monotone and end at m; targets must be nodes
+    auto const s = reinterpret_cast<uint32_t const *>(base() + starts[d]);
+    auto const a = reinterpret_cast<uint32_t const *>(base() + adjs[d]);
+    bool ok = s[0] == 0 && s[n] == m;
+    for(uint64_t i = 0; ok && i < n; ++i) { ok = s[i] <= s[i + 1]; }
+    for(uint64_t i = 0; ok && i < m; ++i) { ok = a[i] < n; }
+    if(!ok) {
+      err = "bad adjacency arrays";
+      return false;
+    }
+  }
+  h_ = h;
+  return true;
+}  // open
+
+llvm::StringRef
+call_graph_file::usr(node_t const n) const
+{
+  if(n >= n_nodes()) { return ""; }
+  return dict_name(base(), h_->usr_offsets, h_->usr_chars, n);
+}
+
+llvm::StringRef
+call_graph_file::name(node_t const n) const
+{
+  if(n >= n_nodes()) { return ""; }
+  return dict_name(base(), h_->name_offsets, h_->name_chars, n);
+}
+
+bool
+call_graph_file::find(llvm::StringRef u, node_t & n) const
+{
+  if(!h_) { return false; }
+  return dict_find(base(), h_->n_nodes, h_->usr_offsets, h_->usr_chars, u, n);
+}
+
+call_graph_file::nodes_t
+call_graph_file::find_name(llvm::StringRef nm) const
+{
+  nodes_t ns;
+  for(node_t n = 0; n < n_nodes(); ++n) {
+    if(name(n) == nm) { ns.push_back(n); }
+  }
+  return ns;
+}  // find_name
+
+call_graph_file::nodes_t
+call_graph_file::reach(nodes_t const & roots,
+                       bool const up,
+                       nodes_t const & stops) const
+{
+  std::vector<bool> seen(n_nodes(), false), stop(n_nodes(), false);
+  for(auto s : stops) {
+    if(s < n_nodes()) { stop[s] = true; }
+  }
+  nodes_t frontier(roots), found;
+  while(!frontier.empty()) {
+    nodes_t next;
+    for(auto f : frontier) {
+      if(f >= n_nodes() || stop[f]) { continue; }
+      range_t const r = up ? callers(f) : callees(f);
+      for(auto p = r.first; p != r.second; ++p) {
+        if(!seen[*p]) {
+          seen[*p] = true;
+          found.push_back(*p);
+          next.push_back(*p);
+        }
+      }
+    }
+    frontier.swap(next);
+  }
+  std::sort(found.begin(), found.end());
+  return found;
+}  // reach
+
+call_graph_file::nodes_t
+call_graph_file::transitive_callers(nodes_t const & roots) const
+{
+  return reach(roots, true);
+}
+
+call_graph_file::nodes_t
+call_graph_file::transitive_callers(nodes_t const & roots,
+                                    nodes_t const & stops) const
+{
+  return reach(roots, true, stops);
+}
+
+call_graph_file::nodes_t
+call_graph_file::transitive_callees(nodes_t const & roots) const
+{
+  return reach(roots, false);
+}
+
+}  // namespace corct
+
+// End of file
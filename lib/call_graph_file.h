@@ -0,0 +1,147 @@
+// call_graph_file.h
+// Oct 17, 2026
+
+/* Whole-program call graph on disk: functions keyed by USR, with caller ->
+ * callee edges in compressed sparse row (CSR) form in both directions, laid
+ * out so that the file can be memory-mapped and queried in place.
+ *
+ * Layout, in the writer's byte order (recorded in the header):
+ *
+ *   call_graph_header
+ *   USR dictionary (see binary_layout.h), sorted; node id = position
+ *   name dictionary: display name of each node, by node id
+ *   uint32_t out_start[n_nodes + 1]   callees of n: out_adj[out_start[n]..
+ *   uint32_t out_adj[n_edges]                               out_start[n+1])
+ *   uint32_t in_start[n_nodes + 1]    callers, likewise
+ *   uint32_t in_adj[n_edges]
+ *
+ * Every section starts on an 8-byte boundary, and each adjacency list is
+ * sorted, so the file depends only on the graph.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace corct {
+
+struct call_graph_header {
+  char magic[8];          //!< "CORCTCG" and a NUL
+  uint32_t version;       //!< 1
+  uint32_t byte_order;    //!< 0x01020304 as the writer stored it
+  uint64_t n_nodes;       //!< functions
+  uint64_t n_edges;       //!< distinct caller -> callee pairs
+  uint64_t usr_offsets;   //!< file offsets of the USR dictionary
+  uint64_t usr_chars;
+  uint64_t name_offsets;  //!< file offsets of the name dictionary
+  uint64_t name_chars;
+  uint64_t out_start;     //!< file offsets of the CSR arrays
+  uint64_t out_adj;
+  uint64_t in_start;
+  uint64_t in_adj;
+};  // call_graph_header
+
+/**\brief A call graph keyed by USR, before it is written. */
+struct call_graph_data {
+  std::map<string_t, string_t> names;  //!< USR -> display name
+  std::set<std::pair<string_t, string_t>> edges;  //!< (caller, callee) USRs
+};
+
+/**\brief Write g in the binary format. Functions that appear only in edges
+ * are named by their USR. */
+void
+write_call_graph(call_graph_data const & g, std::ostream & o);
+
+/**\brief Read-only, memory-mapped view of a call graph file, with
+ * reachability queries. */
+class call_graph_file {
+public:
+  using node_t = uint32_t;
+  using nodes_t = std::vector<node_t>;
+  using range_t = std::pair<node_t const *, node_t const *>;
+
+  /**\brief Map the file at path.
+   * \return false, with a message in err, if it is not a valid file */
+  bool open(str_t_cr path, string_t & err);
+
+  /**\brief Use a buffer that already holds a call graph file. */
+  bool open(std::unique_ptr<llvm::MemoryBuffer> buf, string_t & err);
+
+  uint32_t n_nodes() const
+  {
+    return h_ ? static_cast<uint32_t>(h_->n_nodes) : 0;
+  }
+
+  uint64_t n_edges() const { return h_ ? h_->n_edges : 0; }
+
+  llvm::StringRef usr(node_t const n) const;
+
+  llvm::StringRef name(node_t const n) const;
+
+  /**\brief Node with USR u (binary search).
+   * \return true if found */
+  bool find(llvm::StringRef u, node_t & n) const;
+
+  /**\brief Nodes whose display name is nm (a linear scan; overloads and
+   * functions in different scopes may share a name). */
+  nodes_t find_name(llvm::StringRef nm) const;
+
+  /**\brief Functions that n calls, in increasing order. */
+  range_t callees(node_t const n) const
+  {
+    return adj(n, h_->out_start, h_->out_adj);
+  }
+
+  /**\brief Functions that call n, in increasing order. */
+  range_t callers(node_t const n) const
+  {
+    return adj(n, h_->in_start, h_->in_adj);
+  }
+
+  /**\brief Every function that calls one of roots, directly or through other
+   * functions, in increasing order. A root is included only if a root
+   * reaches it, e.g. by recursion. */
+  nodes_t transitive_callers(nodes_t const & roots) const;
+
+  /**\brief As transitive_callers(roots), but the search does not go past
+   * the nodes in stops (e.g. entry points). Those are included if reached. */
+  nodes_t transitive_callers(nodes_t const & roots,
+                             nodes_t const & stops) const;
+
+  /**\brief Every function that one of roots calls, directly or indirectly. */
+  nodes_t transitive_callees(nodes_t const & roots) const;
+
+private:
+  range_t
+  adj(node_t const n, uint64_t const start_pos, uint64_t const adj_pos) const
+  {
+    auto const s = reinterpret_cast<uint32_t const *>(base() + start_pos);
+    auto const a = reinterpret_cast<node_t const *>(base() + adj_pos);
+    return {a + s[n], a + s[n + 1]};
+  }
+
+  /**\brief Breadth-first search from roots along callers() or callees(),
+   * not expanding the nodes in stops. */
+  nodes_t reach(nodes_t const & roots,
+                bool const up,
+                nodes_t const & stops = nodes_t()) const;
+
+  char const * base() const { return buf_->getBufferStart(); }
+
+  std::unique_ptr<llvm::MemoryBuffer> buf_;
+  call_graph_header const * h_ = nullptr;
+};  // call_graph_file
+
+}  // namespace corct
+
+// End of file
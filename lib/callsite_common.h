@@ -6,6 +6,8 @@
 #pragma once
 
 #include "clang/ASTMatchers/ASTMatchers.h"
+#include <string>
+#include <vector>
 
 namespace corct {
 
@@ -34,6 +36,32 @@ auto mk_fn_call_matcher(
   ).bind(cs_bind_name);
 } // mk_fn_call_matcher
 
+/** Match a call to any function named in targ_names: one matcher standing in
+ for a mk_fn_call_matcher per name. The callback must check which target it
+ got.
+*/
+inline
+auto mk_fn_call_matcher(
+  std::string const & cs_bind_name,
+  std::string const & fn_bind_name,
+  std::vector<std::string> const & targ_names)
+{
+  using namespace clang::ast_matchers;
+  std::vector<llvm::StringRef> const names(targ_names.begin(), targ_names.end());
+  return callExpr(
+    unless(isExpansionInSystemHeader()),
+    hasDescendant(
+      declRefExpr(
+        to(
+          functionDecl(
+            hasAnyName(names)
+          ).bind(fn_bind_name)
+        )
+      )
+    )
+  ).bind(cs_bind_name);
+} // mk_fn_call_matcher
+
 /** Match a callsite (bound to ) to any function (bound to "fn_bd_name"). Pretty
  sure this won't pick up a function pointer (TODO need to check that).
 */
@@ -76,6 +104,27 @@ auto mk_mthd_call_matcher(
   ).bind(cs_bind_name);
 } // mk_mthd_call_matcher
 
+/** Match a call to a bound member function named in targ_names: one matcher
+ * standing in for a mk_mthd_call_matcher per name.
+ */
+inline
+auto mk_mthd_call_matcher(
+  std::string const & cs_bind_name,
+  std::string const & fn_bind_name,
+  std::vector<std::string> const & targ_names)
+{
+  using namespace clang::ast_matchers;
+  std::vector<llvm::StringRef> const names(targ_names.begin(), targ_names.end());
+  return cxxMemberCallExpr(
+    unless(isExpansionInSystemHeader()),
+    callee(
+      cxxMethodDecl(
+        hasAnyName(names)
+      ).bind(fn_bind_name) // cxxMethodDecl
+    ) // callee
+  ).bind(cs_bind_name);
+} // mk_mthd_call_matcher
+
 /** Match callsite (bound to cs_bind_name) to any bound member function
  * (bound to fn_bind_name), with node bound to 'fn_bind_name'.
  * This will work with with object, reference, or pointer to object.
@@ -160,6 +209,37 @@ auto mk_callsite_matcher(
   ).bind(cs_bind_name); // callExpr
 } // mk_mthd_call_matcher
 
+/** Match a call expression to any function or method named in target_names:
+ * one matcher standing in for a mk_callsite_matcher per name. Binds as
+ * mk_callsite_matcher does.
+ */
+inline
+auto mk_callsite_matcher(
+  std::string const & cs_bind_name,
+  std::string const & mt_bind_name,
+  std::string const & fn_bind_name,
+  std::vector<std::string> const & target_names)
+{
+  using namespace clang::ast_matchers;
+  std::vector<llvm::StringRef> const names(target_names.begin(),
+                                           target_names.end());
+  return callExpr(
+    unless(isExpansionInSystemHeader()),
+    anyOf(
+      callee(
+        cxxMethodDecl(
+          hasAnyName(names)
+        ).bind(mt_bind_name) // cxxMethodDecl
+      ) // callee
+     ,callee(
+        functionDecl(
+          hasAnyName(names)
+        ).bind(fn_bind_name)
+     ) // callee
+    ) // anyOf
+  ).bind(cs_bind_name); // callExpr
+} // mk_callsite_matcher
+
 // clang-format on
 
 }  // namespace corct
@@ -5,6 +5,7 @@
 #ifndef CALLSITE_EXPANDER_H
 #define CALLSITE_EXPANDER_H
 
+#include "apply_replacements.h"
 #include "callsite_common.h"
 #include "function_repl_gen.h"
 #include "make_replacement.h"
@@ -52,6 +53,8 @@ public:
   static const string_t fn_bind_name_;
   static const string_t cs_bind_name_;
 
+  llvm::StringRef getID() const override { return "expand_callsite"; }
+
   virtual void run(result_t const & result) override
   {
     using namespace clang;
@@ -61,8 +64,10 @@ public:
         result.Nodes.getNodeAs<FunctionDecl>(fn_bind_name_));
     if(call_site && func_decl) {
       string_t callee_name = func_decl->getNameAsString();
-      if(corct::in_vec(fn_targets_, callee_name) ||
-         corct::in_vec(mthd_targets_, callee_name)) {
+      // targets may also be qualified names, e.g. from threading_targets
+      if(fn_targets_.contains(callee_name) ||
+         mthd_targets_.contains(callee_name) ||
+         fn_targets_.contains(func_decl->getQualifiedNameAsString())) {
         if(verbose_) {
           std::cout << "callsite_expander arrived at target function: "
                     << callee_name << ":\n";
@@ -75,8 +80,9 @@ public:
           std::cout << "Suggested replacement: " << rep.toString() << "\n";
         }
         if(!dry_run_) {
-          auto & reps = find_repls(func_decl, src_manager, rep_map_);
-          if(reps.add(rep)) { HERE("add replacement failed"); }
+          // the edit is at the call site, which may be in another file
+          auto & reps = find_repls(call_site, src_manager, rep_map_);
+          add_replacement(reps, rep);
         }
       }  // if callee_name in targets
     }
@@ -97,6 +103,16 @@ public:
     return mk_mthd_call_matcher(cs_bind_name_, fn_bind_name_, t);
   }
 
+  matcher_t mk_fn_matcher(vec_str const & ts) const override
+  {
+    return mk_fn_call_matcher(cs_bind_name_, fn_bind_name_, ts);
+  }
+
+  matcher_t mk_mthd_matcher(vec_str const & ts) const override
+  {
+    return mk_mthd_call_matcher(cs_bind_name_, fn_bind_name_, ts);
+  }
+
   expand_callsite(replacements_map_t & reps,
                   vec_str const & targets,
                   str_t_cr new_arg,
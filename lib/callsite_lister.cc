@@ -4,6 +4,8 @@
 
 #include "callsite_lister.h"
 
+#include <cstdlib>
+
 namespace corct {
 
 const string_t callsite_lister::cs_bd_name = "callsite";
@@ -38,6 +40,118 @@ print_call_details(clang::FunctionDecl const * callee,
   return;
 }  // print_short_function_decl_details
 
+void
+write_call_record(clang::FunctionDecl const * callee,
+                  clang::FunctionDecl const * caller,
+                  clang::CallExpr const * callsite,
+                  clang::SourceManager & sm,
+                  std::ostream & o)
+{
+  jsonl_record rec(o);
+  rec.str("kind", "call")
+      .location(callsite->getBeginLoc(), sm)
+      .str("function", caller->getNameAsString())
+      .str("symbol", callee->getNameAsString())
+      .boolean("template_instantiation", callee->isTemplateInstantiation())
+      .end();
+  return;
+}  // write_call_record
+
+callsite_lister::named_edge_counts_t
+callsite_lister::named_edge_counts() const
+{
+  symbol_table const & syms(m_cache.table());
+  named_edge_counts_t named;
+  for(auto & c_it : m_edge_counts) {
+    auto & callees(named[syms.name(c_it.first)]);
+    for(auto & e_it : c_it.second) {
+      callees[syms.name(e_it.first)] += e_it.second;
+    }
+  }
+  return named;
+}  // named_edge_counts
+
+void
+callsite_lister::write_edges(std::ostream & o) const
+{
+  for(auto & c_it : named_edge_counts()) {
+    for(auto & e_it : c_it.second) {
+      if(output_format::jsonl == m_format) {
+        jsonl_record rec(o);
+        rec.str("kind", "edge")
+            .str("function", c_it.first)
+            .str("symbol", e_it.first)
+            .num("count", e_it.second)
+            .end();
+      }
+      else {
+        o << c_it.first << "\t" << e_it.first << "\t" << e_it.second << "\n";
+      }
+    }
+  }
+  return;
+}  // write_edges
+
+void
+callsite_lister::merge(callsite_lister const & other)
+{
+  symbol_table & syms(m_cache.table());
+  symbol_table const & from_syms(other.m_cache.table());
+  bool const same_table = &syms == &from_syms;
+  auto xlate = [&](sym_id_t const id) {
+    return same_table ? id : syms.intern(from_syms.name(id));
+  };
+  for(auto & c_it : other.m_edge_counts) {
+    sym_id_t const caller = xlate(c_it.first);
+    for(auto & e_it : c_it.second) {
+      sym_id_t const callee = xlate(e_it.first);
+      m_calls[caller].insert(callee);
+      m_edge_counts[caller][callee] += e_it.second;
+    }
+  }
+  m_num_calls += other.m_num_calls;
+  return;
+}  // merge
+
+void
+callsite_lister::write(std::ostream & o) const
+{
+  o << "n_calls\t" << m_num_calls << "\n";
+  for(auto & c_it : named_edge_counts()) {
+    for(auto & e_it : c_it.second) {
+      o << "edge\t" << c_it.first << "\t" << e_it.first << "\t"
+        << e_it.second << "\n";
+    }
+  }
+  return;
+}  // write
+
+bool
+callsite_lister::read(std::istream & i)
+{
+  symbol_table & syms(m_cache.table());
+  string_t line;
+  while(std::getline(i, line)) {
+    vec_str const fs(split(line, '\t'));
+    if(fs.size() == 2 && fs[0] == "n_calls") {
+      m_num_calls += std::strtoul(fs[1].c_str(), nullptr, 10);
+    }
+    else if(fs.size() == 4 && fs[0] == "edge") {
+      sym_id_t const caller = syms.intern(fs[1]);
+      sym_id_t const callee = syms.intern(fs[2]);
+      m_calls[caller].insert(callee);
+      m_edge_counts[caller][callee] +=
+          std::strtoul(fs[3].c_str(), nullptr, 10);
+    }
+    else {
+      std::cerr << "callsite_lister::read: malformed line '" << line
+                << "'\n";
+      return false;
+    }
+  }
+  return true;
+}  // read
+
 }  // namespace corct
 
 // End of file
@@ -5,8 +5,13 @@
 
 #include "callsite_common.h"
 #include "dump_things.h"
+#include "jsonl_writer.h"
+#include "symbol_table.h"
 #include "types.h"
 #include "utilities.h"
+#include <map>
+#include <memory>
+#include <set>
 
 namespace corct {
 
@@ -18,6 +23,16 @@ print_call_details(clang::FunctionDecl const * callee,
                    clang::SourceManager & sm,
                    std::ostream & o);
 
+/**\brief print_call_details as one JSON Lines record: kind ("call"), file,
+ * line, and col of the call site, function (the caller), symbol (the callee),
+ * and template_instantiation. */
+void
+write_call_record(clang::FunctionDecl const * callee,
+                  clang::FunctionDecl const * caller,
+                  clang::CallExpr const * callsite,
+                  clang::SourceManager & sm,
+                  std::ostream & o);
+
 /**\class callsite_lister. This will identify all functions in which a callsite
  * is present.
  *
@@ -25,12 +40,26 @@ print_call_details(clang::FunctionDecl const * callee,
  * methods by naming them in the ctor's 'targets' parameter. If 'targets' is
  * empty, all functions with callsites will be listed.
  *
- * When a function is found that calls one of the targets, its name and source
- * range will be printed.
+ * Each call site of a target is printed to the stream given to the ctor,
+ * with the names and source ranges of caller and callee. Each caller -> callee
+ * pair is also recorded in m_calls, and the number of call sites for the pair
+ * in m_edge_counts, as ids in a (possibly shared) symbol_table.
+ *
+ * There is one matcher however many targets there are. It visits each function
+ * body once and reports every call site in it (forEachDescendant), not just
+ * the first. Calls in a lambda count as calls from the function around it;
+ * calls in a method of a local class count for both the method and the
+ * function around it.
  */
 struct callsite_lister : public callback_t {
   using matcher_t = clang::ast_matchers::DeclarationMatcher;
   using matchers_t = std::vector<matcher_t>;
+  using calls_t = std::map<sym_id_t, std::set<sym_id_t>>;  // caller->callees
+  using named_calls_t = std::map<string_t, std::set<string_t>>;
+  // caller -> callee -> number of call sites
+  using edge_counts_t = std::map<sym_id_t, std::map<sym_id_t, uint32_t>>;
+  using named_edge_counts_t =
+      std::map<string_t, std::map<string_t, uint32_t>>;
 
   matchers_t matchers()
   {
@@ -38,20 +67,20 @@ struct callsite_lister : public callback_t {
     matchers_t ms;
     if(m_targets.empty()) {
       auto callsite_m(mk_callsite_matcher(cs_bd_name, mt_bd_name, fn_bd_name));
-      auto m = functionDecl(hasDescendant(callsite_m)).bind(caller_bd_name);
-      ms.push_back(m);
+      ms.push_back(
+          functionDecl(forEachDescendant(callsite_m)).bind(caller_bd_name));
     }
     else {
-      for(auto & t : m_targets) {
-        auto callsite_m(
-            mk_callsite_matcher(cs_bd_name, mt_bd_name, fn_bd_name, t));
-        auto m = functionDecl(hasDescendant(callsite_m)).bind(caller_bd_name);
-        ms.push_back(m);
-      }
+      auto callsite_m(mk_callsite_matcher(cs_bd_name, mt_bd_name, fn_bd_name,
+                                          m_targets));
+      ms.push_back(
+          functionDecl(forEachDescendant(callsite_m)).bind(caller_bd_name));
     }
     return ms;
   }  // matchers
 
+  llvm::StringRef getID() const override { return "callsite_lister"; }
+
   void run(result_t const & result) override
   {
     using namespace clang;
@@ -63,12 +92,16 @@ struct callsite_lister : public callback_t {
         result.Nodes.getNodeAs<CXXMethodDecl>(mt_bd_name);
     CallExpr const * csite = result.Nodes.getNodeAs<CallExpr>(cs_bd_name);
     SourceManager & sm(result.Context->getSourceManager());
+    auto const print = output_format::jsonl == m_format ? write_call_record
+                                                        : print_call_details;
     if(csite && fdecl && caller) {
-      print_call_details(fdecl, caller, csite, sm, std::cout);
+      if(m_print_calls) { print(fdecl, caller, csite, sm, m_out); }
+      record_call(caller, fdecl);
       m_num_calls++;
     }
     else if(csite && mdecl && caller) {
-      print_call_details(mdecl, caller, csite, sm, std::cout);
+      if(m_print_calls) { print(mdecl, caller, csite, sm, m_out); }
+      record_call(caller, mdecl);
       m_num_calls++;
     }
     else {
@@ -80,12 +113,91 @@ struct callsite_lister : public callback_t {
     return;
   }  // run
 
-  explicit callsite_lister(vec_str const & targets) : m_targets(targets) {}
+  /**\brief AST addresses are reused between TUs, so forget them. */
+  void onEndOfTranslationUnit() override { m_cache.clear(); }
+
+  /**\brief Write text (the default), or JSON Lines (see write_call_record).
+   */
+  void set_format(output_format const f) { m_format = f; }
+
+  /**\brief Print each call site as it is found (the default), or only
+   * record it; see write_edges. */
+  void set_print_calls(bool const p) { m_print_calls = p; }
+
+  /**\brief Write m_edge_counts, callers and callees in name order. As text,
+   * one line per edge: caller <tab> callee <tab> call sites. As JSON Lines,
+   * records with kind ("edge"), function (the caller), symbol (the callee),
+   * and count. */
+  void write_edges(std::ostream & o) const;
+
+  /**\brief m_edge_counts, resolved to names. */
+  named_edge_counts_t named_edge_counts() const;
+
+  /**\brief Fold the calls recorded by another lister into this one. */
+  void merge(callsite_lister const & other);
+
+  /**\brief Write the call count and edges, in name order, one per line:
+   *   'n_calls' <tab> n
+   *   'edge' <tab> caller <tab> callee <tab> call sites */
+  void write(std::ostream & o) const;
+
+  /**\brief Read what write() wrote, merging it into this lister.
+   * \return false if a malformed line was encountered */
+  bool read(std::istream & i);
+
+  /**\brief m_calls, resolved to names. */
+  named_calls_t named_calls() const
+  {
+    symbol_table const & syms(m_cache.table());
+    named_calls_t n;
+    for(auto & c_it : m_calls) {
+      std::set<string_t> & callees(n[syms.name(c_it.first)]);
+      for(auto c : c_it.second) { callees.insert(syms.name(c)); }
+    }
+    return n;
+  }
+
+  /**\brief Construct with a private symbol table. */
+  explicit callsite_lister(vec_str const & targets,
+                           std::ostream & o = std::cout)
+      : m_targets(targets),
+        m_out(o),
+        m_own_syms(new symbol_table),
+        m_cache(*m_own_syms)
+  {
+  }
+
+  /**\brief Construct with a symbol table shared with other listers. */
+  callsite_lister(vec_str const & targets,
+                  std::ostream & o,
+                  symbol_table & syms)
+      : m_targets(targets), m_out(o), m_cache(syms)
+  {
+  }
 
   uint32_t m_num_calls = 0;
+  calls_t m_calls;
+  edge_counts_t m_edge_counts;
 
 private:
+  void record_call(clang::FunctionDecl const * caller,
+                   clang::FunctionDecl const * callee)
+  {
+    sym_id_t const caller_id =
+        m_cache.get(caller, [caller] { return caller->getNameAsString(); });
+    sym_id_t const callee_id =
+        m_cache.get(callee, [callee] { return callee->getNameAsString(); });
+    m_calls[caller_id].insert(callee_id);
+    m_edge_counts[caller_id][callee_id]++;
+    return;
+  }
+
   vec_str m_targets;
+  std::ostream & m_out;
+  std::shared_ptr<symbol_table> m_own_syms;
+  symbol_cache m_cache;
+  output_format m_format = output_format::text;
+  bool m_print_calls = true;
   static string_t const cs_bd_name;
   static string_t const mt_bd_name;
   static string_t const fn_bd_name;
@@ -116,6 +228,8 @@ struct callsite_counter : public callback_t {
     return ms;
   }  // matchers
 
+  llvm::StringRef getID() const override { return "callsite_counter"; }
+
   void run(result_t const & result) override
   {
     using namespace clang;
@@ -10,9 +10,11 @@
 
 namespace corct {
 namespace {
-/* These maintain state across calls to dump */
-string_t last_fname = "";
-uint32_t last_lineno = 0xFFFFFFF;
+/* These maintain state across calls to dump. They are per thread, so that
+ * concurrent workers (see parallel_tool.h) don't elide each other's file
+ * names and line numbers. */
+thread_local string_t last_fname = "";
+thread_local uint32_t last_lineno = 0xFFFFFFF;
 }  // namespace
 
 void
@@ -0,0 +1,467 @@
+// field_cluster.cc
+// Oct 17, 2026
+
+#include "field_cluster.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <tuple>
+
+namespace corct {
+
+namespace {
+/* Call work(w) for w in [0, n_jobs), each on its own thread. */
+template <typename Work_Fn>
+void
+run_workers(uint32_t const n_jobs, Work_Fn && work)
+{
+  if(n_jobs <= 1) {
+    work(0u);
+    return;
+  }
+  std::vector<std::thread> workers;
+  for(uint32_t w = 0; w < n_jobs; ++w) { workers.emplace_back(work, w); }
+  for(auto & t : workers) { t.join(); }
+  return;
+}
+
+/* A candidate swap in diagonalizer::search. Kind 0 swaps the fields at
+ * positions i and j; kind 1 swaps the functions numbered i and i+1. Ordered
+ * by delta, then position, so the chosen move doesn't depend on how the
+ * candidates were split between threads. */
+struct move_t {
+  int64_t delta = std::numeric_limits<int64_t>::max();
+  uint32_t kind = 0;
+  uint32_t i = 0;
+  uint32_t j = 0;
+
+  bool operator<(move_t const & o) const
+  {
+    return std::tie(delta, kind, i, j) < std::tie(o.delta, o.kind, o.i, o.j);
+  }
+};  // move_t
+
+/* Cluster.hs's score as running sums. With k_f the number of cluster fields
+ * that function f uses, each function adds k_f(k_f-1)/2 for the pairs it
+ * uses both of, and subtracts k_f(|c|-k_f) for the pairs it uses one of, so
+ *   score = |c| + (3 S2 - S1)/2 - |c| S1,  S1 = sum k_f, S2 = sum k_f^2. */
+struct cluster_sums {
+  int64_t score() const { return score(size, s1, s2); }
+
+  /* Score if field were added. */
+  int64_t score_with(use_matrix const & m,
+                     use_matrix::index_t const field) const
+  {
+    int64_t t1(s1), t2(s2);
+    auto const fs = m.funcs_of(field);
+    for(auto f = fs.first; f != fs.second; ++f) {
+      t1 += 1;
+      t2 += 2 * k[*f] + 1;
+    }
+    return score(size + 1, t1, t2);
+  }
+
+  void add(use_matrix const & m, use_matrix::index_t const field)
+  {
+    auto const fs = m.funcs_of(field);
+    for(auto f = fs.first; f != fs.second; ++f) {
+      s1 += 1;
+      s2 += 2 * k[*f] + 1;
+      k[*f]++;
+    }
+    size++;
+    return;
+  }
+
+  explicit cluster_sums(use_matrix const & m) : k(m.n_funcs(), 0) {}
+
+  static int64_t score(int64_t const n, int64_t const t1, int64_t const t2)
+  {
+    return n + (3 * t2 - t1) / 2 - n * t1;
+  }
+
+  std::vector<int64_t> k;
+  int64_t s1 = 0;
+  int64_t s2 = 0;
+  int64_t size = 0;
+};  // cluster_sums
+}  // namespace
+
+// use_matrix
+
+use_matrix::use_matrix(func_fields_t const & uses)
+{
+  std::set<string_t> fields;
+  for(auto & f_it : uses) {
+    func_names_.push_back(f_it.first);
+    fields.insert(f_it.second.begin(), f_it.second.end());
+  }
+  field_names_.assign(fields.begin(), fields.end());
+  std::vector<std::pair<index_t, index_t>> pairs;
+  index_t func(0);
+  for(auto & f_it : uses) {
+    for(auto & fld : f_it.second) {
+      auto const it =
+          std::lower_bound(field_names_.begin(), field_names_.end(), fld);
+      pairs.emplace_back(func, static_cast<index_t>(it - field_names_.begin()));
+    }
+    func++;
+  }
+  build(pairs);
+}
+
+use_matrix::use_matrix(field_use_file const & f, uint32_t const s_id)
+{
+  // file ids are in name order, so renumbering by file id keeps that order
+  std::vector<index_t> funcs, fields;
+  for(uint64_t i = 0; i < f.n_uses(); ++i) {
+    if(f.struct_ids()[i] != s_id) { continue; }
+    funcs.push_back(f.func_ids()[i]);
+    fields.push_back(f.field_ids()[i]);
+  }
+  auto dedup = [](std::vector<index_t> v) {
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+    return v;
+  };
+  std::vector<index_t> const u_funcs(dedup(funcs)), u_fields(dedup(fields));
+  for(auto id : u_funcs) {
+    func_names_.push_back(f.name(fu_dict::funcs, id).str());
+  }
+  for(auto id : u_fields) {
+    field_names_.push_back(f.name(fu_dict::fields, id).str());
+  }
+  auto local = [](std::vector<index_t> const & u, index_t const id) {
+    return static_cast<index_t>(std::lower_bound(u.begin(), u.end(), id) -
+                                u.begin());
+  };
+  std::vector<std::pair<index_t, index_t>> pairs;
+  for(size_t i = 0; i < funcs.size(); ++i) {
+    pairs.emplace_back(local(u_funcs, funcs[i]), local(u_fields, fields[i]));
+  }
+  build(pairs);
+}
+
+void
+use_matrix::build(std::vector<std::pair<index_t, index_t>> & uses)
+{
+  std::sort(uses.begin(), uses.end());
+  uses.erase(std::unique(uses.begin(), uses.end()), uses.end());
+  index_t const nfn(n_funcs()), nfl(n_fields());
+  fnc_start_.assign(nfn + 1, 0);
+  fld_start_.assign(nfl + 1, 0);
+  for(auto & u : uses) {
+    fnc_start_[u.first + 1]++;
+    fld_start_[u.second + 1]++;
+  }
+  std::partial_sum(fnc_start_.begin(), fnc_start_.end(), fnc_start_.begin());
+  std::partial_sum(fld_start_.begin(), fld_start_.end(), fld_start_.begin());
+  fnc_fields_.resize(uses.size());
+  fld_funcs_.resize(uses.size());
+  words_ = (nfl + 63) / 64;
+  bits_.assign(size_t(nfn) * words_, 0);
+  std::vector<index_t> fill(fld_start_.begin(), fld_start_.end() - 1);
+  // uses are sorted by function, so both sets of rows come out sorted
+  for(size_t i = 0; i < uses.size(); ++i) {
+    index_t const fn(uses[i].first), fl(uses[i].second);
+    fnc_fields_[i] = fl;
+    fld_funcs_[fill[fl]++] = fn;
+    bits_[size_t(fn) * words_ + fl / 64] |= 1ull << (fl % 64);
+  }
+  // keep range pointers valid for an empty matrix
+  if(uses.empty()) {
+    fnc_fields_.resize(1);
+    fld_funcs_.resize(1);
+  }
+  return;
+}  // build
+
+// diagonalizer
+
+diagonalizer::diagonalizer(use_matrix const & m)
+    : m_(m),
+      nf_(m.n_fields()),
+      at_(nf_),
+      pos_(nf_),
+      func_at_(m.n_funcs()),
+      num_(m.n_funcs()),
+      nstart_(nf_ + 1, 0),
+      top_(nf_, 0),
+      c_(size_t(nf_) * nf_, 0)
+{
+  std::iota(at_.begin(), at_.end(), 0);
+  std::iota(pos_.begin(), pos_.end(), 0);
+  std::iota(func_at_.begin(), func_at_.end(), 0);
+  std::iota(num_.begin(), num_.end(), 0);
+  for(index_t a = 0; a < nf_; ++a) {
+    auto const fs = m_.funcs_of(a);
+    // functions are numbered by index, so these are already sorted
+    nums_.insert(nums_.end(), fs.first, fs.second);
+    nstart_[a + 1] = static_cast<index_t>(nums_.size());
+    if(fs.first != fs.second) { top_[a] = *(fs.second - 1); }
+  }
+  for(index_t a = 0; a < nf_; ++a) { fill_row(a); }
+  score_ = full_score();
+}
+
+diagonalizer::index_t
+diagonalizer::n_above(index_t const b, index_t const threshold) const
+{
+  auto const first = nums_.begin() + nstart_[b];
+  auto const last = nums_.begin() + nstart_[b + 1];
+  return static_cast<index_t>(last - std::upper_bound(first, last, threshold));
+}
+
+void
+diagonalizer::fill_row(index_t const a)
+{
+  for(index_t b = 0; b < nf_; ++b) {
+    c_[size_t(a) * nf_ + b] = static_cast<int32_t>(n_above(b, top_[a]));
+  }
+  return;
+}
+
+diagonalizer::score_t
+diagonalizer::full_score() const
+{
+  // from the matrix and the numbering alone, ignoring nums_, top_, and c_
+  std::vector<std::vector<index_t>> nums(nf_);
+  for(index_t a = 0; a < nf_; ++a) {
+    auto const fs = m_.funcs_of(a);
+    for(auto f = fs.first; f != fs.second; ++f) { nums[a].push_back(num_[*f]); }
+    std::sort(nums[a].begin(), nums[a].end());
+  }
+  score_t s(0);
+  for(index_t pa = 1; pa < nf_; ++pa) {
+    auto const & na(nums[at_[pa]]);
+    index_t const top = na.empty() ? 0 : na.back();
+    for(index_t pb = 0; pb < pa; ++pb) {
+      auto const & nb(nums[at_[pb]]);
+      s += nb.end() - std::upper_bound(nb.begin(), nb.end(), top);
+    }
+  }
+  return s;
+}  // full_score
+
+diagonalizer::score_t
+diagonalizer::swap_fields_delta(index_t p, index_t q) const
+{
+  if(p == q) { return 0; }
+  if(q < p) { std::swap(p, q); }
+  index_t const a(at_[p]), b(at_[q]);
+  // the pair (a, b) changes order, and so does each of them with every field
+  // in between; nothing else changes
+  score_t delta = d(a, b);
+  for(index_t k = p + 1; k < q; ++k) { delta += d(a, at_[k]) - d(b, at_[k]); }
+  return delta;
+}  // swap_fields_delta
+
+void
+diagonalizer::swap_fields(index_t const p, index_t const q)
+{
+  score_ += swap_fields_delta(p, q);
+  std::swap(at_[p], at_[q]);
+  pos_[at_[p]] = p;
+  pos_[at_[q]] = q;
+  return;
+}
+
+std::vector<std::pair<diagonalizer::index_t, diagonalizer::index_t>>
+diagonalizer::top_changes(index_t const n) const
+{
+  index_t const g(func_at_[n]), h(func_at_[n + 1]);
+  std::vector<std::pair<index_t, index_t>> changes;
+  auto const gs = m_.fields_of(g);
+  for(auto a = gs.first; a != gs.second; ++a) {
+    if(!m_.uses(h, *a) && top_[*a] == n) { changes.emplace_back(*a, n + 1); }
+  }
+  auto const hs = m_.fields_of(h);
+  for(auto a = hs.first; a != hs.second; ++a) {
+    if(!m_.uses(g, *a) && top_[*a] == n + 1) { changes.emplace_back(*a, n); }
+  }
+  return changes;
+}  // top_changes
+
+diagonalizer::score_t
+diagonalizer::swap_funcs_delta(index_t const n) const
+{
+  if(n + 1 >= func_at_.size()) { return 0; }
+  /* Only numbers n and n+1 move, so comparisons against a field's top number
+   * change only if that top is n, and the tops that change are exactly those
+   * of fields whose top user is one of the two (but not both). So only the
+   * rows of c for those fields change. */
+  index_t const g(func_at_[n]), h(func_at_[n + 1]);
+  score_t delta(0);
+  for(auto & ch : top_changes(n)) {
+    index_t const a(ch.first), t(ch.second);
+    int32_t const above_n(n > t), above_n1(n + 1 > t);
+    for(index_t b = 0; b < nf_; ++b) {
+      if(pos_[b] >= pos_[a]) { continue; }
+      int32_t c_new = static_cast<int32_t>(n_above(b, t));
+      if(m_.uses(g, b)) { c_new += above_n1 - above_n; }
+      if(m_.uses(h, b)) { c_new += above_n - above_n1; }
+      delta += c_new - c(a, b);
+    }
+  }
+  return delta;
+}  // swap_funcs_delta
+
+void
+diagonalizer::swap_funcs(index_t const n)
+{
+  if(n + 1 >= func_at_.size()) { return; }
+  score_t const delta = swap_funcs_delta(n);
+  auto const changes = top_changes(n);
+  index_t const g(func_at_[n]), h(func_at_[n + 1]);
+  std::swap(func_at_[n], func_at_[n + 1]);
+  num_[g] = n + 1;
+  num_[h] = n;
+  // a field that uses just one of them sees n become n+1 or vice versa,
+  // which keeps its list sorted
+  auto renumber = [this](index_t const a, index_t const from, index_t to) {
+    auto first = nums_.begin() + nstart_[a];
+    auto last = nums_.begin() + nstart_[a + 1];
+    *std::lower_bound(first, last, from) = to;
+  };
+  auto const gs = m_.fields_of(g);
+  for(auto a = gs.first; a != gs.second; ++a) {
+    if(!m_.uses(h, *a)) { renumber(*a, n, n + 1); }
+  }
+  auto const hs = m_.fields_of(h);
+  for(auto a = hs.first; a != hs.second; ++a) {
+    if(!m_.uses(g, *a)) { renumber(*a, n + 1, n); }
+  }
+  for(auto & ch : changes) { top_[ch.first] = ch.second; }
+  for(auto & ch : changes) { fill_row(ch.first); }
+  score_ += delta;
+  return;
+}  // swap_funcs
+
+uint32_t
+diagonalizer::search(uint32_t const max_rounds, uint32_t const n_jobs)
+{
+  uint32_t const n_workers = std::max(1u, n_jobs);
+  size_t const stride = size_t(nf_) + 1;
+  index_t const n_funcs = static_cast<index_t>(func_at_.size());
+  std::vector<int64_t> r(nf_ * stride, 0);
+  uint32_t n_swaps(0);
+  for(; n_swaps < max_rounds; ++n_swaps) {
+    /* r[y][k] = sum of d(y, field at position i) for i < k, so the sum over
+     * the fields between two positions, which swap_fields_delta loops over,
+     * is a difference of two entries. */
+    run_workers(n_workers, [&](uint32_t const w) {
+      for(index_t y = w; y < nf_; y += n_workers) {
+        int64_t * ry = &r[y * stride];
+        ry[0] = 0;
+        for(index_t k = 0; k < nf_; ++k) { ry[k + 1] = ry[k] + d(y, at_[k]); }
+      }
+    });
+    std::vector<move_t> best(n_workers);
+    run_workers(n_workers, [&](uint32_t const w) {
+      move_t & b(best[w]);
+      for(index_t p = w; p < nf_; p += n_workers) {
+        index_t const a = at_[p];
+        int64_t const * ra = &r[a * stride];
+        for(index_t q = p + 1; q < nf_; ++q) {
+          index_t const x = at_[q];
+          int64_t const * rx = &r[x * stride];
+          move_t m;
+          m.delta = d(a, x) + (ra[q] - ra[p + 1]) - (rx[q] - rx[p + 1]);
+          m.i = p;
+          m.j = q;
+          if(m < b) { b = m; }
+        }
+      }
+      for(index_t n = w; n + 1 < n_funcs; n += n_workers) {
+        move_t m;
+        m.delta = swap_funcs_delta(n);
+        m.kind = 1;
+        m.i = n;
+        if(m < b) { b = m; }
+      }
+    });
+    move_t const m = *std::min_element(best.begin(), best.end());
+    if(m.delta >= 0) { break; }
+    if(0 == m.kind) { swap_fields(m.i, m.j); }
+    else {
+      swap_funcs(m.i);
+    }
+  }
+  return n_swaps;
+}  // search
+
+// clusters
+
+int64_t
+cluster_score(use_matrix const & m, std::vector<use_matrix::index_t> const & c)
+{
+  cluster_sums sums(m);
+  for(auto f : c) { sums.add(m, f); }
+  return sums.score();
+}
+
+int64_t
+grow_cluster(use_matrix const & m,
+             std::vector<use_matrix::index_t> & c,
+             std::vector<use_matrix::index_t> const & candidates)
+{
+  cluster_sums sums(m);
+  std::vector<bool> in_c(m.n_fields(), false);
+  for(auto f : c) {
+    sums.add(m, f);
+    in_c[f] = true;
+  }
+  int64_t score = sums.score();
+  while(true) {
+    int64_t best = std::numeric_limits<int64_t>::min();
+    size_t best_i = candidates.size();
+    for(size_t i = 0; i < candidates.size(); ++i) {
+      if(in_c[candidates[i]]) { continue; }
+      int64_t const s = sums.score_with(m, candidates[i]);
+      if(s > best) {
+        best = s;
+        best_i = i;
+      }
+    }
+    if(best_i == candidates.size() || best <= score) { break; }
+    use_matrix::index_t const f = candidates[best_i];
+    sums.add(m, f);
+    in_c[f] = true;
+    c.push_back(f);
+    score = best;
+  }
+  return score;
+}  // grow_cluster
+
+std::vector<std::vector<use_matrix::index_t>>
+find_clusters(use_matrix const & m,
+              std::vector<use_matrix::index_t> const & order)
+{
+  std::vector<std::vector<use_matrix::index_t>> clusters;
+  std::vector<bool> done(m.n_fields(), false);
+  std::vector<use_matrix::index_t> pos(m.n_fields(), 0);
+  for(size_t i = 0; i < order.size(); ++i) {
+    pos[order[i]] = static_cast<use_matrix::index_t>(i);
+  }
+  for(auto seed : order) {
+    if(done[seed]) { continue; }
+    std::vector<use_matrix::index_t> rest;
+    for(auto f : order) {
+      if(!done[f] && f != seed) { rest.push_back(f); }
+    }
+    std::vector<use_matrix::index_t> c = {seed};
+    grow_cluster(m, c, rest);
+    for(auto f : c) { done[f] = true; }
+    std::sort(c.begin(), c.end(), [&pos](auto x, auto y) {
+      return pos[x] < pos[y];
+    });
+    clusters.push_back(std::move(c));
+  }
+  return clusters;
+}  // find_clusters
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,199 @@
+// field_cluster.h
+// Oct 17, 2026
+
+/* Find groups of struct fields that are used together, i.e. candidates for
+ * splitting a struct, from the uses that struct_field_user records. This is
+ * a port of the Haskell scorer in tools/data-use/score: diagonalizer follows
+ * Diagonalize.hs, and cluster_score/grow_cluster follow Cluster.hs. */
+
+#pragma once
+
+#include "field_use_file.h"
+#include "types.h"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace corct {
+
+/**\brief Which functions use which fields of one struct.
+ *
+ * Functions and fields are numbered densely from zero, in name order. The
+ * uses are stored as compressed rows in both directions (functions of a field
+ * and fields of a function), plus one bit row per function for O(1) lookup.
+ */
+class use_matrix {
+public:
+  using index_t = uint32_t;
+  using range_t = std::pair<index_t const *, index_t const *>;
+  /**\brief function -> fields, e.g. one struct's entry in
+   * struct_field_user::lhs_uses() */
+  using func_fields_t = std::map<string_t, std::set<string_t>>;
+
+  index_t n_funcs() const { return static_cast<index_t>(func_names_.size()); }
+
+  index_t n_fields() const
+  {
+    return static_cast<index_t>(field_names_.size());
+  }
+
+  bool uses(index_t const func, index_t const field) const
+  {
+    return 0 != (bits_[size_t(func) * words_ + field / 64] &
+                 (1ull << (field % 64)));
+  }
+
+  /**\brief Functions that use field, in increasing order. */
+  range_t funcs_of(index_t const field) const
+  {
+    return {&fld_funcs_[0] + fld_start_[field],
+            &fld_funcs_[0] + fld_start_[field + 1]};
+  }
+
+  /**\brief Fields used by func, in increasing order. */
+  range_t fields_of(index_t const func) const
+  {
+    return {&fnc_fields_[0] + fnc_start_[func],
+            &fnc_fields_[0] + fnc_start_[func + 1]};
+  }
+
+  string_t const & func_name(index_t const i) const { return func_names_[i]; }
+
+  string_t const & field_name(index_t const i) const
+  {
+    return field_names_[i];
+  }
+
+  explicit use_matrix(func_fields_t const & uses);
+
+  /**\brief Uses (reads and writes) of struct s_id in a field use file. */
+  use_matrix(field_use_file const & f, uint32_t const s_id);
+
+private:
+  /**\brief Fill in the index structures from (func, field) pairs. */
+  void build(std::vector<std::pair<index_t, index_t>> & uses);
+
+  vec_str func_names_;
+  vec_str field_names_;
+  std::vector<index_t> fld_start_;   // by field: offsets into fld_funcs_
+  std::vector<index_t> fld_funcs_;
+  std::vector<index_t> fnc_start_;   // by function: offsets into fnc_fields_
+  std::vector<index_t> fnc_fields_;
+  std::vector<uint64_t> bits_;       // one row of words_ words per function
+  index_t words_ = 0;
+};  // use_matrix
+
+/**\brief Search for field and function orders that make the use matrix nearly
+ * block diagonal (Diagonalize.hs).
+ *
+ * Fields are placed at positions, functions are given numbers. For fields a
+ * and b, let c(a, b) be the number of functions that use b and are numbered
+ * above every function that uses a. The score sums c(a, b) over every pair
+ * with b before a, and is 0 when each field's users sit below the users of
+ * every later field. Lower is better.
+ *
+ * c is kept as a dense n_fields x n_fields matrix, so that the change in
+ * score from a swap is found without rescoring: O(1) per field swap during a
+ * search, and O(fields touched x n_fields) per function swap.
+ */
+class diagonalizer {
+public:
+  using index_t = use_matrix::index_t;
+  using score_t = int64_t;
+
+  /**\brief Score of the current orders, kept up to date by the swaps. */
+  score_t score() const { return score_; }
+
+  /**\brief Score of the current orders, computed from scratch. */
+  score_t full_score() const;
+
+  /**\brief Field at each position. */
+  std::vector<index_t> const & field_order() const { return at_; }
+
+  /**\brief Function with each number. */
+  std::vector<index_t> const & func_order() const { return func_at_; }
+
+  /**\brief Change in score if the fields at positions p and q swapped. */
+  score_t swap_fields_delta(index_t p, index_t q) const;
+
+  void swap_fields(index_t const p, index_t const q);
+
+  /**\brief Change in score if the functions numbered n and n+1 swapped. */
+  score_t swap_funcs_delta(index_t const n) const;
+
+  void swap_funcs(index_t const n);
+
+  /**\brief Repeatedly make the swap (of two fields, or of two adjacent
+   * function numbers) that lowers the score most, until none does or
+   * max_rounds swaps have been made. Candidate swaps are evaluated on n_jobs
+   * threads; the result does not depend on n_jobs.
+   * \return number of swaps made */
+  uint32_t search(uint32_t const max_rounds, uint32_t const n_jobs = 1);
+
+  /**\brief Start with fields and functions in index (name) order. */
+  explicit diagonalizer(use_matrix const & m);
+
+private:
+  int32_t c(index_t const a, index_t const b) const
+  {
+    return c_[size_t(a) * nf_ + b];
+  }
+
+  /**\brief c(a, b) - c(b, a) */
+  int32_t d(index_t const a, index_t const b) const
+  {
+    return c(a, b) - c(b, a);
+  }
+
+  /**\brief Number of users of field b numbered above threshold. */
+  index_t n_above(index_t const b, index_t const threshold) const;
+
+  /**\brief Recompute row a of c. */
+  void fill_row(index_t const a);
+
+  /**\brief Fields whose top user changes when functions n and n+1 swap, and
+   * their new top numbers. */
+  std::vector<std::pair<index_t, index_t>> top_changes(index_t const n) const;
+
+  use_matrix const & m_;
+  index_t nf_;                     // number of fields
+  std::vector<index_t> at_;        // position -> field
+  std::vector<index_t> pos_;       // field -> position
+  std::vector<index_t> func_at_;   // number -> function
+  std::vector<index_t> num_;       // function -> number
+  std::vector<index_t> nstart_;    // field -> offset into nums_
+  std::vector<index_t> nums_;      // users' numbers, sorted, per field
+  std::vector<index_t> top_;       // field -> highest number of its users
+  std::vector<int32_t> c_;         // c(a, b), row-major
+  score_t score_ = 0;
+};  // diagonalizer
+
+/**\brief Score a cluster of fields across all functions (Cluster.hs).
+ *
+ * The score starts at the cluster size. Then for each function and each
+ * pair of fields in the cluster: +1 if the function uses both, -1 if it
+ * uses just one. Higher is better. */
+int64_t
+cluster_score(use_matrix const & m, std::vector<use_matrix::index_t> const & c);
+
+/**\brief Grow cluster c greedily (probeClustering in Cluster.hs): add the
+ * candidate field that raises the score most, as long as one does. Ties go
+ * to the earlier candidate.
+ * \return final score */
+int64_t
+grow_cluster(use_matrix const & m,
+             std::vector<use_matrix::index_t> & c,
+             std::vector<use_matrix::index_t> const & candidates);
+
+/**\brief Partition the fields into clusters: seed a cluster with the first
+ * unclustered field in 'order', grow it from the rest, and repeat. */
+std::vector<std::vector<use_matrix::index_t>>
+find_clusters(use_matrix const & m,
+              std::vector<use_matrix::index_t> const & order);
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,176 @@
+// field_use_file.cc
+// Oct 17, 2026
+
+#include "field_use_file.h"
+
+#include "binary_layout.h"
+#include "llvm/ADT/StringMap.h"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+namespace corct {
+
+namespace {
+char const fu_magic[8] = {'C', 'O', 'R', 'C', 'T', 'F', 'U', '\0'};
+uint32_t const fu_version = 1;
+uint32_t const fu_byte_order = 0x01020304;
+}  // namespace
+
+void
+write_field_uses(named_field_uses_t const & lhs_uses,
+                 named_field_uses_t const & non_lhs_uses,
+                 std::ostream & o)
+{
+  named_field_uses_t const * const uses[2] = {&non_lhs_uses, &lhs_uses};
+  // dictionaries: sorted names, ids by position
+  std::set<string_t> names[fu_n_dicts];
+  for(auto u : uses) {
+    for(auto & s_it : *u) {
+      names[0].insert(s_it.first);
+      for(auto & f_it : s_it.second) {
+        names[1].insert(f_it.first);
+        names[2].insert(f_it.second.begin(), f_it.second.end());
+      }
+    }
+  }
+  llvm::StringMap<uint32_t> ids[fu_n_dicts];
+  for(uint32_t d = 0; d < fu_n_dicts; ++d) {
+    uint32_t id(0);
+    for(auto & n : names[d]) { ids[d][n] = id++; }
+  }
+  using row_t = std::tuple<uint32_t, uint32_t, uint32_t, uint8_t>;
+  std::vector<row_t> rows;
+  for(uint8_t lhs = 0; lhs < 2; ++lhs) {
+    for(auto & s_it : *uses[lhs]) {
+      uint32_t const s = ids[0][s_it.first];
+      for(auto & f_it : s_it.second) {
+        uint32_t const f = ids[1][f_it.first];
+        for(auto & m : f_it.second) {
+          rows.emplace_back(s, f, ids[2][m], lhs);
+        }
+      }
+    }
+  }
+  std::sort(rows.begin(), rows.end());
+
+  field_use_header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, fu_magic, sizeof(fu_magic));
+  h.version = fu_version;
+  h.byte_order = fu_byte_order;
+  h.n_uses = rows.size();
+  string_t b(sizeof(h), '\0');
+  pad8(b);
+  for(uint32_t d = 0; d < fu_n_dicts; ++d) {
+    h.n_names[d] = names[d].size();
+    append_dict(b, names[d], h.name_offsets[d], h.name_chars[d]);
+  }
+  h.columns[0] = b.size();
+  for(auto & r : rows) { append_pod(b, std::get<0>(r)); }
+  pad8(b);
+  h.columns[1] = b.size();
+  for(auto & r : rows) { append_pod(b, std::get<1>(r)); }
+  pad8(b);
+  h.columns[2] = b.size();
+  for(auto & r : rows) { append_pod(b, std::get<2>(r)); }
+  pad8(b);
+  h.columns[3] = b.size();
+  for(auto & r : rows) { append_pod(b, std::get<3>(r)); }
+  pad8(b);
+  std::memcpy(&b[0], &h, sizeof(h));
+  o.write(b.data(), b.size());
+  return;
+}  // write_field_uses
+
+bool
+field_use_file::open(str_t_cr path, string_t & err)
+{
+  auto buf = llvm::MemoryBuffer::getFile(path, -1, false);
+  if(!buf) {
+    err = path + ": " + buf.getError().message();
+    return false;
+  }
+  if(!open(std::move(*buf), err)) {
+    err = path + ": " + err;
+    return false;
+  }
+  return true;
+}  // open
+
+bool
+field_use_file::open(std::unique_ptr<llvm::MemoryBuffer> buf, string_t & err)
+{
+  h_ = nullptr;
+  buf_ = std::move(buf);
+  uint64_t const size = buf_->getBufferSize();
+  if(size < sizeof(field_use_header)) {
+    err = "too short for a field use file";
+    return false;
+  }
+  if(0 != (reinterpret_cast<uintptr_t>(base()) & 7)) {
+    err = "buffer is not 8-byte aligned";
+    return false;
+  }
+  auto const h = reinterpret_cast<field_use_header const *>(base());
+  if(0 != std::memcmp(h->magic, fu_magic, sizeof(fu_magic))) {
+    err = "not a field use file";
+    return false;
+  }
+  if(h->byte_order != fu_byte_order) {
+    err = "written with a different byte order";
+    return false;
+  }
+  if(h->version != fu_version) {
+    err = "unsupported version " + std::to_string(h->version);
+    return false;
+  }
+  for(uint32_t d = 0; d < fu_n_dicts; ++d) {
+    if(!valid_dict(base(), size, h->n_names[d], h->name_offsets[d],
+                   h->name_chars[d])) {
+      err = "bad name dictionary";
+      return false;
+    }
+  }
+  for(uint32_t c = 0; c < 4; ++c) {
+    uint64_t const elem = c < 3 ? sizeof(uint32_t) : sizeof(uint8_t);
+    if(!in_bounds(h->columns[c], h->n_uses, elem, size) ||
+       0 != (h->columns[c] & (elem - 1))) {
+      err = "bad column";
+      return false;
+    }
+  }
+  // consumers index the dictionaries with the ids directly
+  for(uint32_t d = 0; d < fu_n_dicts; ++d) {
+    auto const ids = reinterpret_cast<uint32_t const *>(base() + h->columns[d]);
+    uint64_t const n_names = h->n_names[d];
+    if(std::any_of(ids, ids + h->n_uses,
+                   [n_names](uint32_t const id) { return id >= n_names; })) {
+      err = "id out of range of its dictionary";
+      return false;
+    }
+  }
+  h_ = h;
+  return true;
+}  // open
+
+llvm::StringRef
+field_use_file::name(fu_dict const d, uint32_t const id) const
+{
+  if(!h_ || id >= h_->n_names[idx(d)]) { return ""; }
+  return dict_name(base(), h_->name_offsets[idx(d)], h_->name_chars[idx(d)],
+                   id);
+}  // name
+
+bool
+field_use_file::find(fu_dict const d, llvm::StringRef nm, uint32_t & id) const
+{
+  if(!h_) { return false; }
+  return dict_find(base(), h_->n_names[idx(d)], h_->name_offsets[idx(d)],
+                   h_->name_chars[idx(d)], nm, id);
+}  // find
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,115 @@
+// field_use_file.h
+// Oct 17, 2026
+
+/* Binary, columnar export of struct field uses (see struct_field_user), laid
+ * out so that a consumer can memory-map the file and use it in place.
+ *
+ * Layout, in the writer's byte order (recorded in the header):
+ *
+ *   field_use_header
+ *   for each dictionary (structs, functions, fields):
+ *     uint32_t offsets[n_names + 1]   name i is chars[offsets[i]..offsets[i+1])
+ *     char chars[]                    names, each followed by a NUL
+ *   uint32_t struct_ids[n_uses]
+ *   uint32_t func_ids[n_uses]
+ *   uint32_t field_ids[n_uses]
+ *   uint8_t is_lhs[n_uses]            1: written, 0: read
+ *
+ * Every section starts on an 8-byte boundary. Names in each dictionary are
+ * sorted, ids are dense from zero, and rows are sorted by (struct, function,
+ * field, is_lhs), so the file depends only on the uses, not on how they were
+ * gathered. A field that a function both reads and writes has two rows.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+
+namespace corct {
+
+/**\brief Name dictionaries in a field use file. */
+enum class fu_dict : uint32_t { structs = 0, funcs = 1, fields = 2 };
+
+constexpr uint32_t fu_n_dicts = 3;
+
+struct field_use_header {
+  char magic[8];                    //!< "CORCTFU" and a NUL
+  uint32_t version;                 //!< 1
+  uint32_t byte_order;              //!< 0x01020304 as the writer stored it
+  uint64_t n_uses;                  //!< number of rows
+  uint64_t n_names[fu_n_dicts];     //!< names in each dictionary
+  uint64_t name_offsets[fu_n_dicts];  //!< file offset of each offsets array
+  uint64_t name_chars[fu_n_dicts];  //!< file offset of each name block
+  uint64_t columns[4];  //!< file offsets: struct, func, field ids, is_lhs
+};  // field_use_header
+
+/**\brief struct -> function -> fields, as struct_field_user::lhs_uses(). */
+using named_field_uses_t =
+    std::map<string_t, std::map<string_t, std::set<string_t>>>;
+
+/**\brief Write lhs (written) and non-lhs (read) uses in the binary format. */
+void
+write_field_uses(named_field_uses_t const & lhs_uses,
+                 named_field_uses_t const & non_lhs_uses,
+                 std::ostream & o);
+
+/**\brief Read-only view of a field use file.
+ *
+ * The file is memory-mapped where the platform allows; the columns and names
+ * point into the mapping, and nothing is decoded or copied.
+ */
+class field_use_file {
+public:
+  /**\brief Map the file at path.
+   * \return false, with a message in err, if it is not a valid file */
+  bool open(str_t_cr path, string_t & err);
+
+  /**\brief Use a buffer that already holds a field use file. */
+  bool open(std::unique_ptr<llvm::MemoryBuffer> buf, string_t & err);
+
+  uint64_t n_uses() const { return h_ ? h_->n_uses : 0; }
+
+  uint32_t const * struct_ids() const { return column<uint32_t>(0); }
+  uint32_t const * func_ids() const { return column<uint32_t>(1); }
+  uint32_t const * field_ids() const { return column<uint32_t>(2); }
+  uint8_t const * is_lhs() const { return column<uint8_t>(3); }
+
+  uint32_t n_names(fu_dict const d) const
+  {
+    return h_ ? static_cast<uint32_t>(h_->n_names[idx(d)]) : 0;
+  }
+
+  /**\brief Name of id in dictionary d; the data is NUL-terminated. */
+  llvm::StringRef name(fu_dict const d, uint32_t const id) const;
+
+  /**\brief Id of name in dictionary d (binary search).
+   * \return true if found */
+  bool find(fu_dict const d, llvm::StringRef name, uint32_t & id) const;
+
+private:
+  static uint32_t idx(fu_dict const d) { return static_cast<uint32_t>(d); }
+
+  template <typename T>
+  T const * column(uint32_t const c) const
+  {
+    if(!h_) { return nullptr; }
+    return reinterpret_cast<T const *>(base() + h_->columns[c]);
+  }
+
+  char const * base() const { return buf_->getBufferStart(); }
+
+  std::unique_ptr<llvm::MemoryBuffer> buf_;
+  field_use_header const * h_ = nullptr;
+};  // field_use_file
+
+}  // namespace corct
+
+// End of file
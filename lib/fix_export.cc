@@ -0,0 +1,196 @@
+// fix_export.cc
+// Oct 17, 2026
+
+#include "fix_export.h"
+
+#include "clang/Tooling/ReplacementsYaml.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/YAMLTraits.h"
+#include "llvm/Support/raw_os_ostream.h"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+namespace corct {
+
+namespace {
+void
+write_tu(llvm::raw_ostream & o, str_t_cr main_source, vec_repl const & reps)
+{
+  clang::tooling::TranslationUnitReplacements tu;
+  tu.MainSourceFile = main_source;
+  tu.Replacements = reps;
+  llvm::yaml::Output yaml(o);
+  yaml << tu;
+  return;
+}  // write_tu
+}  // namespace
+
+vec_repl
+flatten(replacements_map_t const & reps)
+{
+  vec_repl rs;
+  for(auto & p : reps) {
+    rs.insert(rs.end(), p.second.begin(), p.second.end());
+  }
+  return rs;
+}  // flatten
+
+void
+write_fixes(std::ostream & o, str_t_cr main_source, vec_repl const & reps)
+{
+  llvm::raw_os_ostream ro(o);
+  write_tu(ro, main_source, reps);
+  return;
+}  // write_fixes
+
+void
+write_fixes(std::ostream & o,
+            str_t_cr main_source,
+            replacements_map_t const & reps,
+            str_t_cr working_dir)
+{
+  vec_repl rs;
+  for(auto & p : reps) {
+    for(auto & r : p.second) {
+      rs.emplace_back(normalized_path(r.getFilePath(), working_dir),
+                      r.getOffset(), r.getLength(), r.getReplacementText());
+    }
+  }
+  write_fixes(o, main_source, rs);
+  return;
+}  // write_fixes
+
+string_t
+fixes_path(str_t_cr dir, size_t const index, str_t_cr source)
+{
+  char num[32];
+  std::snprintf(num, sizeof(num), "%06zu-", index);
+  llvm::SmallString<256> p(dir);
+  llvm::sys::path::append(p,
+                          num + llvm::sys::path::filename(source).str() +
+                              ".yaml");
+  return p.str().str();
+}  // fixes_path
+
+bool
+export_fixes(str_t_cr dir,
+             size_t const index,
+             str_t_cr source,
+             vec_repl const & reps,
+             string_t & err)
+{
+  string_t const path = fixes_path(dir, index, source);
+  llvm::SmallString<256> model(path + "-%%%%%%.tmp"), tmp_path;
+  int fd(-1);
+  if(std::error_code ec =
+         llvm::sys::fs::createUniqueFile(model, fd, tmp_path)) {
+    err = path + ": " + ec.message();
+    return false;
+  }
+  {
+    llvm::raw_fd_ostream o(fd, /*shouldClose*/ true);
+    write_tu(o, source, reps);
+    o.close();
+    if(o.has_error()) {
+      o.clear_error();
+      llvm::sys::fs::remove(tmp_path);
+      err = path + ": write failed";
+      return false;
+    }
+  }
+  if(std::error_code ec = llvm::sys::fs::rename(tmp_path, path)) {
+    llvm::sys::fs::remove(tmp_path);
+    err = path + ": " + ec.message();
+    return false;
+  }
+  return true;
+}  // export_fixes
+
+bool
+export_fixes(str_t_cr dir,
+             size_t const index,
+             str_t_cr source,
+             replacements_map_t const & reps,
+             string_t & err)
+{
+  return export_fixes(dir, index, source, flatten(reps), err);
+}
+
+bool
+read_fixes(str_t_cr path, replacement_set & set, string_t & err)
+{
+  auto buf = llvm::MemoryBuffer::getFile(path);
+  if(!buf) {
+    err = path + ": " + buf.getError().message();
+    return false;
+  }
+  if(!parse_fixes((*buf)->getBuffer(), set, err)) {
+    err = path + ": " + err;
+    return false;
+  }
+  return true;
+}  // read_fixes
+
+bool
+parse_fixes(llvm::StringRef text, replacement_set & set, string_t & err)
+{
+  // yaml::Input reports an empty stream as an error
+  if(text.trim().empty()) { return true; }
+  llvm::yaml::Input yin(text);
+  do {
+    clang::tooling::TranslationUnitReplacements tu;
+    yin >> tu;
+    if(yin.error()) {
+      err = yin.error().message();
+      return false;
+    }
+    for(auto & r : tu.Replacements) {
+      set.add(r.getFilePath(), r.getOffset(), r.getLength(),
+              r.getReplacementText(), tu.MainSourceFile);
+    }
+  } while(yin.nextDocument());
+  return true;
+}  // parse_fixes
+
+bool
+read_fixes(std::istream & i, replacement_set & set, string_t & err)
+{
+  string_t const text((std::istreambuf_iterator<char>(i)),
+                      std::istreambuf_iterator<char>());
+  return parse_fixes(text, set, err);
+}
+
+vec_str
+expand_fixes_dirs(vec_str const & paths)
+{
+  vec_str expanded;
+  for(auto & p : paths) {
+    if(!llvm::sys::fs::is_directory(p)) {
+      expanded.push_back(p);
+      continue;
+    }
+    vec_str fixes;
+    std::error_code ec;
+    for(llvm::sys::fs::directory_iterator it(p, ec), end; it != end && !ec;
+        it.increment(ec)) {
+      if(llvm::sys::path::extension(it->path()) == ".yaml") {
+        fixes.push_back(it->path());
+      }
+    }
+    if(ec) {
+      std::cerr << "expand_fixes_dirs: error reading " << p << ": "
+                << ec.message() << "\n";
+    }
+    std::sort(fixes.begin(), fixes.end());
+    expanded.insert(expanded.end(), fixes.begin(), fixes.end());
+  }
+  return expanded;
+}  // expand_fixes_dirs
+
+}  // namespace corct
+
+// End of file
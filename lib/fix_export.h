@@ -0,0 +1,87 @@
+// fix_export.h
+// Oct 17, 2026
+
+/* Replacements written out as YAML, one file per TU, in the format that
+ * clang-apply-replacements reads (clang::tooling::TranslationUnitReplacements).
+ * A tool can export each TU's edits as soon as the TU is done, rather than
+ * hold every edit until the end of the run; if the run dies, the edits of
+ * the finished TUs are on disk. apply-fixes (or clang-apply-replacements)
+ * applies them afterwards. */
+
+#pragma once
+
+#include "replacement_set.h"
+#include "types.h"
+
+#include "clang/Tooling/Core/Replacement.h"
+#include <iostream>
+
+namespace corct {
+
+/**\brief Write reps as one TranslationUnitReplacements YAML document. */
+void
+write_fixes(std::ostream & o, str_t_cr main_source, vec_repl const & reps);
+
+/**\brief Write reps, with each file made absolute against working_dir as
+ * replacement_set::add would make it: a TU's cached edits then replay to
+ * the same files, whatever directory read_fixes runs in. */
+void
+write_fixes(std::ostream & o,
+            str_t_cr main_source,
+            replacements_map_t const & reps,
+            str_t_cr working_dir = "");
+
+/**\brief Where export_fixes puts the fixes of the index'th source:
+ * dir/<index, six digits>-<file name>.yaml, so names are unique and sort in
+ * source order. */
+string_t
+fixes_path(str_t_cr dir, size_t const index, str_t_cr source);
+
+/**\brief Write a TU's fixes to fixes_path(dir, index, source). The file is
+ * written under a temporary name and renamed, so it is never seen half
+ * written. A TU with no edits still gets a (short) file.
+ * \return false, with a message in err, on failure */
+bool
+export_fixes(str_t_cr dir,
+             size_t const index,
+             str_t_cr source,
+             vec_repl const & reps,
+             string_t & err);
+
+bool
+export_fixes(str_t_cr dir,
+             size_t const index,
+             str_t_cr source,
+             replacements_map_t const & reps,
+             string_t & err);
+
+/**\brief Every edit in reps, file by file. */
+vec_repl
+flatten(replacements_map_t const & reps);
+
+/**\brief Add the edits in a fixes file to set, with the file's main source
+ * as their source.
+ * \return false, with a message in err, if the file can't be read */
+bool
+read_fixes(str_t_cr path, replacement_set & set, string_t & err);
+
+/**\brief Add the edits in every YAML document in text (e.g. the output of
+ * several write_fixes calls) to set, each with its document's main source as
+ * the source.
+ * \return false, with a message in err, if text can't be parsed */
+bool
+parse_fixes(llvm::StringRef text, replacement_set & set, string_t & err);
+
+/**\brief parse_fixes on the rest of stream i, e.g. the data a TU wrote
+ * for a cache or journal. */
+bool
+read_fixes(std::istream & i, replacement_set & set, string_t & err);
+
+/**\brief Expand each directory in paths to the .yaml files in it, sorted.
+ * Other paths are passed through. */
+vec_str
+expand_fixes_dirs(vec_str const & paths);
+
+}  // namespace corct
+
+// End of file
@@ -32,8 +32,8 @@ struct FunctionDefLister : public callback_t {
     if(fdecl) {
       m_num_funcs++;
       SourceManager & sm(result.Context->getSourceManager());
-      print_function_decl_details(fdecl, sm, std::cout);
-      std::cout << "-=--=--=--=--=--=-\n";
+      print_function_decl_details(fdecl, sm, out_);
+      out_ << "-=--=--=--=--=--=-\n";
     }
     else {
       corct::check_ptr(fdecl, "fdecl");
@@ -41,12 +41,16 @@ struct FunctionDefLister : public callback_t {
     return;
   }  // run
 
-  explicit FunctionDefLister(str_t_cr bd_name) : bd_name_(bd_name) {}
+  explicit FunctionDefLister(str_t_cr bd_name, std::ostream & o = std::cout)
+      : bd_name_(bd_name), out_(o)
+  {
+  }
 
   size_t m_num_funcs = 0u;
 
 private:
   string_t bd_name_ = "";
+  std::ostream & out_;
 };  // FunctionDefLister
 
 }  // namespace corct
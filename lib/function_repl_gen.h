@@ -5,6 +5,7 @@
 #ifndef FUNCTION_REPL_GEN_H
 #define FUNCTION_REPL_GEN_H
 
+#include "target_set.h"
 #include "types.h"
 #include "utilities.h"
 
@@ -25,6 +26,10 @@ The interface distinguishes between function targets and method targets. While
 both canbe handled by the same callback, they require different matchers. This
 actually allows the callback to distinguish between methods and free functions
 with the same name.
+
+With many targets, the combined_*_matchers() are much cheaper: MatchFinder
+tries one hasAnyName matcher on each node instead of one matcher per target.
+run() has to check which target it got in either case.
 */
 template <typename traits_t>
 class function_replacement_generator
@@ -44,6 +49,12 @@ public:
   /**\brief Generate an AST matcher for target function. */
   virtual matcher_t mk_mthd_matcher(str_t_cr target) const = 0;
 
+  /**\brief Generate one AST matcher for all the target functions. */
+  virtual matcher_t mk_fn_matcher(vec_str const & targets) const = 0;
+
+  /**\brief Generate one AST matcher for all the target methods. */
+  virtual matcher_t mk_mthd_matcher(vec_str const & targets) const = 0;
+
   /** \brief Get a set of function matchers to which derived class will respond.
    */
   matchers_t fn_matchers() const
@@ -62,6 +73,28 @@ public:
     return ms;
   }
 
+  /** \brief Get a single matcher for all function targets (none if there
+   * are no targets). */
+  matchers_t combined_fn_matchers() const
+  {
+    matchers_t ms;
+    if(!fn_targets_.empty()) {
+      ms.push_back(mk_fn_matcher(fn_targets_.names()));
+    }
+    return ms;
+  }
+
+  /** \brief Get a single matcher for all method targets (none if there
+   * are no targets). */
+  matchers_t combined_mthd_matchers() const
+  {
+    matchers_t ms;
+    if(!mthd_targets_.empty()) {
+      ms.push_back(mk_mthd_matcher(mthd_targets_.names()));
+    }
+    return ms;
+  }
+
   function_replacement_generator(replacements_map_t & rep_map,
                                  vec_str const & fn_targets,
                                  str_t_cr new_str,
@@ -98,8 +131,8 @@ public:
   // state
 protected:
   replacements_map_t & rep_map_;
-  vec_str const fn_targets_;    //!< function targets
-  vec_str const mthd_targets_;  //!< method targets
+  target_set const fn_targets_;    //!< function targets
+  target_set const mthd_targets_;  //!< method targets
   str_t_cr new_str_;
   bool const dry_run_;
 };  // replacement_generator
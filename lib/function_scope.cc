@@ -0,0 +1,113 @@
+// function_scope.cc
+// Oct 17, 2026
+
+#include "function_scope.h"
+
+#include "clang/AST/DeclCXX.h"
+#include "clang/Basic/SourceManager.h"
+#include <algorithm>
+
+namespace corct {
+
+namespace {
+/**\brief Is l inside r, comparing where macros were expanded? */
+bool
+range_holds(clang::SourceManager const & sm,
+            clang::SourceRange const & r,
+            clang::SourceLocation const l)
+{
+  clang::SourceLocation const b = sm.getExpansionLoc(r.getBegin());
+  clang::SourceLocation const e = sm.getExpansionLoc(r.getEnd());
+  clang::SourceLocation const x = sm.getExpansionLoc(l);
+  if(b.isInvalid() || e.isInvalid() || x.isInvalid()) { return false; }
+  return !sm.isBeforeInTranslationUnit(x, b) &&
+         !sm.isBeforeInTranslationUnit(e, x);
+}
+
+/**\brief First statement bound in a match, or nullptr. */
+clang::Stmt const *
+first_bound_stmt(result_t const & result)
+{
+  for(auto const & n : result.Nodes.getMap()) {
+    if(auto s = n.second.get<clang::Stmt>()) { return s; }
+  }
+  return nullptr;
+}
+
+/**\brief Is f a lambda's operator()? The traversal reaches it only through
+ * its parameters, and hasAncestor(functionDecl()) never finds it: a lambda
+ * body's parent is the LambdaExpr. So its uses belong to the function around
+ * the lambda. */
+bool
+is_lambda_call_operator(clang::FunctionDecl const * f)
+{
+  auto const m = llvm::dyn_cast<clang::CXXMethodDecl>(f);
+  return m && m->getParent()->isLambda();
+}
+
+/**\brief Lets register_with fill a MatchFinder, which spells it addMatcher. */
+struct finder_registry {
+  template <typename Matcher_t>
+  void add_matcher(Matcher_t const & m, callback_t * cb)
+  {
+    finder.addMatcher(m, cb);
+  }
+
+  finder_t finder;
+};  // finder_registry
+}  // namespace
+
+void
+enclosing_function::enter(clang::Decl const * d)
+{
+  stack_.clear();
+  while(d) {
+    auto f = llvm::dyn_cast<clang::FunctionDecl>(d);
+    if(f && !is_lambda_call_operator(f)) { stack_.push_back(f); }
+    clang::DeclContext const * dc = d->getLexicalDeclContext();
+    d = dc ? clang::Decl::castFromDeclContext(dc) : nullptr;
+  }
+  std::reverse(stack_.begin(), stack_.end());
+  current_ = stack_.empty() ? nullptr : stack_.back();
+  return;
+}
+
+void
+enclosing_function::resolve(result_t const & result)
+{
+  current_ = stack_.empty() ? nullptr : stack_.back();
+  // only nested functions can have been left behind
+  if(stack_.size() < 2) { return; }
+  clang::Stmt const * s = first_bound_stmt(result);
+  if(!s || !result.SourceManager) { return; }
+  for(auto it = stack_.rbegin(); it != stack_.rend(); ++it) {
+    if(range_holds(*result.SourceManager, (*it)->getSourceRange(),
+                   s->getBeginLoc())) {
+      current_ = *it;
+      return;
+    }
+  }
+  return;
+}
+
+void
+function_scope_finder::add_matcher(matcher_t const & m, callback_t * cb)
+{
+  auto & proxy = proxies_[cb];
+  if(!proxy) { proxy = std::make_unique<scoped_callback>(cb, scope_); }
+  matchers_.emplace_back(m, proxy.get());
+  return;
+}
+
+void
+function_scope_finder::match_ast(clang::ASTContext & ctx)
+{
+  finder_registry reg;
+  register_with(reg);
+  reg.finder.matchAST(ctx);
+  return;
+}
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,161 @@
+// function_scope.h
+// Oct 17, 2026
+
+/* Run statement matchers with the enclosing function known from the
+ * traversal, rather than found by hasAncestor(functionDecl()). hasAncestor
+ * walks the parent map for every candidate node, and the parent map itself
+ * costs a full extra traversal and a lot of memory per TU. */
+
+#pragma once
+
+#include "types.h"
+
+#include "clang/AST/Decl.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace corct {
+
+/**\brief The functions lexically enclosing the node a MatchFinder traversal
+ * is at, innermost last. A method of a local class is inside the function
+ * around it. */
+class enclosing_function {
+public:
+  /**\brief Innermost function around the current match, or nullptr outside
+   * any function. */
+  clang::FunctionDecl const * get() const { return current_; }
+
+  /**\brief The traversal reached d: the stack becomes the functions around
+   * d, and d itself if it is one. Lambda call operators are left out, as
+   * hasAncestor(functionDecl()) would leave them out. */
+  void enter(clang::Decl const * d);
+
+  /**\brief Point get() at the function holding a match: the innermost one
+   * on the stack whose source range holds the first statement bound in
+   * 'result', or the innermost one if none does (implicit code, default
+   * arguments). The traversal may have finished a nested function, such as
+   * a local class's method, without reaching another declaration. */
+  void resolve(result_t const & result);
+
+  void clear()
+  {
+    stack_.clear();
+    current_ = nullptr;
+  }
+
+private:
+  std::vector<clang::FunctionDecl const *> stack_;
+  clang::FunctionDecl const * current_ = nullptr;
+};  // enclosing_function
+
+/**\brief The function bound as "function" in a match, or else the innermost
+ * function of 'scope' (when a function_scope_finder is running). */
+inline clang::FunctionDecl const *
+bound_or_enclosing_function(result_t const & result,
+                            enclosing_function const * scope)
+{
+  auto f = result.Nodes.getNodeAs<clang::FunctionDecl>("function");
+  if(!f && scope) { f = scope->get(); }
+  return f;
+}
+
+/**\brief Match statements inside functions, tracking the enclosing function.
+ *
+ * The matchers run in a MatchFinder's one traversal of the TU, next to a
+ * decl() matcher that keeps scope() on the functions around the traversal.
+ * Each callback is called only for matches inside a function, and gets the
+ * function from scope() (see bound_or_enclosing_function), so matchers
+ * should leave out hasAncestor(functionDecl()). Matchers that need the
+ * parent map (hasParent, hasAncestor) still work, but cost what they always
+ * do.
+ *
+ * Register everything with a TU through register_with, e.g.
+ * fsf.register_with(tu) for a tu_context, which profiles the matchers like
+ * any others; or run a standalone MatchFinder with match_ast.
+ */
+class function_scope_finder {
+public:
+  using matcher_t = clang::ast_matchers::StatementMatcher;
+
+  void add_matcher(matcher_t const & m, callback_t * cb);
+
+  /**\brief Function enclosing the statement being matched. */
+  enclosing_function const & scope() const { return scope_; }
+
+  /**\brief Register the matchers, and the scope tracking, with anything
+   * that has add_matcher(matcher, callback): a tu_context, say. */
+  template <typename Registry_t>
+  void register_with(Registry_t & r)
+  {
+    r.add_matcher(clang::ast_matchers::decl().bind("scope_decl"), &tracker_);
+    for(auto & m : matchers_) { r.add_matcher(m.first, m.second); }
+  }
+
+  /**\brief Run the matchers over a whole TU with a MatchFinder of its own. */
+  void match_ast(clang::ASTContext & ctx);
+
+  function_scope_finder() : tracker_(scope_) {}
+
+  function_scope_finder(function_scope_finder const &) = delete;
+
+private:
+  /**\brief Moves the scope to each declaration the traversal reaches. */
+  class decl_tracker : public callback_t {
+  public:
+    void run(result_t const & result) override
+    {
+      scope_.enter(result.Nodes.getNodeAs<clang::Decl>("scope_decl"));
+    }
+
+    void onStartOfTranslationUnit() override { scope_.clear(); }
+
+    llvm::StringRef getID() const override { return "function_scope"; }
+
+    explicit decl_tracker(enclosing_function & scope) : scope_(scope) {}
+
+  private:
+    enclosing_function & scope_;
+  };  // decl_tracker
+
+  /**\brief Resolves the scope of a match, and passes it on to cb if it is in
+   * a function. */
+  class scoped_callback : public callback_t {
+  public:
+    void run(result_t const & result) override
+    {
+      scope_.resolve(result);
+      if(scope_.get()) { cb_->run(result); }
+    }
+
+    void onStartOfTranslationUnit() override
+    {
+      cb_->onStartOfTranslationUnit();
+    }
+
+    void onEndOfTranslationUnit() override { cb_->onEndOfTranslationUnit(); }
+
+    llvm::StringRef getID() const override { return cb_->getID(); }
+
+    scoped_callback(callback_t * cb, enclosing_function & scope)
+        : cb_(cb), scope_(scope)
+    {
+    }
+
+  private:
+    callback_t * cb_;
+    enclosing_function & scope_;
+  };  // scoped_callback
+
+  enclosing_function scope_;
+  decl_tracker tracker_;
+  // one stand-in per callback, so each sees one start and end of the TU
+  std::map<callback_t *, std::unique_ptr<scoped_callback>> proxies_;
+  std::vector<std::pair<matcher_t, callback_t *>> matchers_;
+};  // function_scope_finder
+
+}  // namespace corct
+
+// End of file
@@ -9,14 +9,17 @@
 #include "clang/ASTMatchers/ASTMatchers.h"
 #include "clang/Tooling/Core/Replacement.h"
 #include "clang/Tooling/Tooling.h"
+#include "apply_replacements.h"
 #include "function_repl_gen.h"
 #include "signature_insert.h"
 #include "types.h"
+#include "utilities.h"
 #include <iostream>
 
 namespace corct {
 /** Match a function (declaration bound to 'fn_bind_name') declaration
  matching specified name that is not in a system header. */
+inline
 auto
 mk_fn_decl_matcher(str_t_cr fn_name, str_t_cr fn_bind_name)
 {
@@ -29,7 +32,7 @@ mk_fn_decl_matcher(str_t_cr fn_name, str_t_cr fn_bind_name)
     ).bind(fn_bind_name);
 } // mk_fn_decl_matcher
 
-auto mk_mthd_decl_matcher(str_t_cr fn_name, str_t_cr fn_bind_name){
+inline auto mk_mthd_decl_matcher(str_t_cr fn_name, str_t_cr fn_bind_name){
   using namespace clang::ast_matchers;
   return
     cxxMethodDecl(
@@ -37,6 +40,28 @@ auto mk_mthd_decl_matcher(str_t_cr fn_name, str_t_cr fn_bind_name){
       hasName(fn_name)
     ).bind(fn_bind_name); // cxxMethodDecl
 }
+
+/** Match a declaration of any function named in fn_names. */
+inline auto mk_fn_decl_matcher(vec_str const & fn_names,
+                               str_t_cr fn_bind_name){
+  using namespace clang::ast_matchers;
+  return
+    functionDecl(
+      unless(isExpansionInSystemHeader()),
+      hasAnyName(as_string_refs(fn_names))
+    ).bind(fn_bind_name);
+} // mk_fn_decl_matcher
+
+/** Match a declaration of any method named in fn_names. */
+inline auto mk_mthd_decl_matcher(vec_str const & fn_names,
+                                 str_t_cr fn_bind_name){
+  using namespace clang::ast_matchers;
+  return
+    cxxMethodDecl(
+      unless(isExpansionInSystemHeader()),
+      hasAnyName(as_string_refs(fn_names))
+    ).bind(fn_bind_name); // cxxMethodDecl
+}
 // clang-format on
 
 struct expand_signature_traits {
@@ -52,6 +77,11 @@ public:
   using Base = function_replacement_generator<expand_signature_traits>;
   static const string_t fn_bind_name_;
 
+  llvm::StringRef getID() const override
+  {
+    return "function_signature_expander";
+  }
+
   void run(result_t const & result) override
   {
     clang::FunctionDecl * func_decl = const_cast<clang::FunctionDecl *>(
@@ -63,7 +93,7 @@ public:
       if(!dry_run_) {
         // use file name to select correct Replacements
         auto & reps = find_repls(func_decl, src_manager, rep_map_);
-        if(reps.add(rep)) { HERE("add replacement failed"); }
+        add_replacement(reps, rep);
       }
     }
     else {
@@ -82,6 +112,16 @@ public:
     return mk_mthd_decl_matcher(target, fn_bind_name_);
   }
 
+  matcher_t mk_fn_matcher(vec_str const & targets) const override
+  {
+    return mk_fn_decl_matcher(targets, fn_bind_name_);
+  }
+
+  matcher_t mk_mthd_matcher(vec_str const & targets) const override
+  {
+    return mk_mthd_decl_matcher(targets, fn_bind_name_);
+  }
+
   /** \brief Ctor
     \param reps: pointer to clang::Replacements object, as in
     tool.getReplacements() \param new_param: new parameter text, e.g.
@@ -7,9 +7,16 @@
 
 #include "clang/Tooling/Tooling.h"
 #include "dump_things.h"
+#include "function_scope.h"
+#include "jsonl_writer.h"
+#include "symbol_table.h"
 #include "types.h"
 #include "utilities.h"
+#include <cstdlib>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <set>
 
 namespace corct {
 // clang-format off
@@ -20,7 +27,7 @@ namespace corct {
             varName to the VarDecl
             function: to the FunctionDecl
   */
-auto all_global_var_matcher(){
+inline auto all_global_var_matcher(){
   using namespace clang::ast_matchers;
   return
   declRefExpr(
@@ -43,7 +50,7 @@ function. If no name given, matches each use of global variables in functions.
             varName to the VarDecl
             function: to the FunctionDecl
   */
-auto mk_global_var_matcher(std::string const & g_var_name = ""){
+inline auto mk_global_var_matcher(std::string const & g_var_name = ""){
   using namespace clang::ast_matchers;
   if(g_var_name != ""){
     return
@@ -63,13 +70,45 @@ auto mk_global_var_matcher(std::string const & g_var_name = ""){
   return all_global_var_matcher();
 } // mk_decl_matcherExpression E
 
+/**\brief As mk_global_var_matcher, but matches every reference, with no
+ function binding: for use with a function_scope_finder, which knows the
+ enclosing function without the hasAncestor lookup.
+
+  Bindings: globalReference to the reference
+            varName to the VarDecl
+  */
+inline auto mk_scoped_global_var_matcher(std::string const & g_var_name = ""){
+  using namespace clang::ast_matchers;
+  if(g_var_name != ""){
+    return
+    declRefExpr(
+      to(
+        varDecl(
+          hasGlobalStorage()
+         ,hasName(g_var_name)
+        ).bind("gvarName")
+      )
+    ).bind("globalReference")
+    ;
+  }
+  return
+  declRefExpr(
+    to(
+      varDecl(
+        hasGlobalStorage()
+      ).bind("gvarName")
+    ) // to
+  ).bind("globalReference")
+  ;
+} // mk_scoped_global_var_matcher
+
 /**\brief Matches functions that use any globabl variable.
 
   Bindings: globalReference to the reference
             varName to the VarDecl
             function: to the FunctionDecl
   */
-auto all_global_fn_matcher(){
+inline auto all_global_fn_matcher(){
   using namespace clang::ast_matchers;
   return
   functionDecl(
@@ -93,7 +132,7 @@ auto all_global_fn_matcher(){
             varName to the VarDecl
             function: to the FunctionDecl
   */
-auto mk_global_fn_matcher(std::string const & g_var_name = ""){
+inline auto mk_global_fn_matcher(std::string const & g_var_name = ""){
   using namespace clang::ast_matchers;
   if(g_var_name!=""){
     return
@@ -116,37 +155,162 @@ auto mk_global_fn_matcher(std::string const & g_var_name = ""){
 
 // clang-format on
 
+/**\brief Print each use of a global variable, and record which functions
+ use which globals.
+
+ Function and variable names are interned in a symbol_table, which may be
+ shared by several printers; uses_ maps function symbols to global symbols.
+ */
 class Global_Printer : public callback_t {
 public:
+  using sym_set_t = std::set<sym_id_t>;
+  using uses_t = std::map<sym_id_t, sym_set_t>;  // Key: func, Vals: globals
+  using named_uses_t = std::map<string_t, std::set<string_t>>;
+
+  llvm::StringRef getID() const override { return "Global_Printer"; }
+
   virtual void run(result_t const & result) override
   {
     using namespace clang;
     n_matches_++;
     FunctionDecl const * func_decl =
-        result.Nodes.getNodeAs<FunctionDecl>("function");
+        bound_or_enclosing_function(result, scope_);
     Expr const * g_var = result.Nodes.getNodeAs<Expr>("globalReference");
     VarDecl const * var = result.Nodes.getNodeAs<VarDecl>("gvarName");
     clang::SourceManager & src_manager(
         const_cast<clang::SourceManager &>(result.Context->getSourceManager()));
     if(func_decl && g_var && var) {
-      s_ << "In function '" << func_decl->getNameAsString() << "' ";
-      s_ << "'" << var->getNameAsString() << "' referred to at ";
+      /* Print the names from the Decls: looking them up in the table would
+       * take its lock, shared with every other worker, twice per match. */
+      string_t const f_name = func_decl->getNameAsString();
+      string_t const v_name = var->getNameAsString();
+      sym_id_t const f_id = cache_.get(func_decl, [&f_name] { return f_name; });
+      sym_id_t const v_id = cache_.get(var, [&v_name] { return v_name; });
+      uses_[f_id].insert(v_id);
+      if(output_format::jsonl == format_) {
+        jsonl_record rec(s_);
+        rec.str("kind", "global_ref")
+            .location(g_var->getBeginLoc(), src_manager)
+            .str("function", f_name)
+            .str("symbol", v_name)
+            .end();
+        return;
+      }
+      s_ << "In function '" << f_name << "' ";
+      s_ << "'" << v_name << "' referred to at ";
       string_t sr(sourceRangeAsString(g_var->getSourceRange(), &src_manager));
       s_ << sr;
       s_ << "\n";
     }
     else {
-      check_ptr(func_decl, "func_decl", "", s_);
-      check_ptr(g_var, "g_var", "", s_);
-      check_ptr(var, "var", "", s_);
+      // keep diagnostics out of a JSON Lines stream
+      std::ostream & o(output_format::jsonl == format_ ? std::cerr : s_);
+      check_ptr(func_decl, "func_decl", "", o);
+      check_ptr(g_var, "g_var", "", o);
+      check_ptr(var, "var", "", o);
     }
     return;
   }  // run
 
-  explicit Global_Printer(std::ostream & s) : s_(s), n_matches_(0) {}
+  /**\brief AST addresses are reused between TUs, so forget them. */
+  void onEndOfTranslationUnit() override { cache_.clear(); }
+
+  /**\brief Write text (the default), or JSON Lines records with fields kind
+   * ("global_ref"), file, line, col, function, and symbol. */
+  void set_format(output_format const f) { format_ = f; }
+
+  /**\brief Take the enclosing function from 'scope' when a match does not
+   * bind one (see function_scope_finder). */
+  void use_scope(enclosing_function const & scope) { scope_ = &scope; }
+
+  /**\brief uses_, resolved to names. */
+  named_uses_t named_uses() const
+  {
+    symbol_table const & syms(cache_.table());
+    named_uses_t n;
+    for(auto & f_it : uses_) {
+      std::set<string_t> & vs(n[syms.name(f_it.first)]);
+      for(auto v : f_it.second) { vs.insert(syms.name(v)); }
+    }
+    return n;
+  }
+
+  /**\brief Fold the matches and uses recorded by another printer into this
+   * one. */
+  void merge(Global_Printer const & other)
+  {
+    symbol_table & syms(cache_.table());
+    symbol_table const & from_syms(other.cache_.table());
+    bool const same_table = &syms == &from_syms;
+    auto xlate = [&](sym_id_t const id) {
+      return same_table ? id : syms.intern(from_syms.name(id));
+    };
+    for(auto & f_it : other.uses_) {
+      sym_set_t & vs(uses_[xlate(f_it.first)]);
+      for(auto v : f_it.second) { vs.insert(xlate(v)); }
+    }
+    n_matches_ += other.n_matches_;
+    return;
+  }
+
+  /**\brief Write the match count and uses, in name order, one per line:
+   *   'n_matches' <tab> n
+   *   'use' <tab> function <tab> global */
+  void write(std::ostream & o) const
+  {
+    o << "n_matches\t" << n_matches_ << "\n";
+    for(auto & f_it : named_uses()) {
+      for(auto & v : f_it.second) {
+        o << "use\t" << f_it.first << "\t" << v << "\n";
+      }
+    }
+    return;
+  }
+
+  /**\brief Read what write() wrote, merging it into this printer.
+   * \return false if a malformed line was encountered */
+  bool read(std::istream & i)
+  {
+    symbol_table & syms(cache_.table());
+    string_t line;
+    while(std::getline(i, line)) {
+      vec_str const fs(split(line, '\t'));
+      if(fs.size() == 2 && fs[0] == "n_matches") {
+        n_matches_ += std::strtoul(fs[1].c_str(), nullptr, 10);
+      }
+      else if(fs.size() == 3 && fs[0] == "use") {
+        uses_[syms.intern(fs[1])].insert(syms.intern(fs[2]));
+      }
+      else {
+        std::cerr << "Global_Printer::read: malformed line '" << line
+                  << "'\n";
+        return false;
+      }
+    }
+    return true;
+  }  // read
+
+  /**\brief Construct with a private symbol table. */
+  explicit Global_Printer(std::ostream & s)
+      : s_(s), n_matches_(0), own_syms_(new symbol_table), cache_(*own_syms_)
+  {
+  }
+
+  /**\brief Construct with a symbol table shared with other printers. */
+  Global_Printer(std::ostream & s, symbol_table & syms)
+      : s_(s), n_matches_(0), cache_(syms)
+  {
+  }
 
   std::ostream & s_;
   uint32_t n_matches_;
+  uses_t uses_;
+
+private:
+  std::shared_ptr<symbol_table> own_syms_;
+  symbol_cache cache_;
+  output_format format_ = output_format::text;
+  enclosing_function const * scope_ = nullptr;
 };  // class Global_Printer
 
 }  // namespace corct
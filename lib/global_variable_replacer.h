@@ -9,8 +9,10 @@
 #include "clang/ASTMatchers/ASTMatchers.h"
 #include "clang/Tooling/Core/Replacement.h"
 #include "clang/Tooling/Tooling.h"
+#include "apply_replacements.h"
 #include "make_replacement.h"
 #include "signature_insert.h"
+#include "target_set.h"
 #include "types.h"
 #include "utilities.h"
 #include <iostream>
@@ -19,7 +21,7 @@ namespace corct {
 // clang-format off
 /** \brief Match reference (bound to gref_bind_name) to a
   global variable named g_var_name in a function. */
-auto mk_global_var_matcher(str_t_cr g_var_name, str_t_cr gref_bind_name){
+inline auto mk_global_var_matcher(str_t_cr g_var_name, str_t_cr gref_bind_name){
   using namespace clang::ast_matchers;
   return declRefExpr(
     to(
@@ -32,6 +34,23 @@ auto mk_global_var_matcher(str_t_cr g_var_name, str_t_cr gref_bind_name){
     ).bind(gref_bind_name)
   ;
 }; // mk_global_var_matcher
+
+/** \brief Match reference (bound to gref_bind_name) to a
+  global variable with any of g_var_names in a function. */
+inline auto mk_global_var_matcher(vec_str const & g_var_names,
+                                  str_t_cr gref_bind_name){
+  using namespace clang::ast_matchers;
+  return declRefExpr(
+    to(
+      varDecl(
+        hasGlobalStorage()
+       ,hasAnyName(as_string_refs(g_var_names))
+      )
+       )
+    ,hasAncestor(functionDecl() )
+    ).bind(gref_bind_name)
+  ;
+}; // mk_global_var_matcher
 // clang-format on
 
 /** \brief Replace use of a global variable with of a
@@ -62,6 +81,8 @@ public:
     assert(old_globals_.size() == new_vars_.size());
   }  // ctor
 
+  llvm::StringRef getID() const override { return "global_variable_replacer"; }
+
   /** Process a variable that matches the criteria. */
   virtual void run(result_t const & result)
   {
@@ -72,15 +93,14 @@ public:
         result.Nodes.getNodeAs<DeclRefExpr>(gref_bind_name);
     if(g_var) {
       string_t const gvar_name = g_var->getNameInfo().getAsString();
-      if(!in_vec(old_globals_, gvar_name)) { return; }
-      uint32_t idx = 0;
-      while(gvar_name != old_globals_[idx]) idx++;
+      target_set::index_t idx(0);
+      if(!old_globals_.find(gvar_name, idx)) { return; }
 
       clang::tooling::Replacement rep = replace_source_range(
           src_manager, g_var->getSourceRange(), new_vars_[idx]);
       if(!dry_run_) {
         auto & reps = find_repls(g_var, src_manager, rep_map_);
-        if(reps.add(rep)) { HERE("add replacement failed"); }
+        add_replacement(reps, rep);
       }
       else {
         llvm::outs() << "global_var_replacer: replacement " << rep.toString()
@@ -103,9 +123,20 @@ public:
     return ms;
   }
 
+  /** Generate one matcher for all the globals, rather than one per global */
+  matchers_t combined_matchers() const
+  {
+    matchers_t ms;
+    if(!old_globals_.empty()) {
+      ms.push_back(
+          mk_global_var_matcher(old_globals_.names(), gref_bind_name));
+    }
+    return ms;
+  }
+
 private:
   replacements_map_t & rep_map_;
-  vec_str const old_globals_;
+  target_set const old_globals_;
   vec_str const new_vars_;
   bool dry_run_;
 };  // class global_variable_replacer
@@ -0,0 +1,93 @@
+// jsonl_writer.cc
+// Oct 17, 2026
+
+#include "jsonl_writer.h"
+
+namespace corct {
+
+void
+write_json_string(std::ostream & o, llvm::StringRef s)
+{
+  static char const hex[] = "0123456789abcdef";
+  o << '"';
+  for(char const c : s) {
+    switch(c) {
+      case '"': o << "\\\""; break;
+      case '\\': o << "\\\\"; break;
+      case '\n': o << "\\n"; break;
+      case '\r': o << "\\r"; break;
+      case '\t': o << "\\t"; break;
+      default:
+        if(static_cast<unsigned char>(c) < 0x20) {
+          o << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        }
+        else {
+          o << c;
+        }
+    }
+  }
+  o << '"';
+  return;
+}  // write_json_string
+
+jsonl_record::jsonl_record(std::ostream & o) : o_(o) { o_ << '{'; }
+
+void
+jsonl_record::key(llvm::StringRef k)
+{
+  if(!first_) { o_ << ','; }
+  first_ = false;
+  write_json_string(o_, k);
+  o_ << ':';
+  return;
+}
+
+jsonl_record &
+jsonl_record::str(llvm::StringRef k, llvm::StringRef val)
+{
+  key(k);
+  write_json_string(o_, val);
+  return *this;
+}
+
+jsonl_record &
+jsonl_record::num(llvm::StringRef k, uint64_t val)
+{
+  key(k);
+  o_ << val;
+  return *this;
+}
+
+jsonl_record &
+jsonl_record::boolean(llvm::StringRef k, bool val)
+{
+  key(k);
+  o_ << (val ? "true" : "false");
+  return *this;
+}
+
+jsonl_record &
+jsonl_record::location(clang::SourceLocation loc,
+                       clang::SourceManager const & sm)
+{
+  clang::PresumedLoc const p(
+      loc.isValid() ? sm.getPresumedLoc(sm.getExpansionLoc(loc))
+                    : clang::PresumedLoc());
+  if(p.isInvalid()) {
+    return str("file", "").num("line", 0).num("col", 0);
+  }
+  return str("file", p.getFilename())
+      .num("line", p.getLine())
+      .num("col", p.getColumn());
+}  // location
+
+void
+jsonl_record::end()
+{
+  o_ << "}\n";
+  return;
+}
+
+}  // namespace corct
+
+// End of file
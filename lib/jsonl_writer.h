@@ -0,0 +1,62 @@
+// jsonl_writer.h
+// Oct 17, 2026
+
+/* JSON Lines output: one JSON object per line, one line per record, so that
+ * consumers can process a report while it is still being written. */
+
+#pragma once
+
+#include "types.h"
+
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+#include <iostream>
+
+namespace corct {
+
+/**\brief How a reporting callback writes its results. */
+enum class output_format {
+  text,  //!< sentences for people
+  jsonl  //!< one JSON object per line, see jsonl_record
+};
+
+/**\brief Write s as a JSON string literal, with quotes and escapes. */
+void
+write_json_string(std::ostream & o, llvm::StringRef s);
+
+/**\brief Writes one record, field by field, as a single-line JSON object.
+ *
+ * Fields appear in the order they are added; end() closes the object and
+ * writes the newline. Each setter has its own name so that a string literal
+ * can't quietly convert to bool.
+ */
+class jsonl_record {
+public:
+  jsonl_record & str(llvm::StringRef key, llvm::StringRef val);
+
+  jsonl_record & num(llvm::StringRef key, uint64_t val);
+
+  jsonl_record & boolean(llvm::StringRef key, bool val);
+
+  /**\brief Add "file", "line", and "col" fields for loc. Macro locations are
+   * reported where the macro was expanded; an invalid location has file ""
+   * and line and col 0. */
+  jsonl_record & location(clang::SourceLocation loc,
+                          clang::SourceManager const & sm);
+
+  void end();
+
+  explicit jsonl_record(std::ostream & o);
+
+private:
+  void key(llvm::StringRef k);
+
+  std::ostream & o_;
+  bool first_ = true;
+};  // jsonl_record
+
+}  // namespace corct
+
+// End of file
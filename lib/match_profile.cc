@@ -0,0 +1,58 @@
+// match_profile.cc
+// Oct 17, 2026
+
+#include "match_profile.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <utility>
+
+namespace corct {
+
+void
+match_profile::add_matcher(str_t_cr id,
+                           double const match_s,
+                           double const callback_s,
+                           uint64_t const n_matches)
+{
+  matcher_row & r(matchers_[id]);
+  r.match_s += match_s;
+  r.callback_s += callback_s;
+  r.n_matches += n_matches;
+  return;
+}
+
+void
+match_profile::write(std::ostream & o) const
+{
+  using m_entry_t = std::pair<string_t, matcher_row>;
+  std::vector<m_entry_t> ms(matchers_.begin(), matchers_.end());
+  std::stable_sort(ms.begin(), ms.end(),
+                   [](m_entry_t const & a, m_entry_t const & b) {
+                     return a.second.match_s > b.second.match_s;
+                   });
+  std::vector<tu_row> ts(tus_);
+  std::stable_sort(ts.begin(), ts.end(),
+                   [](tu_row const & a, tu_row const & b) {
+                     return a.total_s > b.total_s;
+                   });
+  auto const flags = o.flags();
+  o << std::fixed << std::setprecision(6);
+  o << "# matcher\tmatch_s\tcallback_s\tmatches\n";
+  for(auto & m : ms) {
+    o << m.first << "\t" << m.second.match_s << "\t" << m.second.callback_s
+      << "\t" << m.second.n_matches << "\n";
+  }
+  o << "# translation_unit\ttotal_s\tparse_s\tmatch_s\tcallback_s\n";
+  for(auto & t : ts) {
+    o << t.source << "\t" << t.total_s << "\t"
+      << std::max(0.0, t.total_s - t.match_s) << "\t" << t.match_s << "\t"
+      << t.callback_s << "\n";
+  }
+  o.flags(flags);
+  return;
+}  // write
+
+}  // namespace corct
+
+// End of file
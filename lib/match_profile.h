@@ -0,0 +1,154 @@
+// match_profile.h
+// Oct 17, 2026
+
+/* Where does the time go? Per-matcher and per-translation-unit timing for
+ * MatchFinder-based tools. */
+
+#pragma once
+
+#include "types.h"
+
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace corct {
+
+using profile_clock_t = std::chrono::steady_clock;
+
+/**\brief Span from the first callback's onStartOfTranslationUnit to the last
+ * one's onEndOfTranslationUnit, i.e. the MatchFinder's traversal of a TU. */
+struct match_clock {
+  void start()
+  {
+    if(!started_) {
+      start_ = profile_clock_t::now();
+      started_ = true;
+    }
+  }
+
+  void stop() { end_ = profile_clock_t::now(); }
+
+  /**\brief Seconds spent matching; 0 if no traversal happened. */
+  double seconds() const
+  {
+    if(!started_) { return 0.0; }
+    return std::chrono::duration<double>(end_ - start_).count();
+  }
+
+private:
+  bool started_ = false;
+  profile_clock_t::time_point start_;
+  profile_clock_t::time_point end_;
+};  // match_clock
+
+/**\brief Stands in for a callback registered with one matcher, counting and
+ * timing its matches. The id names the matcher in MatchFinder's profiling
+ * records, so MatchFinder's per-id time is this matcher's time. */
+class profiled_callback : public callback_t {
+public:
+  void run(result_t const & result) override
+  {
+    auto const t0 = profile_clock_t::now();
+    cb_->run(result);
+    callback_s_ +=
+        std::chrono::duration<double>(profile_clock_t::now() - t0).count();
+    n_matches_++;
+    return;
+  }
+
+  void onStartOfTranslationUnit() override
+  {
+    clock_.start();
+    if(forward_tu_events_) { cb_->onStartOfTranslationUnit(); }
+    return;
+  }
+
+  void onEndOfTranslationUnit() override
+  {
+    if(forward_tu_events_) { cb_->onEndOfTranslationUnit(); }
+    clock_.stop();
+    return;
+  }
+
+  llvm::StringRef getID() const override { return id_; }
+
+  string_t const & id() const { return id_; }
+
+  double callback_seconds() const { return callback_s_; }
+
+  uint64_t n_matches() const { return n_matches_; }
+
+  /**\param cb: the real callback
+   * \param id: name for this matcher
+   * \param clock: the TU's match clock
+   * \param forward_tu_events: pass TU start/end on to cb; set for only one
+   *   of the proxies of a callback that has several matchers */
+  profiled_callback(callback_t * cb,
+                    str_t_cr id,
+                    match_clock & clock,
+                    bool const forward_tu_events)
+      : cb_(cb), id_(id), clock_(clock), forward_tu_events_(forward_tu_events)
+  {
+  }
+
+private:
+  callback_t * cb_;
+  string_t const id_;
+  match_clock & clock_;
+  bool const forward_tu_events_;
+  double callback_s_ = 0.0;
+  uint64_t n_matches_ = 0;
+};  // profiled_callback
+
+/**\brief Timing tables accumulated over a run.
+ *
+ * For each matcher: time MatchFinder spent on it (matching plus callback),
+ * time in its callback, and number of matches. For each TU: total time, the
+ * part spent parsing (everything but matching), matching, and in callbacks.
+ * write() emits tab-separated tables, largest time first. */
+class match_profile {
+public:
+  struct matcher_row {
+    double match_s = 0.0;     //!< MatchFinder's wall time for the matcher
+    double callback_s = 0.0;  //!< time in the callback
+    uint64_t n_matches = 0;
+  };
+
+  struct tu_row {
+    string_t source;
+    double total_s = 0.0;
+    double match_s = 0.0;
+    double callback_s = 0.0;
+  };
+
+  void add_matcher(str_t_cr id,
+                   double const match_s,
+                   double const callback_s,
+                   uint64_t const n_matches);
+
+  void add_tu(tu_row const & tu) { tus_.push_back(tu); }
+
+  void write(std::ostream & o) const;
+
+  void clear()
+  {
+    matchers_.clear();
+    tus_.clear();
+  }
+
+  std::map<string_t, matcher_row> const & matchers() const { return matchers_; }
+
+  std::vector<tu_row> const & tus() const { return tus_; }
+
+private:
+  std::map<string_t, matcher_row> matchers_;
+  std::vector<tu_row> tus_;
+};  // match_profile
+
+}  // namespace corct
+
+// End of file
@@ -71,6 +71,8 @@ public:
         sm, {mexpr->getBeginLoc(), mexpr->getEndLoc()}, repl_str.str());
   }  // mk_repl
 
+  llvm::StringRef getID() const override { return "member_ref_replacer"; }
+
   void run(const result_t & result) override
   {
     using namespace clang;
@@ -0,0 +1,481 @@
+// parallel_tool.cc
+// Oct 17, 2026
+
+#include "parallel_tool.h"
+#include "dump_things.h"
+#include "pch_support.h"
+#include "result_cache.h"
+#include "tu_schedule.h"
+
+#include "clang/Frontend/PCHContainerOperations.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <system_error>
+#include <thread>
+
+namespace corct {
+
+namespace {
+finder_t::MatchFinderOptions
+mk_finder_options(bool const profiling,
+                  llvm::StringMap<llvm::TimeRecord> & records)
+{
+  finder_t::MatchFinderOptions opts;
+  if(profiling) { opts.CheckProfiling.emplace(records); }
+  return opts;
+}
+}  // namespace
+
+tu_context::tu_context(parallel_tool const & ptool,
+                       uint32_t const worker_,
+                       size_t const index_,
+                       std::ostream & out_)
+    : worker(worker_),
+      index(index_),
+      run_index(ptool.run_indices_.empty() ? index_
+                                           : ptool.run_indices_[index_]),
+      source(ptool.sources_[index_]),
+      out(out_),
+      ptool_(ptool),
+      finder_(mk_finder_options(nullptr != ptool.profile_out_, match_times_))
+{
+}
+
+callback_t *
+tu_context::profiled(callback_t * cb)
+{
+  if(!ptool_.profile_out_) { return cb; }
+  llvm::StringRef const cb_id(cb->getID());
+  string_t const name =
+      cb_id == "<unknown>" ? string_t("callback") : cb_id.str();
+  // numbered by name, not by callback: callbacks may share a getID()
+  string_t const id = name + "#" + std::to_string(n_per_name_[name]++);
+  bool const first_for_cb = tu_event_cbs_.insert(cb).second;
+  proxies_.emplace_back(
+      std::make_unique<profiled_callback>(cb, id, clock_, first_for_cb));
+  return proxies_.back().get();
+}  // profiled
+
+int
+tu_context::run()
+{
+  return run(clang::tooling::newFrontendActionFactory(&finder_).get());
+}
+
+int
+tu_context::run(clang::tooling::FrontendActionFactory * factory)
+{
+  return run_tool(factory, true);
+}
+
+string_t
+tu_context::content_key(str_t_cr salt)
+{
+  input_hasher hasher;
+  hasher.add(salt);
+  if(is_ast_file(source)) {
+    // everything the AST depends on is already in it
+    auto buf = llvm::MemoryBuffer::getFile(source);
+    if(!buf) { return ""; }
+    hasher.add((*buf)->getBuffer());
+    return hasher.digest();
+  }
+  for(auto & arg : ptool_.command_line(source)) { hasher.add(arg); }
+  /* Hash without the PCH, so that the headers behind it are hashed too. */
+  if(0 != run_tool(&hasher, false)) { return ""; }
+  return hasher.digest();
+}  // content_key
+
+string_t
+tu_context::working_directory() const
+{
+  if(is_ast_file(source)) { return ""; }
+  auto const cmds = ptool_.comps_.getCompileCommands(source);
+  return cmds.empty() ? "" : cmds[0].Directory;
+}  // working_directory
+
+int
+tu_context::run_tool(clang::tooling::FrontendActionFactory * factory,
+                     bool const with_pch)
+{
+  using namespace clang::tooling;
+  /* Each TU gets its own physical file system so that concurrent tools can
+   * have different working directories; the default real file system
+   * changes the working directory of the whole process. */
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> fs(
+      llvm::vfs::createPhysicalFileSystem().release());
+  /* An AST file carries its own compiler options: the driver recognizes the
+   * .ast extension and the frontend deserializes the AST instead of parsing,
+   * so no compile command or adjusters are needed. */
+  bool const ast_input = is_ast_file(source);
+  FixedCompilationDatabase const no_flags(".", vec_str{});
+  CompilationDatabase const & comps(
+      ast_input ? static_cast<CompilationDatabase const &>(no_flags)
+                : ptool_.comps_);
+  ClangTool tool(comps, {source},
+                 std::make_shared<clang::PCHContainerOperations>(), fs);
+  if(!ast_input) {
+    for(auto & adj : ptool_.adjusters_) { tool.appendArgumentsAdjuster(adj); }
+    if(with_pch && ptool_.pch_ready_) {
+      tool.appendArgumentsAdjuster(
+          mk_include_pch_adjuster(ptool_.pch_path_));
+    }
+  }
+  for(auto & f : ptool_.virtual_files_) {
+    tool.mapVirtualFile(f.first, f.second);
+  }
+  return tool.run(factory);
+}  // tu_context::run_tool
+
+parallel_tool::parallel_tool(compilations_t const & comps,
+                             vec_str const & sources,
+                             uint32_t const n_jobs)
+    : comps_(comps), sources_(sources), n_jobs_(n_jobs)
+{
+  if(0 == n_jobs_) {
+    n_jobs_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+void
+parallel_tool::append_arguments_adjuster(adjuster_t adj)
+{
+  adjusters_.push_back(std::move(adj));
+}
+
+void
+parallel_tool::map_virtual_file(str_t_cr path, str_t_cr content)
+{
+  virtual_files_.emplace_back(path, content);
+}
+
+bool
+is_ast_file(str_t_cr path)
+{
+  return llvm::sys::path::extension(path) == ".ast";
+}
+
+vec_str
+expand_ast_dirs(vec_str const & paths)
+{
+  vec_str expanded;
+  for(auto & p : paths) {
+    if(!llvm::sys::fs::is_directory(p)) {
+      expanded.push_back(p);
+      continue;
+    }
+    vec_str asts;
+    std::error_code ec;
+    for(llvm::sys::fs::recursive_directory_iterator it(p, ec), end;
+        it != end && !ec; it.increment(ec)) {
+      if(is_ast_file(it->path())) { asts.push_back(it->path()); }
+    }
+    if(ec) {
+      std::cerr << "expand_ast_dirs: error reading " << p << ": "
+                << ec.message() << "\n";
+    }
+    // directory order is arbitrary; keep runs reproducible
+    std::sort(asts.begin(), asts.end());
+    expanded.insert(expanded.end(), asts.begin(), asts.end());
+  }
+  return expanded;
+}  // expand_ast_dirs
+
+void
+parallel_tool::use_pch(str_t_cr header, str_t_cr pch_path)
+{
+  // TUs may run in other directories, so pin down relative paths
+  llvm::SmallString<256> h(header), p(pch_path);
+  llvm::sys::fs::make_absolute(h);
+  llvm::sys::fs::make_absolute(p);
+  pch_header_ = h.str().str();
+  pch_path_ = p.str().str();
+  pch_ready_ = false;
+  return;
+}
+
+void
+parallel_tool::prepare_pch()
+{
+  if(pch_header_.empty() || pch_ready_ || sources_.empty() ||
+     is_ast_file(sources_[0])) {
+    return;
+  }
+  if(pch_is_current(pch_header_, pch_path_)) {
+    pch_ready_ = true;
+    return;
+  }
+  pch_ready_ = build_pch(comps_, sources_[0], pch_header_, pch_path_,
+                         adjusters_);
+  if(!pch_ready_) {
+    std::cerr << "parallel_tool: continuing without precompiled header\n";
+  }
+  return;
+}  // prepare_pch
+
+void
+parallel_tool::enable_profiling(std::ostream & o)
+{
+  profile_out_ = &o;
+  return;
+}
+
+void
+parallel_tool::use_cache(str_t_cr dir)
+{
+  cache_dir_ = dir;
+  return;
+}
+
+void
+parallel_tool::add_cache_salt(str_t_cr salt)
+{
+  cache_salt_ += salt;
+  cache_salt_ += '\n';
+  return;
+}
+
+void
+parallel_tool::use_cost_file(str_t_cr path)
+{
+  cost_path_ = path;
+  return;
+}
+
+double
+parallel_tool::estimate_cost(str_t_cr source) const
+{
+  for(auto & f : virtual_files_) {
+    if(f.first == source) { return estimate_source_cost(f.second); }
+  }
+  if(is_ast_file(source)) {
+    uint64_t size(0);
+    llvm::sys::fs::file_size(source, size);
+    return static_cast<double>(size);
+  }
+  auto buf = llvm::MemoryBuffer::getFile(source);
+  return buf ? estimate_source_cost((*buf)->getBuffer()) : 0.0;
+}  // estimate_cost
+
+std::vector<size_t>
+parallel_tool::schedule() const
+{
+  tu_costs recorded;
+  if(!cost_path_.empty() && !recorded.load(cost_path_)) {
+    std::cerr << "parallel_tool: ignoring malformed lines in " << cost_path_
+              << "\n";
+  }
+  return largest_first(sources_, recorded, [this](str_t_cr source) {
+    return estimate_cost(source);
+  });
+}  // schedule
+
+void
+parallel_tool::use_journal(str_t_cr dir, bool const resume)
+{
+  journal_dir_ = dir;
+  resume_ = resume;
+  return;
+}
+
+void
+parallel_tool::set_run_indices(std::vector<size_t> const & indices)
+{
+  if(indices.size() == sources_.size()) { run_indices_ = indices; }
+  return;
+}
+
+string_t
+parallel_tool::journal_key(str_t_cr source) const
+{
+  // The journal trusts that sources are unchanged since the interrupted
+  // run, so the key is just what identifies this TU in this run.
+  input_hasher h;
+  h.add("journal");
+  h.add(std::to_string(n_runs_));
+  h.add(cache_salt_);
+  h.add(source);
+  for(auto & arg : command_line(source)) { h.add(arg); }
+  return h.digest();
+}  // journal_key
+
+clang::tooling::CommandLineArguments
+parallel_tool::command_line(str_t_cr source) const
+{
+  using namespace clang::tooling;
+  CommandLineArguments args;
+  for(auto & cmd : comps_.getCompileCommands(source)) {
+    CommandLineArguments cmd_args(cmd.CommandLine);
+    cmd_args = getClangStripOutputAdjuster()(cmd_args, cmd.Filename);
+    cmd_args = getClangStripDependencyFileAdjuster()(cmd_args, cmd.Filename);
+    for(auto & adj : adjusters_) { cmd_args = adj(cmd_args, cmd.Filename); }
+    args.push_back(cmd.Directory);
+    args.insert(args.end(), cmd_args.begin(), cmd_args.end());
+  }
+  return args;
+}  // command_line
+
+int
+parallel_tool::run(action_t const & action, std::ostream & o)
+{
+  return run(action, replay_t(), o);
+}
+
+int
+parallel_tool::run(action_t const & action,
+                   replay_t const & replay,
+                   std::ostream & o)
+{
+  prepare_pch();
+  cache_hits_ = 0;
+  n_resumed_ = 0;
+  profile_.clear();
+  std::unique_ptr<result_cache const> cache;
+  if(has_cache() && replay) { cache.reset(new result_cache(cache_dir_)); }
+  // every run() gets its own journal keys, and only the first truncates it
+  std::unique_ptr<run_journal> journal;
+  if(has_journal()) {
+    journal.reset(new run_journal(journal_dir_, resume_ || n_runs_ > 0));
+  }
+  size_t const n_tus = sources_.size();
+  uint32_t const n_workers = static_cast<uint32_t>(
+      std::max<size_t>(1, std::min<size_t>(n_jobs_, n_tus)));
+  /* Start order only changes the wall time with several workers; a single
+   * one works in source order, so each output is written as soon as the TU
+   * is done. */
+  std::vector<size_t> order(n_tus);
+  std::iota(order.begin(), order.end(), 0);
+  if(n_workers > 1) { order = schedule(); }
+  // Per-TU results; the output buffers are released as soon as they're written
+  std::vector<string_t> outputs(n_tus);
+  std::vector<bool> done(n_tus, false);
+  std::vector<int> statuses(n_tus, 0);
+  std::vector<double> parse_times(n_tus, -1.0);  // for the cost file
+  size_t next_out(0);
+  std::atomic<size_t> next_tu(0);
+  std::mutex out_mutex;
+
+  auto work = [&](uint32_t const worker) {
+    for(size_t k = next_tu++; k < n_tus; k = next_tu++) {
+      size_t const i = order[k];
+      std::stringstream s;
+      tu_context tu(*this, worker, i, s);
+      // source locations are abbreviated relative to the last one printed
+      clearLocation();
+      auto const t_start = profile_clock_t::now();
+      int status(0);
+      bool hit(false), resumed(false);
+      string_t const j_key = journal ? journal_key(tu.source) : "";
+      string_t c_out, c_data;
+      if(journal && journal->load(j_key, c_out, c_data)) {
+        s << c_out;
+        if(replay) {
+          std::istringstream d(c_data);
+          replay(tu, d);
+        }
+        resumed = true;
+      }
+      else {
+        string_t const key = cache ? tu.content_key(cache_salt_) : "";
+        if(!key.empty() && cache->load(key, c_out, c_data)) {
+          s << c_out;
+          if(replay) {
+            std::istringstream d(c_data);
+            replay(tu, d);
+          }
+          hit = true;
+        }
+        else {
+          status = action(tu);
+          c_data = tu.data_.str();
+          if(!key.empty() && 0 == status) {
+            cache->store(key, s.str(), c_data);
+          }
+        }
+        if(journal && 0 == status &&
+           !journal->record(j_key, tu.source, s.str(), c_data)) {
+          std::cerr << "parallel_tool: could not record " << tu.source
+                    << " in the journal\n";
+        }
+      }
+      double const t_total = std::chrono::duration<double>(
+                                 profile_clock_t::now() - t_start)
+                                 .count();
+      std::lock_guard<std::mutex> lock(out_mutex);
+      if(hit) { cache_hits_++; }
+      if(resumed) { n_resumed_++; }
+      if(!hit && !resumed && 0 == status) { parse_times[i] = t_total; }
+      if(profile_out_) { record_profile(tu, t_total); }
+      statuses[i] = status;
+      outputs[i] = s.str();
+      done[i] = true;
+      // write out every TU that is now ready, in order
+      while(next_out < n_tus && done[next_out]) {
+        o << outputs[next_out];
+        string_t().swap(outputs[next_out]);
+        next_out++;
+      }
+      o.flush();
+    }
+    return;
+  };
+
+  if(1 == n_workers) { work(0); }
+  else {
+    std::vector<std::thread> workers;
+    for(uint32_t w = 0; w < n_workers; ++w) { workers.emplace_back(work, w); }
+    for(auto & t : workers) { t.join(); }
+  }
+  if(profile_out_) { profile_.write(*profile_out_); }
+  if(!cost_path_.empty()) {
+    // reload, to keep what other processes (e.g. shards) recorded meanwhile
+    tu_costs costs;
+    costs.load(cost_path_);
+    for(size_t i = 0; i < n_tus; ++i) {
+      if(parse_times[i] >= 0) { costs.set(sources_[i], parse_times[i]); }
+    }
+    if(!costs.save(cost_path_)) {
+      std::cerr << "parallel_tool: could not write " << cost_path_ << "\n";
+    }
+  }
+  n_runs_++;
+  auto has_status = [&statuses](int const s) {
+    return statuses.end() != std::find(statuses.begin(), statuses.end(), s);
+  };
+  bool const any_failed = has_status(1);
+  bool const any_skipped = has_status(2);
+  return any_failed ? 1 : (any_skipped ? 2 : 0);
+}  // parallel_tool::run
+
+void
+parallel_tool::record_profile(tu_context const & tu, double const total_s)
+{
+  match_profile::tu_row row;
+  row.source = tu.source;
+  row.total_s = total_s;
+  row.match_s = tu.clock_.seconds();
+  for(auto & p : tu.proxies_) {
+    auto rec = tu.match_times_.find(p->id());
+    double const match_s =
+        rec == tu.match_times_.end() ? 0.0 : rec->second.getWallTime();
+    profile_.add_matcher(p->id(), match_s, p->callback_seconds(),
+                         p->n_matches());
+    row.callback_s += p->callback_seconds();
+  }
+  profile_.add_tu(row);
+  return;
+}  // record_profile
+
+}  // namespace corct
+
+// End of file
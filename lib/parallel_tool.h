@@ -0,0 +1,279 @@
+// parallel_tool.h
+// Oct 17, 2026
+
+/* Run a MatchFinder-based analysis over many translation units on several
+ * threads. Each translation unit is parsed by its own ClangTool, with its own
+ * MatchFinder, so callbacks only have to avoid sharing state between workers.
+ */
+
+#pragma once
+
+#include "match_profile.h"
+#include "types.h"
+
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Tooling/ArgumentsAdjusters.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Timer.h"
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace corct {
+
+class parallel_tool;
+
+/**\brief Is path a serialized AST (clang -emit-ast output)? */
+bool
+is_ast_file(str_t_cr path);
+
+/**\brief Replace each directory in paths with the .ast files under it,
+ * sorted by path. Other paths are passed through unchanged. */
+vec_str
+expand_ast_dirs(vec_str const & paths);
+
+/**\brief Handle for one translation unit, handed to a parallel_tool action.
+ *
+ * Register matchers with add_matcher, then call run(). Anything written to
+ * 'out' is buffered and copied to the parallel_tool's output stream in source
+ * order, no matter which worker finishes first. When the parallel_tool has a
+ * result cache or a journal, an action can also write a serialized form of
+ * its per-TU results to data(); see parallel_tool::run(action, replay, o).
+ */
+class tu_context {
+public:
+  /**\brief Register a matcher with this TU's MatchFinder. When profiling,
+   * the matcher is timed under the name "<cb->getID()>#<n>", where n counts
+   * the matchers registered in this TU with callbacks of that name. */
+  template <typename Matcher_t>
+  void add_matcher(Matcher_t const & m, callback_t * cb)
+  {
+    finder_.addMatcher(m, profiled(cb));
+  }
+
+  /**\brief Parse this TU and run the registered matchers over it.
+   * \return ClangTool::run status */
+  int run();
+
+  /**\brief Parse this TU and run an arbitrary frontend action over it.
+   * \return ClangTool::run status */
+  int run(clang::tooling::FrontendActionFactory * factory);
+
+  finder_t & finder() { return finder_; }
+
+  /**\brief Stream for this TU's serialized results, which are cached along
+   * with its output. */
+  std::ostream & data() { return data_; }
+
+  /**\brief Hash of this TU's command line, every file it reads, and 'salt'.
+   * Runs the preprocessor, so it costs a fraction of a full parse.
+   * \return hex digest, or "" if the TU could not be preprocessed */
+  string_t content_key(str_t_cr salt);
+
+  /**\brief Directory this TU is compiled in, from its compile command;
+   * relative file names in its diagnostics and edits are taken from here.
+   * \return "" (the current directory) for .ast files, or if there is no
+   * compile command */
+  string_t working_directory() const;
+
+  tu_context(parallel_tool const & ptool,
+             uint32_t const worker,
+             size_t const index,
+             std::ostream & out);
+
+  uint32_t const worker;   //!< worker thread running this TU, in [0, n_jobs)
+  size_t const index;      //!< index of this TU in the source list
+  size_t const run_index;  //!< index in the whole run, across shards
+  string_t const & source; //!< path of the main source file
+  std::ostream & out;      //!< buffered output for this TU
+
+private:
+  friend class parallel_tool;
+
+  int run_tool(clang::tooling::FrontendActionFactory * factory,
+               bool const with_pch);
+
+  /**\brief cb, or a profiling stand-in for it if the tool is profiling. */
+  callback_t * profiled(callback_t * cb);
+
+  parallel_tool const & ptool_;
+  llvm::StringMap<llvm::TimeRecord> match_times_;  // MatchFinder profiling
+  finder_t finder_;
+  std::stringstream data_;
+  match_clock clock_;
+  std::vector<std::unique_ptr<profiled_callback>> proxies_;
+  std::map<string_t, uint32_t> n_per_name_;  // matchers per callback name
+  std::set<callback_t *> tu_event_cbs_;  // callbacks that get TU events
+};  // tu_context
+
+/**\brief Spread the sources of a compilation database over worker threads.
+ *
+ * Sources may also be .ast files (clang -emit-ast output). Those are
+ * deserialized rather than parsed, with the options recorded in the file;
+ * they don't need compile commands, and adjusters and PCH are not applied.
+ *
+ * The action is called once per source file, from one of n_jobs worker
+ * threads. The worker index in the tu_context is stable for the lifetime of a
+ * thread, so an app can keep one callback instance (and one accumulator) per
+ * worker, then merge them in worker order when run() returns.
+ *
+ * With more than one worker, TUs are started most expensive first (see
+ * largest_first), and each worker takes the next TU from the shared order as
+ * soon as it is free. A TU's cost is its run time recorded in the cost file
+ * (see use_cost_file), or else an estimate from its main file's size and
+ * number of #includes. Outputs are still written in source order.
+ */
+class parallel_tool {
+public:
+  using action_t = std::function<int(tu_context &)>;
+  using replay_t = std::function<void(tu_context &, std::istream &)>;
+  using compilations_t = clang::tooling::CompilationDatabase;
+  using adjuster_t = clang::tooling::ArgumentsAdjuster;
+
+  /**\brief Process every source; write TU outputs to o in source order.
+   * \return 1 if any TU failed, 2 if any were skipped, 0 otherwise (same
+   * convention as ClangTool::run) */
+  int run(action_t const & action, std::ostream & o = std::cout);
+
+  /**\brief Process every source, reusing cached results where possible.
+   *
+   * Without a cache (see use_cache) this is run(action, o). With one, each
+   * TU's content key is computed first. On a hit, the cached output is
+   * copied to the TU's output and replay(tu, data) is called with the data
+   * the action wrote on the earlier run, instead of calling the action. On a
+   * miss, the action runs, and if it succeeds its output and data() are
+   * stored under the key.
+   *
+   * With a journal (see use_journal), every TU that succeeds is recorded,
+   * and TUs recorded by an interrupted run are not processed again: their
+   * output is copied and replay is called with their data, as for a cache
+   * hit. run(action, o) has no replay, so it only restores output; actions
+   * that also accumulate results should use this overload. */
+  int run(action_t const & action,
+          replay_t const & replay,
+          std::ostream & o = std::cout);
+
+  /**\brief Append an adjuster to every TU's command line. */
+  void append_arguments_adjuster(adjuster_t adj);
+
+  /**\brief Provide in-memory contents for a file, as ClangTool does. */
+  void map_virtual_file(str_t_cr path, str_t_cr content);
+
+  /**\brief Precompile 'header', which every source includes, and have each
+   * TU load the PCH instead of parsing the header again.
+   *
+   * The PCH is written to pch_path when run() starts, using the first
+   * source's compile command and this tool's adjusters; an existing PCH that
+   * is newer than the header is reused. TUs must be compiled with the same
+   * flags as the first source. If the PCH can't be built, TUs are parsed
+   * without it. */
+  void use_pch(str_t_cr header, str_t_cr pch_path);
+
+  /**\brief Time every matcher and TU; when run() finishes, write the tables
+   * (see match_profile) to o. */
+  void enable_profiling(std::ostream & o = std::cerr);
+
+  /**\brief Profile of the last run(), if profiling was enabled. */
+  match_profile const & profile() const { return profile_; }
+
+  /**\brief Schedule TUs by the run times recorded in 'path' by earlier
+   * runs, and record the time of every TU that this run parses there. */
+  void use_cost_file(str_t_cr path);
+
+  /**\brief Indices of the sources, in the order TUs will be started. */
+  std::vector<size_t> schedule() const;
+
+  /**\brief Keep per-TU results in directory 'dir' between runs. */
+  void use_cache(str_t_cr dir);
+
+  /**\brief Add settings that change results, e.g. target names, to every
+   * TU's cache key. Call once for each such setting. */
+  void add_cache_salt(str_t_cr salt);
+
+  bool has_cache() const { return !cache_dir_.empty(); }
+
+  /**\brief Record each completed TU, and its results, in directory 'dir'.
+   * With resume, skip the TUs an earlier run over the same sources, with the
+   * same settings, recorded there, and use the results it stored. */
+  void use_journal(str_t_cr dir, bool const resume);
+
+  bool has_journal() const { return !journal_dir_.empty(); }
+
+  /**\brief When the sources are one shard of a larger run (see
+   * shard_sources), give each its index in the whole run, so that per-TU
+   * files named by index (e.g. export_fixes) are unique across shards.
+   * Without this, a TU's run_index is its index. */
+  void set_run_indices(std::vector<size_t> const & indices);
+
+  /**\brief Should actions write their per-TU results to tu.data()? True if
+   * the results may be stored, in a cache or a journal. */
+  bool keeps_tu_data() const { return has_cache() || has_journal(); }
+
+  /**\brief Number of TUs whose results came from the cache in the last run.
+   */
+  size_t cache_hits() const { return cache_hits_; }
+
+  /**\brief Number of TUs in the last run that an earlier, interrupted run
+   * had completed. */
+  size_t n_resumed() const { return n_resumed_; }
+
+  uint32_t n_jobs() const { return n_jobs_; }
+
+  vec_str const & sources() const { return sources_; }
+
+  /**\param comps: compilation database
+   * \param sources: source files to process
+   * \param n_jobs: number of worker threads; 0 means one per core */
+  parallel_tool(compilations_t const & comps,
+                vec_str const & sources,
+                uint32_t const n_jobs = 1);
+
+private:
+  friend class tu_context;
+
+  compilations_t const & comps_;
+  vec_str const sources_;
+  uint32_t n_jobs_;
+  std::vector<adjuster_t> adjusters_;
+  std::vector<std::pair<string_t, string_t>> virtual_files_;
+  string_t pch_header_;
+  string_t pch_path_;
+  bool pch_ready_ = false;
+  string_t cache_dir_;
+  string_t cache_salt_;
+  size_t cache_hits_ = 0;
+  string_t cost_path_;
+  string_t journal_dir_;
+  bool resume_ = false;
+  size_t n_resumed_ = 0;
+  uint32_t n_runs_ = 0;  // run() calls so far: part of each journal key
+  std::vector<size_t> run_indices_;  // empty: run_index is index
+  std::ostream * profile_out_ = nullptr;  // non-null when profiling
+  match_profile profile_;
+
+  /**\brief Build or validate the PCH, if one was requested. */
+  void prepare_pch();
+
+  /**\brief Add a finished TU's timings to profile_. */
+  void record_profile(tu_context const & tu, double const total_s);
+
+  /**\brief Estimated cost of source (see estimate_source_cost). */
+  double estimate_cost(str_t_cr source) const;
+
+  /**\brief Journal key for source in the current run. */
+  string_t journal_key(str_t_cr source) const;
+
+  /**\brief Command line for source, as ClangTool would run it. */
+  clang::tooling::CommandLineArguments command_line(str_t_cr source) const;
+};  // parallel_tool
+
+}  // namespace corct
+
+// End of file
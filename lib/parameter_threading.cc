@@ -0,0 +1,94 @@
+// parameter_threading.cc
+// Oct 17, 2026
+
+#include "parameter_threading.h"
+
+#include "call_graph_builder.h"
+#include "utilities.h"
+
+#include <set>
+
+namespace corct {
+
+namespace {
+string_t const gref_bd_name = "globalReference";
+string_t const fn_bd_name = "function";
+}  // namespace
+
+global_user_finder::matcher_t
+global_user_finder::matcher(vec_str const & g_vars)
+{
+  using namespace clang::ast_matchers;
+  return declRefExpr(
+             to(varDecl(hasGlobalStorage(),
+                        hasAnyName(as_string_refs(g_vars)))),
+             hasAncestor(functionDecl(isDefinition()).bind(fn_bd_name)))
+      .bind(gref_bd_name);
+}  // matcher
+
+void
+global_user_finder::run(result_t const & result)
+{
+  using namespace clang;
+  FunctionDecl const * f = result.Nodes.getNodeAs<FunctionDecl>(fn_bd_name);
+  if(!f) {
+    check_ptr(f, "function");
+    return;
+  }
+  // USRs are not cheap; one use per function is enough
+  if(seen_.insert(f).second) {
+    users_.emplace(function_usr(f), f->getQualifiedNameAsString());
+  }
+  return;
+}  // run
+
+void
+global_user_finder::write(std::ostream & o) const
+{
+  for(auto & u : users_) { o << u.first << "\t" << u.second << "\n"; }
+  return;
+}  // write
+
+bool
+global_user_finder::read(std::istream & i)
+{
+  string_t line;
+  while(std::getline(i, line)) {
+    vec_str const fs(split(line, '\t'));
+    if(fs.size() != 2) {
+      std::cerr << "global_user_finder::read: malformed line '" << line
+                << "'\n";
+      return false;
+    }
+    users_.emplace(fs[0], fs[1]);
+  }
+  return true;
+}  // read
+
+vec_str
+threading_targets(call_graph_file const & g,
+                  global_user_finder::users_t const & users,
+                  vec_str const & entries)
+{
+  std::set<string_t> const entry_set(entries.begin(), entries.end());
+  call_graph_file::nodes_t roots, stops;
+  std::set<string_t> targets;
+  for(auto & u : users) {
+    call_graph_file::node_t n(0);
+    if(g.find(u.first, n)) { roots.push_back(n); }
+    if(entry_set.count(u.second) == 0) { targets.insert(u.second); }
+  }
+  for(auto & e : entries) {
+    call_graph_file::nodes_t const ns(g.find_name(e));
+    stops.insert(stops.end(), ns.begin(), ns.end());
+  }
+  for(auto n : g.transitive_callers(roots, stops)) {
+    string_t const nm(g.name(n).str());
+    if(entry_set.count(nm) == 0) { targets.insert(nm); }
+  }
+  return vec_str(targets.begin(), targets.end());
+}  // threading_targets
+
+}  // namespace corct
+
+// End of file
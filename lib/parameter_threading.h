@@ -0,0 +1,77 @@
+// parameter_threading.h
+// Oct 17, 2026
+
+/* Work out which functions must take a new parameter so that a global can be
+ * replaced by a local: the functions that use the global, and every function
+ * that calls one of those, directly or not, up to the entry points. */
+
+#pragma once
+
+#include "call_graph_file.h"
+#include "types.h"
+
+#include "clang/AST/Decl.h"
+#include "clang/ASTMatchers/ASTMatchers.h"
+#include <iostream>
+#include <map>
+#include <unordered_set>
+
+namespace corct {
+
+/**\brief Find the function definitions that refer to any of a list of
+ * globals. Functions are recorded by USR (see call_graph_builder), with their
+ * qualified names.
+ *
+ * Give each worker its own finder, then merge(). Finders can be written to a
+ * stream and read back, e.g. for a result cache.
+ */
+class global_user_finder : public callback_t {
+public:
+  using matcher_t = clang::ast_matchers::StatementMatcher;
+  using users_t = std::map<string_t, string_t>;  // USR -> qualified name
+
+  /**\brief Matches each reference, within a function definition, to a
+   * global variable named in g_vars. */
+  static matcher_t matcher(vec_str const & g_vars);
+
+  llvm::StringRef getID() const override { return "global_user_finder"; }
+
+  void run(result_t const & result) override;
+
+  /**\brief AST addresses are reused between TUs, so forget them. */
+  void onEndOfTranslationUnit() override { seen_.clear(); }
+
+  void merge(global_user_finder const & other)
+  {
+    users_.insert(other.users_.begin(), other.users_.end());
+  }
+
+  /**\brief Write one 'USR <tab> name' line per function. */
+  void write(std::ostream & o) const;
+
+  /**\brief Read what write() wrote, merging it into this finder.
+   * \return false if a malformed line was encountered */
+  bool read(std::istream & i);
+
+  users_t const & users() const { return users_; }
+
+private:
+  users_t users_;
+  std::unordered_set<clang::FunctionDecl const *> seen_;
+};  // global_user_finder
+
+/**\brief Qualified names of the functions that need the new parameter: the
+ * users, and their transitive callers in g. The search does not go past a
+ * function named in entries, and entry functions are not in the result: they
+ * are where the new local variable is declared. Users missing from g (say,
+ * functions that make no calls and are not called) are still included.
+ * Sorted, without repeats.
+ */
+vec_str
+threading_targets(call_graph_file const & g,
+                  global_user_finder::users_t const & users,
+                  vec_str const & entries);
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,178 @@
+// pch_support.cc
+// Oct 17, 2026
+
+#include "pch_support.h"
+
+#include "clang/Basic/FileManager.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "clang/Frontend/PCHContainerOperations.h"
+#include "clang/Serialization/ASTReader.h"
+#include "clang/Tooling/Tooling.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include <memory>
+
+namespace corct {
+
+namespace {
+/* GeneratePCHAction, writing to a given path rather than to whatever the
+ * compile command's -o said. */
+class generate_pch_to : public clang::GeneratePCHAction {
+public:
+  explicit generate_pch_to(str_t_cr pch_path) : pch_path_(pch_path) {}
+
+protected:
+  bool BeginInvocation(clang::CompilerInstance & ci) override
+  {
+    ci.getFrontendOpts().OutputFile = pch_path_;
+    return clang::GeneratePCHAction::BeginInvocation(ci);
+  }
+
+private:
+  string_t const pch_path_;
+};  // generate_pch_to
+
+/* Collects the input files recorded in an AST file's control block. */
+class input_file_lister : public clang::ASTReaderListener {
+public:
+  bool needsInputFileVisitation() override { return true; }
+
+  bool needsSystemInputFileVisitation() override { return true; }
+
+  bool visitInputFile(llvm::StringRef filename,
+                      bool /*is_system*/,
+                      bool is_overridden,
+                      bool /*is_explicit_module*/) override
+  {
+    // overridden files were mapped in memory, not read from disk
+    if(!is_overridden) { inputs.push_back(filename.str()); }
+    return true;
+  }
+
+  vec_str inputs;
+};  // input_file_lister
+
+/* -x value for the header form of a language, or "" if it has none. */
+string_t
+header_language(llvm::StringRef lang)
+{
+  if(lang.endswith("-header")) { return lang.str(); }
+  if(lang == "c" || lang == "c++" || lang == "objective-c" ||
+     lang == "objective-c++") {
+    return lang.str() + "-header";
+  }
+  return "";
+}
+}  // namespace
+
+bool
+pch_is_current(str_t_cr header, str_t_cr pch_path)
+{
+  llvm::sys::fs::file_status h_stat, p_stat;
+  if(llvm::sys::fs::status(header, h_stat) ||
+     llvm::sys::fs::status(pch_path, p_stat)) {
+    return false;
+  }
+  auto const built = p_stat.getLastModificationTime();
+  if(built < h_stat.getLastModificationTime()) { return false; }
+  // the PCH records what it was built from: headers the header includes too
+  input_file_lister lister;
+  clang::FileManager files{clang::FileSystemOptions()};
+  clang::PCHContainerOperations ops;
+  if(clang::ASTReader::readASTFileControlBlock(
+         pch_path, files, ops.getRawReader(), false, lister, false)) {
+    return false;
+  }
+  for(auto & in : lister.inputs) {
+    llvm::sys::fs::file_status i_stat;
+    if(llvm::sys::fs::status(in, i_stat) ||
+       built < i_stat.getLastModificationTime()) {
+      return false;
+    }
+  }
+  return true;
+}  // pch_is_current
+
+string_t
+pch_language(clang::tooling::CommandLineArguments const & args,
+             str_t_cr source)
+{
+  // the last -x before the source applies to it
+  string_t lang;
+  for(size_t i = 0; i < args.size() && args[i] != source; ++i) {
+    llvm::StringRef const a(args[i]);
+    if(a == "-x" && i + 1 < args.size()) {
+      lang = header_language(args[++i]);
+    }
+    else if(a.startswith("-x") && a.size() > 2) {
+      lang = header_language(a.substr(2));
+    }
+  }
+  if(!lang.empty()) { return lang; }
+  llvm::StringRef const ext(llvm::sys::path::extension(source));
+  if(ext == ".c") { return "c-header"; }
+  if(ext == ".m") { return "objective-c-header"; }
+  if(ext == ".mm" || ext == ".M") { return "objective-c++-header"; }
+  return "c++-header";
+}  // pch_language
+
+bool
+build_pch(clang::tooling::CompilationDatabase const & comps,
+          str_t_cr source,
+          str_t_cr header,
+          str_t_cr pch_path,
+          std::vector<clang::tooling::ArgumentsAdjuster> const & adjusters,
+          std::ostream & errs)
+{
+  using namespace clang::tooling;
+  std::vector<CompileCommand> cmds(comps.getCompileCommands(source));
+  if(cmds.empty()) {
+    errs << "build_pch: no compile command for " << source << "\n";
+    return false;
+  }
+  CompileCommand const & cmd(cmds.front());
+  // Same adjustments that ClangTool makes, plus the tool's own
+  CommandLineArguments args(cmd.CommandLine);
+  args = getClangStripOutputAdjuster()(args, cmd.Filename);
+  args = getClangStripDependencyFileAdjuster()(args, cmd.Filename);
+  for(auto & adj : adjusters) { args = adj(args, cmd.Filename); }
+  // compile the header in place of the source
+  CommandLineArguments pch_args;
+  for(auto & a : args) {
+    if(a != cmd.Filename) { pch_args.push_back(a); }
+  }
+  pch_args.push_back("-fsyntax-only");
+  pch_args.push_back("-x");
+  pch_args.push_back(pch_language(args, cmd.Filename));
+  pch_args.push_back(header);
+
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> fs(
+      llvm::vfs::createPhysicalFileSystem().release());
+  fs->setCurrentWorkingDirectory(cmd.Directory);
+  llvm::IntrusiveRefCntPtr<clang::FileManager> files(
+      new clang::FileManager(clang::FileSystemOptions(), fs));
+  ToolInvocation invocation(pch_args,
+                            std::make_unique<generate_pch_to>(pch_path),
+                            files.get(),
+                            std::make_shared<clang::PCHContainerOperations>());
+  if(!invocation.run()) {
+    errs << "build_pch: failed to precompile " << header << "\n";
+    return false;
+  }
+  return true;
+}  // build_pch
+
+clang::tooling::ArgumentsAdjuster
+mk_include_pch_adjuster(str_t_cr pch_path)
+{
+  using namespace clang::tooling;
+  return getInsertArgumentAdjuster(CommandLineArguments{"-include-pch",
+                                                        pch_path},
+                                   ArgumentInsertPosition::BEGIN);
+}
+
+}  // namespace corct
+
+// End of file
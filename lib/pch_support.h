@@ -0,0 +1,56 @@
+// pch_support.h
+// Oct 17, 2026
+
+/* Precompile a header that every translation unit includes, so that each TU
+ * only parses its own body. */
+
+#pragma once
+
+#include "types.h"
+
+#include "clang/Tooling/ArgumentsAdjusters.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include <iostream>
+#include <vector>
+
+namespace corct {
+
+/**\brief Is pch_path newer than header and every other file it was built
+ * from?
+ *
+ * The input files are the ones the PCH itself records, so changing a file
+ * the header includes makes the PCH stale. A PCH that cannot be read is not
+ * current. */
+bool
+pch_is_current(str_t_cr header, str_t_cr pch_path);
+
+/**\brief Language (the -x value) to precompile a header in for a TU
+ * compiled with 'args': the -x language in effect for 'source', or else the
+ * one its extension implies.
+ * \return "c-header", "c++-header", "objective-c-header", or
+ * "objective-c++-header" */
+string_t
+pch_language(clang::tooling::CommandLineArguments const & args,
+             str_t_cr source);
+
+/**\brief Precompile header into pch_path.
+ *
+ * The flags come from the compile command for 'source', after applying
+ * 'adjusters', so that the PCH is compatible with TUs compiled the same way;
+ * so does the language (see pch_language).
+ * \return true on success; on failure, diagnostics are written to errs */
+bool
+build_pch(clang::tooling::CompilationDatabase const & comps,
+          str_t_cr source,
+          str_t_cr header,
+          str_t_cr pch_path,
+          std::vector<clang::tooling::ArgumentsAdjuster> const & adjusters,
+          std::ostream & errs = std::cerr);
+
+/**\brief Adjuster that makes a TU load pch_path before its own source. */
+clang::tooling::ArgumentsAdjuster
+mk_include_pch_adjuster(str_t_cr pch_path);
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,231 @@
+// replacement_set.cc
+// Oct 17, 2026
+
+#include "replacement_set.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+namespace corct {
+
+string_t
+normalized_path(llvm::StringRef file, llvm::StringRef working_dir)
+{
+  if(file.empty()) { return file.str(); }
+  llvm::SmallString<256> p(file);
+  if(!working_dir.empty()) { llvm::sys::fs::make_absolute(working_dir, p); }
+  // a relative working_dir still leaves p relative
+  llvm::sys::fs::make_absolute(p);
+  llvm::sys::path::remove_dots(p, /*remove_dot_dot*/ true);
+  return p.str().str();
+}  // normalized_path
+
+replacement_set::add_result
+replacement_set::add(llvm::StringRef file,
+                     uint32_t const offset,
+                     uint32_t const length,
+                     llvm::StringRef text,
+                     llvm::StringRef source,
+                     llvm::StringRef working_dir)
+{
+  symbol_table & syms(*syms_);
+  edit_t const e = {offset, length, syms.intern(text), syms.intern(source)};
+  return add(syms.intern(normalized_path(file, working_dir)), e);
+}  // add
+
+replacement_set::add_result
+replacement_set::add(sym_id_t const file, edit_t const & e)
+{
+  file_edits_t & edits(files_[file]);
+  uint64_t const end = uint64_t(e.offset) + e.length;
+  auto overlaps = [&](edit_t const & o) {
+    return uint64_t(o.offset) < end && e.offset < uint64_t(o.offset) + o.length;
+  };
+  auto it = edits.lower_bound(key_t(e.offset, 0));
+  /* Stored edits don't overlap, so only the last one that starts before e
+   * can reach into it. */
+  if(it != edits.begin() && overlaps(std::prev(it)->second)) {
+    conflicts_.push_back({file, std::prev(it)->second, e});
+    return add_result::conflict;
+  }
+  for(; it != edits.end() &&
+        (it->first.first < end || it->first.first == e.offset);
+      ++it) {
+    edit_t const & o(it->second);
+    bool const same_place = o.offset == e.offset && o.length == e.length;
+    if(same_place && o.text == e.text) {
+      n_duplicates_++;
+      return add_result::duplicate;
+    }
+    if(same_place || overlaps(o)) {
+      conflicts_.push_back({file, o, e});
+      return add_result::conflict;
+    }
+  }
+  edits.emplace(key_t(e.offset, e.length), e);
+  return add_result::added;
+}  // add
+
+void
+replacement_set::merge(replacement_set const & other)
+{
+  symbol_table & syms(*syms_);
+  symbol_table const & from_syms(*other.syms_);
+  bool const same_table = &syms == &from_syms;
+  auto xlate = [&](sym_id_t const id) {
+    return same_table ? id : syms.intern(from_syms.name(id));
+  };
+  auto xlate_edit = [&](edit_t const & e) {
+    return edit_t{e.offset, e.length, xlate(e.text), xlate(e.source)};
+  };
+  for(auto & f : other.files_) {
+    sym_id_t const file = xlate(f.first);
+    for(auto & e : f.second) { add(file, xlate_edit(e.second)); }
+  }
+  for(auto & c : other.conflicts_) {
+    conflicts_.push_back(
+        {xlate(c.file), xlate_edit(c.kept), xlate_edit(c.dropped)});
+  }
+  n_duplicates_ += other.n_duplicates_;
+  return;
+}  // merge
+
+size_t
+replacement_set::n_edits() const
+{
+  size_t n(0);
+  for(auto & f : files_) { n += f.second.size(); }
+  return n;
+}
+
+std::vector<std::pair<string_t const *,
+                      replacement_set::file_edits_t const *>>
+replacement_set::sorted_files() const
+{
+  std::vector<std::pair<string_t const *, file_edits_t const *>> fs;
+  for(auto & f : files_) { fs.emplace_back(&syms_->name(f.first), &f.second); }
+  std::sort(fs.begin(), fs.end(), [](auto const & a, auto const & b) {
+    return *a.first < *b.first;
+  });
+  return fs;
+}  // sorted_files
+
+void
+replacement_set::write_edit(std::ostream & o, edit_t const & e) const
+{
+  o << e.offset << ":+" << e.length << ":\"" << syms_->name(e.text) << "\"";
+}
+
+void
+replacement_set::write_conflicts(std::ostream & o) const
+{
+  for(auto & c : conflicts_) {
+    o << "conflicting edits in " << syms_->name(c.file) << ": kept ";
+    write_edit(o, c.kept);
+    o << " from " << syms_->name(c.kept.source) << ", dropped ";
+    write_edit(o, c.dropped);
+    o << " from " << syms_->name(c.dropped.source) << "\n";
+  }
+  return;
+}  // write_conflicts
+
+void
+replacement_set::write(std::ostream & o) const
+{
+  for(auto & f : sorted_files()) {
+    for(auto & e : *f.second) {
+      o << *f.first << ": ";
+      write_edit(o, e.second);
+      o << "\n";
+    }
+  }
+  return;
+}  // write
+
+bool
+replacement_set::rewrite(llvm::StringRef file,
+                         llvm::StringRef contents,
+                         string_t & out) const
+{
+  out.clear();
+  sym_id_t id(0);
+  auto f = syms_->find(normalized_path(file), id) ? files_.find(id)
+                                                  : files_.end();
+  if(f == files_.end()) {
+    out = contents.str();
+    return true;
+  }
+  out.reserve(contents.size());
+  size_t pos(0);
+  for(auto & k : f->second) {
+    edit_t const & e(k.second);
+    if(uint64_t(e.offset) + e.length > contents.size()) { return false; }
+    out.append(contents.data() + pos, e.offset - pos);
+    out += syms_->name(e.text);
+    pos = e.offset + e.length;
+  }
+  out.append(contents.data() + pos, contents.size() - pos);
+  return true;
+}  // rewrite
+
+string_t
+replacement_set::apply_file(string_t const & path) const
+{
+  auto buf = llvm::MemoryBuffer::getFile(path, -1, false);
+  if(!buf) {
+    return "cannot read " + path + ": " + buf.getError().message();
+  }
+  string_t out;
+  if(!rewrite(path, (*buf)->getBuffer(), out)) {
+    return "edits run past the end of " + path + "; file not changed";
+  }
+  buf->reset();
+  std::ofstream o(path, std::ios::binary | std::ios::trunc);
+  o.write(out.data(), out.size());
+  if(!o) { return "error writing " + path; }
+  return "";
+}  // apply_file
+
+uint32_t
+replacement_set::apply(std::ostream & errs, uint32_t const n_jobs) const
+{
+  auto const files = sorted_files();
+  std::vector<string_t> problems(files.size());
+  std::atomic<size_t> next(0);
+  auto work = [&]() {
+    for(size_t i = next++; i < files.size(); i = next++) {
+      problems[i] = apply_file(*files[i].first);
+    }
+  };
+  uint32_t const n_threads = static_cast<uint32_t>(std::min<size_t>(
+      files.size(),
+      n_jobs > 0 ? n_jobs : std::max(1u, std::thread::hardware_concurrency())));
+  std::vector<std::thread> threads;
+  for(uint32_t t = 1; t < n_threads; ++t) { threads.emplace_back(work); }
+  work();
+  for(auto & t : threads) { t.join(); }
+  uint32_t n_failed(0);
+  for(auto & p : problems) {
+    if(p.empty()) { continue; }
+    errs << "replacement_set: " << p << "\n";
+    n_failed++;
+  }
+  return n_failed;
+}  // apply
+
+replacement_set::replacement_set()
+    : own_syms_(new symbol_table), syms_(own_syms_.get())
+{
+}
+
+replacement_set::replacement_set(symbol_table & syms) : syms_(&syms) {}
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,139 @@
+// replacement_set.h
+// Oct 17, 2026
+
+/* Edits gathered from many TUs, kept once each, and applied to each file in
+ * a single pass. */
+
+#pragma once
+
+#include "symbol_table.h"
+#include "types.h"
+
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace corct {
+
+/**\brief file made absolute against working_dir (or the current directory,
+ * if working_dir is empty or relative), with "." and ".." removed. Two
+ * spellings of one file, such as "src/../a.h" from one TU and "a.h" from a
+ * TU compiled in a different directory, come out the same.
+ * \return file unchanged if it is empty */
+string_t
+normalized_path(llvm::StringRef file, llvm::StringRef working_dir = "");
+
+/**\brief Source edits from a whole run: per file, a set of non-overlapping
+ * (offset, length, text) edits, each remembering where it came from (say,
+ * the TU that produced it).
+ *
+ * A header included by many TUs gets the same edits from each of them; they
+ * are stored once. An edit that overlaps one already in the set, or inserts
+ * different text at the same offset, is not added; the pair is recorded,
+ * with both sources, in conflicts(). An insertion at the start of a
+ * replaced range is not a conflict: the text is inserted before the range.
+ *
+ * Edit texts, file names, and sources are interned, so many copies of the
+ * same argument or parameter text cost one string. Like call_graph_builder,
+ * a set is not thread-safe; give each worker its own (they may share a
+ * symbol table) and merge() them.
+ */
+class replacement_set {
+public:
+  struct edit_t {
+    uint32_t offset;
+    uint32_t length;
+    sym_id_t text;
+    sym_id_t source;
+  };  // edit_t
+
+  struct conflict_t {
+    sym_id_t file;
+    edit_t kept;
+    edit_t dropped;
+  };  // conflict_t
+
+  enum class add_result { added, duplicate, conflict };
+
+  /**\brief Add an edit to file. A relative file is taken from working_dir
+   * (e.g. the directory its TU was compiled in); see normalized_path. */
+  add_result add(llvm::StringRef file,
+                 uint32_t const offset,
+                 uint32_t const length,
+                 llvm::StringRef text,
+                 llvm::StringRef source,
+                 llvm::StringRef working_dir = "");
+
+  /**\brief Add every edit, and every conflict, from another set. */
+  void merge(replacement_set const & other);
+
+  size_t n_files() const { return files_.size(); }
+
+  /**\brief Number of distinct edits. */
+  size_t n_edits() const;
+
+  /**\brief Number of edits not added because they were already present. */
+  uint64_t n_duplicates() const { return n_duplicates_; }
+
+  std::vector<conflict_t> const & conflicts() const { return conflicts_; }
+
+  /**\brief Describe each conflict, one per line, with both sources. */
+  void write_conflicts(std::ostream & o) const;
+
+  /**\brief List the edits, one per line, in the form of
+   * clang::tooling::Replacement::toString(). */
+  void write(std::ostream & o) const;
+
+  /**\brief Apply the edits of file (taken from the current directory, if
+   * relative) to its contents.
+   * \return false if an edit lies outside contents */
+  bool rewrite(llvm::StringRef file,
+               llvm::StringRef contents,
+               string_t & out) const;
+
+  /**\brief Rewrite each file with edits on disk: read once, write once.
+   * Files are spread over n_jobs threads (0: one per core). Problems are
+   * reported to errs, in file order.
+   * \return number of files that could not be rewritten */
+  uint32_t apply(std::ostream & errs = std::cerr,
+                 uint32_t const n_jobs = 1) const;
+
+  symbol_table & syms() const { return *syms_; }
+
+  /**\brief Construct with a private symbol table. */
+  replacement_set();
+
+  /**\brief Construct with a symbol table shared with other sets. */
+  explicit replacement_set(symbol_table & syms);
+
+private:
+  using key_t = std::pair<uint32_t, uint32_t>;  // offset, length
+  using file_edits_t = std::map<key_t, edit_t>;
+
+  add_result add(sym_id_t const file, edit_t const & e);
+
+  /**\brief Rewrite one file on disk.
+   * \return "" on success, else what went wrong */
+  string_t apply_file(string_t const & path) const;
+
+  /**\brief Files, in name order. */
+  std::vector<std::pair<string_t const *, file_edits_t const *>>
+  sorted_files() const;
+
+  /**\brief 'offset:+length:"text"' */
+  void write_edit(std::ostream & o, edit_t const & e) const;
+
+  std::map<sym_id_t, file_edits_t> files_;
+  std::vector<conflict_t> conflicts_;
+  uint64_t n_duplicates_ = 0;
+  std::shared_ptr<symbol_table> own_syms_;
+  symbol_table * syms_;
+};  // replacement_set
+
+}  // namespace corct
+
+// End of file
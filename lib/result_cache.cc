@@ -0,0 +1,191 @@
+// result_cache.cc
+// Oct 17, 2026
+
+#include "result_cache.h"
+
+#include "utilities.h"
+
+#include "clang/Basic/SourceManager.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <iostream>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace corct {
+
+namespace {
+/* Run the preprocessor over a TU, then hash every file it read, ordered by
+ * name so that the hash does not depend on the order files were loaded. */
+class hash_inputs_action : public clang::PreprocessOnlyAction {
+public:
+  explicit hash_inputs_action(llvm::MD5 & md5) : md5_(md5) {}
+
+protected:
+  void EndSourceFileAction() override
+  {
+    clang::SourceManager & sm(getCompilerInstance().getSourceManager());
+    std::vector<std::pair<llvm::StringRef, llvm::StringRef>> files;
+    for(auto it = sm.fileinfo_begin(); it != sm.fileinfo_end(); ++it) {
+      llvm::MemoryBuffer const * buf = it->second->getRawBuffer();
+      if(buf) { files.emplace_back(it->first->getName(), buf->getBuffer()); }
+    }
+    std::sort(files.begin(), files.end());
+    for(auto & f : files) {
+      md5_.update(f.first);
+      md5_.update(llvm::StringRef("\0", 1));
+      md5_.update(f.second);
+      md5_.update(llvm::StringRef("\0", 1));
+    }
+    clang::PreprocessOnlyAction::EndSourceFileAction();
+    return;
+  }
+
+private:
+  llvm::MD5 & md5_;
+};  // hash_inputs_action
+
+string_t const cache_magic = "corct-result-cache 1";
+}  // namespace
+
+std::unique_ptr<clang::FrontendAction>
+input_hasher::create()
+{
+  return std::make_unique<hash_inputs_action>(md5_);
+}
+
+void
+input_hasher::add(llvm::StringRef s)
+{
+  md5_.update(s);
+  md5_.update(llvm::StringRef("\0", 1));
+  return;
+}
+
+string_t
+input_hasher::digest()
+{
+  llvm::MD5::MD5Result r;
+  md5_.final(r);
+  return r.digest().str().str();
+}
+
+result_cache::result_cache(str_t_cr dir) : dir_(dir)
+{
+  llvm::sys::fs::create_directories(dir_);
+}
+
+string_t
+result_cache::path(str_t_cr key) const
+{
+  llvm::SmallString<256> p(dir_);
+  llvm::sys::path::append(p, key + ".tu");
+  return p.str().str();
+}
+
+bool
+result_cache::load(str_t_cr key, string_t & out, string_t & data) const
+{
+  auto buf = llvm::MemoryBuffer::getFile(path(key));
+  if(!buf) { return false; }
+  // layout: magic \n out-size \n data-size \n out data
+  llvm::StringRef contents((*buf)->getBuffer());
+  llvm::StringRef magic, n_out_s, n_data_s;
+  std::tie(magic, contents) = contents.split('\n');
+  std::tie(n_out_s, contents) = contents.split('\n');
+  std::tie(n_data_s, contents) = contents.split('\n');
+  size_t n_out(0), n_data(0);
+  if(magic != cache_magic || n_out_s.getAsInteger(10, n_out) ||
+     n_data_s.getAsInteger(10, n_data) ||
+     contents.size() != n_out + n_data) {
+    return false;
+  }
+  out = contents.substr(0, n_out).str();
+  data = contents.substr(n_out).str();
+  return true;
+}  // load
+
+bool
+result_cache::store(str_t_cr key, str_t_cr out, str_t_cr data) const
+{
+  llvm::SmallString<256> model(dir_), tmp_path;
+  llvm::sys::path::append(model, key + "-%%%%%%.tmp");
+  int fd(-1);
+  if(llvm::sys::fs::createUniqueFile(model, fd, tmp_path)) { return false; }
+  {
+    llvm::raw_fd_ostream o(fd, /*shouldClose*/ true);
+    o << cache_magic << "\n" << out.size() << "\n" << data.size() << "\n";
+    o << out << data;
+    o.close();
+    if(o.has_error()) {
+      o.clear_error();
+      llvm::sys::fs::remove(tmp_path);
+      return false;
+    }
+  }
+  if(llvm::sys::fs::rename(tmp_path, path(key))) {
+    llvm::sys::fs::remove(tmp_path);
+    return false;
+  }
+  return true;
+}  // store
+
+run_journal::run_journal(str_t_cr dir, bool const resume) : results_(dir)
+{
+  llvm::SmallString<256> p(dir);
+  llvm::sys::path::append(p, "journal");
+  path_ = p.str().str();
+  bool partial_line(false);
+  if(resume) {
+    auto buf = llvm::MemoryBuffer::getFile(path_);
+    llvm::StringRef rest(buf ? (*buf)->getBuffer() : "");
+    // a run killed mid-write may leave a partial last line: skip it
+    partial_line = !rest.empty() && !rest.endswith("\n");
+    while(!rest.empty()) {
+      llvm::StringRef line;
+      std::tie(line, rest) = rest.split('\n');
+      if(rest.empty() && partial_line) { break; }
+      vec_str const fs(split(line.str(), '\t'));
+      if(fs.size() == 3) { done_.insert(fs[0]); }
+    }
+  }
+  log_.open(path_, resume ? std::ios::app : std::ios::trunc);
+  if(!log_) {
+    std::cerr << "run_journal: could not open '" << path_
+              << "', completed TUs will not be recorded\n";
+  }
+  else if(partial_line) {
+    log_ << "\n";
+  }
+}
+
+bool
+run_journal::load(str_t_cr key, string_t & out, string_t & data) const
+{
+  return done(key) && results_.load(key, out, data);
+}
+
+bool
+run_journal::record(str_t_cr key,
+                    str_t_cr source,
+                    str_t_cr out,
+                    str_t_cr data)
+{
+  // store first, so that every journal line refers to a complete result
+  if(!results_.store(key, out, data)) { return false; }
+  std::lock_guard<std::mutex> lock(log_mutex_);
+  log_ << key << "\t" << source << "\t" << results_.path(key) << "\n";
+  log_.flush();
+  return static_cast<bool>(log_);
+}  // record
+
+}  // namespace corct
+
+// End of file
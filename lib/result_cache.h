@@ -0,0 +1,111 @@
+// result_cache.h
+// Oct 17, 2026
+
+/* On-disk cache of per-translation-unit results, so that unchanged TUs can be
+ * skipped when a tool is run again. */
+
+#pragma once
+
+#include "types.h"
+
+#include "clang/Tooling/Tooling.h"
+#include "llvm/Support/MD5.h"
+#include <fstream>
+#include <mutex>
+#include <set>
+
+namespace corct {
+
+/**\brief Frontend action factory that preprocesses a TU and hashes the
+ * contents of every file it reads.
+ *
+ * Two TUs with the same command line whose hashes agree see the same
+ * preprocessed input, so their analysis results agree too. */
+class input_hasher : public clang::tooling::FrontendActionFactory {
+public:
+  std::unique_ptr<clang::FrontendAction> create() override;
+
+  /**\brief Mix additional text (command line, tool settings) into the key. */
+  void add(llvm::StringRef s);
+
+  /**\brief Hex digest of everything added so far. Call once. */
+  string_t digest();
+
+private:
+  llvm::MD5 md5_;
+};  // input_hasher
+
+/**\brief Directory of cached TU results.
+ *
+ * Each entry holds the text a TU wrote to its output stream and an opaque
+ * data blob (typically a serialized callback shard), stored under the TU's
+ * content key. Entries are written to a temporary file and renamed into
+ * place, so concurrent workers and processes never see partial entries.
+ */
+class result_cache {
+public:
+  /**\brief Look up key.
+   * \return true if found; then out and data hold the stored values. */
+  bool load(str_t_cr key, string_t & out, string_t & data) const;
+
+  /**\brief Store out and data under key.
+   * \return true on success */
+  bool store(str_t_cr key, str_t_cr out, str_t_cr data) const;
+
+  str_t_cr dir() const { return dir_; }
+
+  /**\brief File that holds (or would hold) key's entry. */
+  string_t path(str_t_cr key) const;
+
+  /**\param dir: cache directory; created if necessary */
+  explicit result_cache(str_t_cr dir);
+
+private:
+  string_t dir_;
+};  // result_cache
+
+/**\brief Checkpoint journal for a batch run.
+ *
+ * Each TU that completes is stored (like a result_cache entry) in the
+ * journal's directory, then a line 'key <tab> source <tab> result file' is
+ * appended to dir/journal and flushed. If the run is killed, a new journal
+ * opened on the same directory with resume=true knows which TUs finished, and
+ * can load their results instead of processing them again. A TU whose line
+ * was not written, or whose stored result is missing, is simply run again.
+ */
+class run_journal {
+public:
+  /**\brief Did an earlier run record key? (Only when resuming.) */
+  bool done(str_t_cr key) const { return done_.count(key) > 0; }
+
+  /**\brief Load the results recorded under key.
+   * \return true if key was recorded and its results could be read */
+  bool load(str_t_cr key, string_t & out, string_t & data) const;
+
+  /**\brief Store out and data under key, then append key's line to the
+   * journal. Thread-safe.
+   * \return true on success */
+  bool record(str_t_cr key, str_t_cr source, str_t_cr out, str_t_cr data);
+
+  /**\brief Number of TUs recorded by earlier runs. */
+  size_t n_done() const { return done_.size(); }
+
+  /**\brief Path of the journal file. */
+  str_t_cr path() const { return path_; }
+
+  /**\param dir: journal directory; created if necessary
+   * \param resume: keep what an earlier run recorded in dir; otherwise, the
+   * journal starts out empty */
+  run_journal(str_t_cr dir, bool const resume);
+
+private:
+  result_cache results_;
+  string_t path_;
+  std::set<string_t> done_;
+  std::ofstream log_;
+  std::mutex log_mutex_;
+};  // run_journal
+
+}  // namespace corct
+
+// End of file
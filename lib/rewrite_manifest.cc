@@ -0,0 +1,180 @@
+// rewrite_manifest.cc
+// Oct 17, 2026
+
+#include "rewrite_manifest.h"
+
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <map>
+
+namespace corct {
+
+namespace {
+/* Read an optional string member. */
+bool
+get_str(llvm::json::Object const & o,
+        llvm::StringRef key,
+        string_t & s,
+        string_t & err)
+{
+  llvm::json::Value const * v = o.get(key);
+  if(!v) { return true; }
+  llvm::Optional<llvm::StringRef> const str = v->getAsString();
+  if(!str) {
+    err = "\"" + key.str() + "\" must be a string";
+    return false;
+  }
+  s = str->str();
+  return true;
+}  // get_str
+
+/* Read an optional array-of-strings member. */
+bool
+get_strs(llvm::json::Object const & o,
+         llvm::StringRef key,
+         vec_str & strs,
+         string_t & err)
+{
+  llvm::json::Value const * v = o.get(key);
+  if(!v) { return true; }
+  llvm::json::Array const * a = v->getAsArray();
+  bool ok = a != nullptr;
+  for(size_t i = 0; ok && i < a->size(); ++i) {
+    llvm::Optional<llvm::StringRef> const str = (*a)[i].getAsString();
+    ok = str.hasValue();
+    if(ok) { strs.push_back(str->str()); }
+  }
+  if(!ok) { err = "\"" + key.str() + "\" must be an array of strings"; }
+  return ok;
+}  // get_strs
+
+bool
+parse_spec(llvm::json::Value const & v, rewrite_spec & spec, string_t & err)
+{
+  llvm::json::Object const * o = v.getAsObject();
+  if(!o) {
+    err = "not an object";
+    return false;
+  }
+  for(auto & kv : *o) {
+    llvm::StringRef const k(kv.first);
+    if(k != "name" && k != "gvar" && k != "lvar" && k != "tf" && k != "np" &&
+       k != "na") {
+      err = "unknown key \"" + k.str() + "\"";
+      return false;
+    }
+  }
+  if(!get_str(*o, "name", spec.name, err) ||
+     !get_strs(*o, "gvar", spec.gvars, err) ||
+     !get_strs(*o, "lvar", spec.lvars, err) ||
+     !get_strs(*o, "tf", spec.targets, err) ||
+     !get_str(*o, "np", spec.new_param, err) ||
+     !get_str(*o, "na", spec.new_arg, err)) {
+    return false;
+  }
+  if(spec.gvars.size() != spec.lvars.size()) {
+    err = "needs one \"lvar\" for each \"gvar\"";
+    return false;
+  }
+  if(spec.expands() && (spec.new_param.empty() || spec.new_arg.empty())) {
+    err = "\"tf\" needs \"np\" and \"na\"";
+    return false;
+  }
+  if(!spec.replaces() && !spec.expands()) {
+    err = "has neither \"gvar\" nor \"tf\"";
+    return false;
+  }
+  return true;
+}  // parse_spec
+}  // namespace
+
+bool
+parse_manifest(llvm::StringRef text, rewrite_specs_t & specs, string_t & err)
+{
+  llvm::Expected<llvm::json::Value> v = llvm::json::parse(text);
+  if(!v) {
+    err = llvm::toString(v.takeError());
+    return false;
+  }
+  llvm::json::Array const * a = v->getAsArray();
+  if(!a) {
+    err = "manifest must be a JSON array of specs";
+    return false;
+  }
+  specs.clear();
+  for(size_t i = 0; i < a->size(); ++i) {
+    rewrite_spec spec;
+    if(!parse_spec((*a)[i], spec, err)) {
+      err = "spec " + std::to_string(i) + ": " + err;
+      return false;
+    }
+    if(spec.name.empty()) { spec.name = "spec " + std::to_string(i); }
+    specs.push_back(std::move(spec));
+  }
+  return true;
+}  // parse_manifest
+
+bool
+read_manifest(str_t_cr path, rewrite_specs_t & specs, string_t & err)
+{
+  auto buf = llvm::MemoryBuffer::getFile(path);
+  if(!buf) {
+    err = path + ": " + buf.getError().message();
+    return false;
+  }
+  if(!parse_manifest((*buf)->getBuffer(), specs, err)) {
+    err = path + ": " + err;
+    return false;
+  }
+  return true;
+}  // read_manifest
+
+string_t
+manifest_salt(rewrite_specs_t const & specs)
+{
+  // length-prefix every string, so no two spec lists run together the same
+  string_t salt;
+  auto add = [&salt](str_t_cr str) {
+    salt += std::to_string(str.size()) + ":" + str;
+  };
+  auto add_all = [&salt, &add](vec_str const & strs) {
+    salt += std::to_string(strs.size()) + "[";
+    for(auto & str : strs) { add(str); }
+  };
+  for(auto & spec : specs) {
+    add(spec.name);
+    add_all(spec.gvars);
+    add_all(spec.lvars);
+    add_all(spec.targets);
+    add(spec.new_param);
+    add(spec.new_arg);
+  }
+  return salt;
+}  // manifest_salt
+
+uint32_t
+check_manifest(rewrite_specs_t const & specs, std::ostream & errs)
+{
+  uint32_t n_problems(0);
+  // name -> first spec that uses it
+  std::map<string_t, size_t> replaced, expanded;
+  auto claim = [&](std::map<string_t, size_t> & owners, str_t_cr nm,
+                   size_t const s, char const * what) {
+    auto const ins = owners.emplace(nm, s);
+    if(!ins.second && ins.first->second != s) {
+      errs << "manifest: " << what << " " << nm << " in both '"
+           << specs[ins.first->second].name << "' and '" << specs[s].name
+           << "'\n";
+      n_problems++;
+    }
+  };
+  for(size_t s = 0; s < specs.size(); ++s) {
+    for(auto & g : specs[s].gvars) { claim(replaced, g, s, "global"); }
+    for(auto & t : specs[s].targets) { claim(expanded, t, s, "function"); }
+  }
+  return n_problems;
+}  // check_manifest
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,67 @@
+// rewrite_manifest.h
+// Oct 17, 2026
+
+/* A manifest lists many independent global-replace rewrites, so that one
+ * parse of each TU serves all of them. It is a JSON array of specs:
+ *
+ *   [ {"name": "nr", "gvar": ["NR", "NB"], "lvar": ["cfg.NR", "cfg.NB"]},
+ *     {"name": "cfg", "tf": ["f", "g"], "np": "Cfg const & cfg",
+ *      "na": "cfg"} ]
+ *
+ * Keys mean what the global-replace options of the same names do: a spec
+ * with "gvar" and "lvar" replaces references to globals (-R); one with "tf",
+ * "np", and "na" adds a parameter and argument to functions (-Xpnd). A spec
+ * may do both. "name" is optional, and is used in messages.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include "llvm/ADT/StringRef.h"
+#include <iostream>
+#include <vector>
+
+namespace corct {
+
+/**\brief One rewrite from a manifest. */
+struct rewrite_spec {
+  string_t name;       //!< "spec <position>" if the manifest gives none
+  vec_str gvars;       //!< globals to replace ...
+  vec_str lvars;       //!< ... and their replacements, respectively
+  vec_str targets;     //!< functions to expand
+  string_t new_param;  //!< parameter to add to targets
+  string_t new_arg;    //!< argument to add to calls to targets
+
+  bool replaces() const { return !gvars.empty(); }
+
+  bool expands() const { return !targets.empty(); }
+};  // rewrite_spec
+
+using rewrite_specs_t = std::vector<rewrite_spec>;
+
+/**\brief Parse a manifest.
+ * \return false, with a message in err, if text is not a valid manifest */
+bool
+parse_manifest(llvm::StringRef text, rewrite_specs_t & specs, string_t & err);
+
+/**\brief Read and parse the manifest at path. */
+bool
+read_manifest(str_t_cr path, rewrite_specs_t & specs, string_t & err);
+
+/**\brief Canonical text of specs, for salting a result cache or journal:
+ * two manifests get the same salt exactly when they parse to the same specs,
+ * however they are laid out. */
+string_t
+manifest_salt(rewrite_specs_t const & specs);
+
+/**\brief Look for specs that would step on each other before doing any work:
+ * a global replaced by two specs, or a function expanded by two. Each
+ * problem is reported to errs, with the names of both specs.
+ * \return number of problems */
+uint32_t
+check_manifest(rewrite_specs_t const & specs, std::ostream & errs = std::cerr);
+
+}  // namespace corct
+
+// End of file
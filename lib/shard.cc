@@ -0,0 +1,84 @@
+// shard.cc
+// Oct 17, 2026
+
+#include "shard.h"
+
+#include "llvm/ADT/StringRef.h"
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+namespace corct {
+
+namespace {
+string_t const shard_magic = "corct-shard";
+}  // namespace
+
+bool
+parse_shard(str_t_cr spec, uint32_t & index, uint32_t & count, string_t & err)
+{
+  llvm::StringRef i_s, n_s;
+  std::tie(i_s, n_s) = llvm::StringRef(spec).split('/');
+  uint32_t i(0), n(0);
+  if(i_s.getAsInteger(10, i) || n_s.getAsInteger(10, n)) {
+    err = "expected i/N, not '" + spec + "'";
+    return false;
+  }
+  if(n == 0 || i >= n) {
+    err = "shard '" + spec + "': need 0 <= i < N";
+    return false;
+  }
+  index = i;
+  count = n;
+  return true;
+}  // parse_shard
+
+vec_str
+shard_sources(vec_str const & sources,
+              uint32_t const index,
+              uint32_t const count,
+              std::vector<size_t> * positions)
+{
+  std::vector<size_t> by_path(sources.size());
+  std::iota(by_path.begin(), by_path.end(), 0);
+  // stable, so that repeated paths are dealt out in a fixed order too
+  std::stable_sort(by_path.begin(), by_path.end(),
+                   [&sources](size_t const a, size_t const b) {
+                     return sources[a] < sources[b];
+                   });
+  std::vector<bool> mine(sources.size(), false);
+  for(size_t k = index; k < by_path.size(); k += count) {
+    mine[by_path[k]] = true;
+  }
+  vec_str shard;
+  if(positions) { positions->clear(); }
+  for(size_t s = 0; s < sources.size(); ++s) {
+    if(!mine[s]) { continue; }
+    shard.push_back(sources[s]);
+    if(positions) { positions->push_back(s); }
+  }
+  return shard;
+}  // shard_sources
+
+void
+write_shard_header(std::ostream & o, str_t_cr kind)
+{
+  o << shard_magic << "\t" << kind << "\n";
+  return;
+}
+
+bool
+read_shard_header(std::istream & i, string_t & kind)
+{
+  string_t line;
+  if(!std::getline(i, line)) { return false; }
+  llvm::StringRef magic, k;
+  std::tie(magic, k) = llvm::StringRef(line).split('\t');
+  if(magic != shard_magic || k.empty()) { return false; }
+  kind = k.str();
+  return true;
+}  // read_shard_header
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,52 @@
+// shard.h
+// Oct 17, 2026
+
+/* Split one run over several processes (e.g. the tasks of a batch job
+ * array): each process runs the TUs of one shard of the source list and
+ * writes its mergeable results to a partial-results file; merge-shards
+ * combines the files into the report one process would have written.
+ *
+ * A partial-results file is a header line, 'corct-shard' <tab> kind, where
+ * kind names the tool that wrote it, followed by whatever that tool's
+ * accumulator writes (e.g. struct_field_user::write).
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include <iostream>
+#include <vector>
+
+namespace corct {
+
+/**\brief Parse a shard spec "i/N", 0 <= i < N.
+ * \return false, with a message in err, if spec is malformed */
+bool
+parse_shard(str_t_cr spec, uint32_t & index, uint32_t & count, string_t & err);
+
+/**\brief The sources in shard index of count.
+ *
+ * Sources are dealt out round-robin in path order, so that shards differ in
+ * size by at most one, and every process that is given the same sources, in
+ * any order, computes the same partition. The result keeps the order of
+ * 'sources'. If 'positions' is given, it gets the index in 'sources' of each
+ * source in the result. */
+vec_str
+shard_sources(vec_str const & sources,
+              uint32_t const index,
+              uint32_t const count,
+              std::vector<size_t> * positions = nullptr);
+
+/**\brief Start a partial-results file written by tool 'kind'. */
+void
+write_shard_header(std::ostream & o, str_t_cr kind);
+
+/**\brief Read a partial-results file's header line.
+ * \return false if the line is not a shard header; else kind is set */
+bool
+read_shard_header(std::istream & i, string_t & kind);
+
+}  // namespace corct
+
+// End of file
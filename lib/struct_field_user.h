@@ -6,8 +6,11 @@
 #define struct_field_user_H
 
 #include "dump_things.h"
+#include "function_scope.h"
 #include "make_replacement.h"
+#include "symbol_table.h"
 #include "types.h"
+#include "use_bit_matrix.h"
 #include "utilities.h"
 
 #include "clang/ASTMatchers/ASTMatchFinder.h"
@@ -15,24 +18,25 @@
 #include "clang/Tooling/Core/Replacement.h"
 #include "clang/Tooling/Tooling.h"
 #include <algorithm>  // std::remove
+#include <cstdlib>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <set>
 #include <sstream>
+#include <unordered_map>
 
 namespace corct {
-/* Match expressions using members of struct sname, whether in
-  the form s.field or s->field
- */
+/* Match a member expression whose object is struct sname, whether in
+  the form s.field or s->field. */
+inline
 auto
-mk_struct_field_matcher(string_t const & sname)
+mk_struct_object_matcher(string_t const & sname)
 {
   using namespace clang::ast_matchers;
   string_t s_ptr_name = "struct " + sname + " *";
   // clang-format off
   return
-    memberExpr(
-      isExpansionInMainFile(),
       anyOf(
         hasObjectExpression(
           hasType(
@@ -48,7 +52,31 @@ mk_struct_field_matcher(string_t const & sname)
             asString(s_ptr_name)
           ) // hasType
         ) // hasObjectExpression
-      ) // anyOf
+      ); // anyOf
+  // clang-format on
+}
+
+/* Match expressions using members of struct sname. With bind_function false,
+  the enclosing function is not bound; use with a function_scope_finder.
+ */
+inline
+auto
+mk_struct_field_matcher(string_t const & sname, bool const bind_function = true)
+{
+  using namespace clang::ast_matchers;
+  auto const of_struct = mk_struct_object_matcher(sname);
+  // clang-format off
+  if(!bind_function){
+    return
+      memberExpr(
+        isExpansionInMainFile(),
+        of_struct
+      ).bind("memberExpr");
+  }
+  return
+    memberExpr(
+      isExpansionInMainFile(),
+      of_struct
      ,hasAncestor(
         functionDecl().bind("function")
       )
@@ -56,44 +84,130 @@ mk_struct_field_matcher(string_t const & sname)
   // clang-format on
 }
 
+/* Match writes to members of struct sname: the target of an assignment
+  (simple or compound), or the operand of ++ or --. Binds the member
+  expression as "writtenMember" and the writing expression as "assignment".
+  A traversal reaches the assignment before its operands, so a callback sees
+  this match before mk_struct_field_matcher's match of the same member.
+ */
+inline
+auto
+mk_struct_field_write_matcher(string_t const & sname)
+{
+  using namespace clang::ast_matchers;
+  // clang-format off
+  auto const written =
+    ignoringParens(
+      memberExpr(
+        isExpansionInMainFile(),
+        mk_struct_object_matcher(sname)
+      ).bind("writtenMember")
+    );
+  return
+    expr(
+      anyOf(
+        binaryOperator(
+          isAssignmentOperator(),
+          hasLHS(written)
+        ),
+        unaryOperator(
+          anyOf(
+            hasOperatorName("++"),
+            hasOperatorName("--")
+          ),
+          hasUnaryOperand(written)
+        )
+      ) // anyOf
+    ).bind("assignment");
+  // clang-format on
+}
+
 /** Each time a target struct has a member accessed, track which function used
 it and whether it's used on the LHS or RHS (really non-LHS) of an expression.
+A compound assignment (+= etc.), ++, or -- both reads and writes its target,
+so it is recorded as both. Writes are found by mk_struct_field_write_matcher
+on the way down the AST, rather than by searching each member expression's
+parents, so the parent map is not needed.
+
+Struct, function, and member names are interned in a symbol_table; the use
+maps hold symbol ids, and names are looked up only when results are written.
+Several field users may share one symbol_table.
+
+A struct_field_user is not thread-safe; to run concurrently, give each worker
+its own instance (a shard) and fold them together with merge() at the end.
+Shards can also be written to a stream and read back in another process.
+merge() is a set union, so it is associative and commutative: shards may be
+combined in any grouping or order with the same result.
+
+With track_use_matrices(), each struct's uses (reads and writes together) are
+also kept in a use_bit_matrix, for co-usage queries such as how many
+functions use both of two fields.
   */
 struct struct_field_user : public callback_t {
 public:
-  using set_t = std::set<string_t>;
+  using sym_set_t = std::set<sym_id_t>;
   using func_mem_map_t =
-      std::map<string_t, set_t>;  // Key: func name, Vals: Members
-  using struct_f_m_map_t = std::map<string_t, func_mem_map_t>;
+      std::map<sym_id_t, sym_set_t>;  // Key: func symbol, Vals: Members
+  using struct_f_m_map_t = std::map<sym_id_t, func_mem_map_t>;
+  // The same maps keyed by name, for output
+  using set_t = std::set<string_t>;
+  using named_func_mem_map_t = std::map<string_t, set_t>;
+  using named_struct_f_m_map_t = std::map<string_t, named_func_mem_map_t>;
+  using use_matrices_t = std::map<sym_id_t, use_bit_matrix>;  // Key: struct
   using matcher_t = clang::ast_matchers::StatementMatcher;
   using matchers_t = std::vector<matcher_t>;
 
-  matchers_t matchers() const
+  /**\brief Two matchers per target: writes, and all uses. Register them all
+   * with this callback. Pass bind_function = false for matchers to run with a
+   * function_scope_finder (see use_scope). */
+  matchers_t matchers(bool const bind_function = true) const
   {
     matchers_t ms;
-    for(auto t : targets_) { ms.push_back(mk_struct_field_matcher(t)); }
+    for(auto t : targets_) {
+      ms.push_back(mk_struct_field_write_matcher(t));
+      ms.push_back(mk_struct_field_matcher(t, bind_function));
+    }
     return ms;
   }
 
+  /**\brief Take the enclosing function from 'scope' when a match does not
+   * bind one. */
+  void use_scope(enclosing_function const & scope) { scope_ = &scope; }
+
+  llvm::StringRef getID() const override { return "struct_field_user"; }
+
   void run(const result_t & result) override
   {
     using namespace clang;
+    MemberExpr const * written =
+        result.Nodes.getNodeAs<MemberExpr>("writtenMember");
+    if(written) {
+      // note the write; the use is recorded when the member itself matches
+      BinaryOperator const * bop =
+          result.Nodes.getNodeAs<BinaryOperator>("assignment");
+      written_[written] = !(bop && bop->getOpcode() == BO_Assign);
+      return;
+    }
     n_matches_++;
-    ASTContext & ctx(*(result.Context));
     MemberExpr const * membr = result.Nodes.getNodeAs<MemberExpr>("memberExpr");
-    FunctionDecl const * func =
-        result.Nodes.getNodeAs<FunctionDecl>("function");
+    FunctionDecl const * func = bound_or_enclosing_function(result, scope_);
     if(membr && func) {
-      string_t const s_name = get_struct_name(*membr);
-      string_t const f_name = func->getNameAsString();
-      string_t const m_name = membr->getMemberDecl()->getNameAsString();
-      Expr const * m_base = membr->getBase();
-      string_t const b_name = m_base->getType().getAsString();
-      bool const on_lhs(is_on_lhs(membr, ctx));
-      if(on_lhs) { lhs_uses_[s_name][f_name].insert(m_name); }
-      else {
-        non_lhs_uses_[s_name][f_name].insert(m_name);
+      ValueDecl const * m_decl = membr->getMemberDecl();
+      void const * s_key =
+          membr->getBase()->getType().getCanonicalType().getAsOpaquePtr();
+      sym_id_t const s_id =
+          cache_.get(s_key, [membr] { return get_struct_name(*membr); });
+      sym_id_t const f_id =
+          cache_.get(func, [func] { return func->getNameAsString(); });
+      sym_id_t const m_id =
+          cache_.get(m_decl, [m_decl] { return m_decl->getNameAsString(); });
+      auto const w_it = written_.find(membr);
+      bool const is_read = w_it == written_.end() || w_it->second;
+      if(w_it != written_.end()) {
+        record(lhs_uses_, s_id, f_id, m_id);
+        written_.erase(w_it);
       }
+      if(is_read) { record(non_lhs_uses_, s_id, f_id, m_id); }
     }
     else {
       check_ptr(membr, "membr");
@@ -102,9 +216,162 @@ public:
     return;
   }  // run
 
+  /**\brief AST addresses are reused between TUs, so forget them. */
+  void onEndOfTranslationUnit() override
+  {
+    cache_.clear();
+    written_.clear();
+  }
+
+  /**\brief Fold the uses recorded by another shard into this one. */
+  void merge(struct_field_user const & other)
+  {
+    merge_uses(lhs_uses_, other.lhs_uses_, other.syms());
+    merge_uses(non_lhs_uses_, other.non_lhs_uses_, other.syms());
+    n_matches_ += other.n_matches_;
+    return;
+  }
+
+  /**\brief Write recorded uses, one per line:
+   *  'lhs'|'rhs' <tab> struct <tab> function <tab> member */
+  void write(std::ostream & o) const
+  {
+    o << "n_matches\t" << n_matches_ << "\n";
+    write_uses(o, "lhs", lhs_uses());
+    write_uses(o, "rhs", non_lhs_uses());
+    return;
+  }
+
+  /**\brief Read uses written by write(), merging them into this shard.
+   * \return false if a malformed line was encountered */
+  bool read(std::istream & i)
+  {
+    string_t line;
+    while(std::getline(i, line)) {
+      vec_str const fs(split(line, '\t'));
+      if(fs.size() == 2 && fs[0] == "n_matches") {
+        n_matches_ += std::strtoul(fs[1].c_str(), nullptr, 10);
+      }
+      else if(fs.size() == 4 && (fs[0] == "lhs" || fs[0] == "rhs")) {
+        struct_f_m_map_t & uses(fs[0] == "lhs" ? lhs_uses_ : non_lhs_uses_);
+        symbol_table & syms(this->syms());
+        record(uses, syms.intern(fs[1]), syms.intern(fs[2]),
+               syms.intern(fs[3]));
+      }
+      else {
+        std::cerr << "struct_field_user::read: malformed line '" << line
+                  << "'\n";
+        return false;
+      }
+    }
+    return true;
+  }  // read
+
+  /**\brief Resolve a use map to names. */
+  named_struct_f_m_map_t named(struct_f_m_map_t const & uses) const
+  {
+    symbol_table const & syms(this->syms());
+    named_struct_f_m_map_t n;
+    for(auto & s_it : uses) {
+      named_func_mem_map_t & f_m(n[syms.name(s_it.first)]);
+      for(auto & f_it : s_it.second) {
+        set_t & ms(f_m[syms.name(f_it.first)]);
+        for(auto m : f_it.second) { ms.insert(syms.name(m)); }
+      }
+    }
+    return n;
+  }
+
+  named_struct_f_m_map_t lhs_uses() const { return named(lhs_uses_); }
+
+  named_struct_f_m_map_t non_lhs_uses() const { return named(non_lhs_uses_); }
+
+  symbol_table & syms() const { return cache_.table(); }
+
+  /**\brief Also keep a use_bit_matrix per struct. Turn this on before
+   * recording or merging any uses. */
+  void track_use_matrices(bool const on = true) { track_bits_ = on; }
+
+  /**\brief Per-struct use matrices; empty unless track_use_matrices(). */
+  use_matrices_t const & use_matrices() const { return use_bits_; }
+
+  /**\brief Write each struct's field x field co-usage matrix (see
+   * write_co_usage), structs in name order. */
+  void write_co_usage(std::ostream & o) const
+  {
+    symbol_table const & syms(this->syms());
+    std::map<string_t, use_bit_matrix const *> by_name;
+    for(auto & s_it : use_bits_) {
+      by_name[syms.name(s_it.first)] = &s_it.second;
+    }
+    for(auto & s_it : by_name) {
+      o << "# struct " << s_it.first << "\n";
+      corct::write_co_usage(*s_it.second, syms, o);
+    }
+    return;
+  }
+
+  /**\brief Construct with a private symbol table. */
   explicit struct_field_user(vec_str & targets)
-      : targets_(targets), n_matches_(0)
+      : targets_(targets),
+        n_matches_(0),
+        own_syms_(new symbol_table),
+        cache_(*own_syms_)
+  {
+  }
+
+  /**\brief Construct with a symbol table shared with other users. */
+  struct_field_user(vec_str & targets, symbol_table & syms)
+      : targets_(targets), n_matches_(0), cache_(syms)
+  {
+  }
+
+  /**\brief Union 'from' into 'into'. Ids in 'from' belong to 'from_syms';
+   * they are translated if that is not the table that 'into' uses. */
+  void merge_uses(struct_f_m_map_t & into,
+                  struct_f_m_map_t const & from,
+                  symbol_table const & from_syms)
+  {
+    symbol_table & syms(this->syms());
+    bool const same_table = &syms == &from_syms;
+    auto xlate = [&](sym_id_t const id) {
+      return same_table ? id : syms.intern(from_syms.name(id));
+    };
+    for(auto & s_it : from) {
+      func_mem_map_t & f_m(into[xlate(s_it.first)]);
+      for(auto & f_it : s_it.second) {
+        sym_id_t const f_id = xlate(f_it.first);
+        sym_set_t & ms(f_m[f_id]);
+        if(same_table && !track_bits_) {
+          ms.insert(f_it.second.begin(), f_it.second.end());
+        }
+        else {
+          use_bit_matrix * bits =
+              track_bits_ ? &use_bits_[xlate(s_it.first)] : nullptr;
+          for(auto m : f_it.second) {
+            sym_id_t const m_id = xlate(m);
+            ms.insert(m_id);
+            if(bits) { bits->insert(f_id, m_id); }
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  static void write_uses(std::ostream & o,
+                         str_t_cr tag,
+                         named_struct_f_m_map_t const & uses)
   {
+    for(auto & s_it : uses) {
+      for(auto & f_it : s_it.second) {
+        for(auto & m : f_it.second) {
+          o << tag << "\t" << s_it.first << "\t" << f_it.first << "\t" << m
+            << "\n";
+        }
+      }
+    }
+    return;
   }
 
   // state:
@@ -112,8 +379,45 @@ public:
   struct_f_m_map_t lhs_uses_;
   struct_f_m_map_t non_lhs_uses_;
   uint32_t n_matches_;
+
+private:
+  /**\brief Record one use in 'uses', and in the struct's use matrix. */
+  void record(struct_f_m_map_t & uses,
+              sym_id_t const s_id,
+              sym_id_t const f_id,
+              sym_id_t const m_id)
+  {
+    uses[s_id][f_id].insert(m_id);
+    if(track_bits_) { use_bits_[s_id].insert(f_id, m_id); }
+    return;
+  }
+
+  std::shared_ptr<symbol_table> own_syms_;
+  symbol_cache cache_;
+  bool track_bits_ = false;
+  use_matrices_t use_bits_;
+  enclosing_function const * scope_ = nullptr;
+  // member expressions written, but not yet matched: is the write also a read?
+  std::unordered_map<clang::MemberExpr const *, bool> written_;
 };  // struct_field_user
 
+/** Print one line per use: function struct member. */
+inline void
+print_fields(struct_field_user::named_struct_f_m_map_t const & m,
+             std::ostream & o = std::cout)
+{
+  for(auto & map_it : m) {
+    string_t const & s_name = map_it.first;
+    for(auto & mm_it : map_it.second) {
+      string_t const & f_name = mm_it.first;
+      for(auto & membr : mm_it.second) {
+        o << f_name << " " << s_name << " " << membr << "\n";
+      }
+    }
+  }
+  return;
+}  // print_fields
+
 }  // namespace corct
 
 #endif  // include guard
@@ -0,0 +1,46 @@
+// symbol_table.cc
+// Oct 17, 2026
+
+#include "symbol_table.h"
+
+namespace corct {
+
+sym_id_t
+symbol_table::intern(llvm::StringRef name)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = ids_.find(name);
+  if(it != ids_.end()) { return it->second; }
+  sym_id_t const id = static_cast<sym_id_t>(names_.size());
+  ids_.insert(std::make_pair(name, id));
+  names_.emplace_back(name.str());
+  return id;
+}  // intern
+
+bool
+symbol_table::find(llvm::StringRef name, sym_id_t & id) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = ids_.find(name);
+  if(it == ids_.end()) { return false; }
+  id = it->second;
+  return true;
+}  // find
+
+string_t const &
+symbol_table::name(sym_id_t id) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return names_[id];
+}
+
+size_t
+symbol_table::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return names_.size();
+}
+
+}  // namespace corct
+
+// End of file
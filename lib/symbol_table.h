@@ -0,0 +1,83 @@
+// symbol_table.h
+// Oct 17, 2026
+
+/* Interned names for analysis results. Callbacks record 32-bit symbol ids
+ * instead of strings; ids are turned back into names only when results are
+ * written out. */
+
+#pragma once
+
+#include "types.h"
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace corct {
+
+using sym_id_t = uint32_t;
+
+/**\brief Thread-safe table of interned names.
+ *
+ * Ids are dense, starting at zero, in order of first interning. Since that
+ * order depends on scheduling when several workers share a table, sort by
+ * name(), not by id, when output order matters. */
+class symbol_table {
+public:
+  /**\brief Get the id for a name, adding it if necessary. */
+  sym_id_t intern(llvm::StringRef name);
+
+  /**\brief Get the id for a name that is already in the table.
+   * \return true if found */
+  bool find(llvm::StringRef name, sym_id_t & id) const;
+
+  /**\brief Name of an interned symbol. The reference stays valid for the
+   * lifetime of the table. */
+  string_t const & name(sym_id_t id) const;
+
+  size_t size() const;
+
+private:
+  mutable std::mutex mutex_;
+  llvm::StringMap<sym_id_t> ids_;
+  std::deque<string_t> names_;  // deque: references survive growth
+};  // symbol_table
+
+/**\brief Per-callback memo of AST node address -> symbol id.
+ *
+ * Looking up a declaration (or type) that has been seen before costs one hash
+ * probe, with no string construction and no locking of the shared table.
+ * Addresses are only meaningful within one translation unit, so call clear()
+ * at the end of each TU (e.g. from MatchCallback::onEndOfTranslationUnit).
+ */
+class symbol_cache {
+public:
+  /**\brief Get the symbol for node 'key', calling name_of() to build its name
+   * the first time the node is seen. */
+  template <typename Name_Fn>
+  sym_id_t get(void const * key, Name_Fn && name_of)
+  {
+    auto it = ids_.find(key);
+    if(it != ids_.end()) { return it->second; }
+    sym_id_t const id = syms_->intern(name_of());
+    ids_.emplace(key, id);
+    return id;
+  }
+
+  void clear() { ids_.clear(); }
+
+  symbol_table & table() const { return *syms_; }
+
+  explicit symbol_cache(symbol_table & syms) : syms_(&syms) {}
+
+private:
+  symbol_table * syms_;
+  std::unordered_map<void const *, sym_id_t> ids_;
+};  // symbol_cache
+
+}  // namespace corct
+
+// End of file
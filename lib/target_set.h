@@ -0,0 +1,68 @@
+// target_set.h
+// Oct 17, 2026
+
+#pragma once
+
+#include "types.h"
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+
+namespace corct {
+
+/**\brief A list of target names with constant-time lookup.
+ *
+ * Keeps the names in the order given (matchers are generated in that order)
+ * and maps each name to its position, so callbacks can check a matched name,
+ * and find data kept in parallel vectors, without scanning the list. If a
+ * name is repeated, lookups find its first position.
+ */
+class target_set {
+public:
+  using index_t = uint32_t;
+  using const_iterator = vec_str::const_iterator;
+
+  /**\brief Is name a target? */
+  bool contains(llvm::StringRef name) const
+  {
+    return index_.find(name) != index_.end();
+  }
+
+  /**\brief Get the position of name in the target list.
+   * \return true if name is a target */
+  bool find(llvm::StringRef name, index_t & idx) const
+  {
+    auto it = index_.find(name);
+    if(it == index_.end()) { return false; }
+    idx = it->second;
+    return true;
+  }
+
+  vec_str const & names() const { return names_; }
+
+  size_t size() const { return names_.size(); }
+
+  bool empty() const { return names_.empty(); }
+
+  const_iterator begin() const { return names_.begin(); }
+
+  const_iterator end() const { return names_.end(); }
+
+  explicit target_set(vec_str const & names) : names_(names)
+  {
+    for(index_t i = 0; i < names_.size(); ++i) {
+      index_.insert(std::make_pair(llvm::StringRef(names_[i]), i));
+    }
+  }
+
+  target_set() {}
+
+private:
+  vec_str names_;
+  llvm::StringMap<index_t> index_;
+};  // target_set
+
+}  // namespace corct
+
+// End of file
@@ -90,7 +90,12 @@ mk_templ_var_matcher(str_t_cr template_name, str_t_cr namespace_name)
 // clang-format on
 
 /**\brief Find instances of a template variable and record the names of the
- * template arguments. */
+ * template arguments.
+ *
+ * Not thread-safe: concurrent workers should each use their own instance and
+ * combine them with merge(). If two instances recorded different arguments
+ * for the same variable name, merge keeps the lexicographically least, so
+ * that merging is associative and does not depend on the order of shards. */
 struct template_var_reporter : public callback_t {
   using vec_strs_t = std::vector<string_t>;
   using map_args_t =
@@ -110,6 +115,8 @@ struct template_var_reporter : public callback_t {
     return ms;
   }  // matchers
 
+  llvm::StringRef getID() const override { return "template_var_reporter"; }
+
   virtual void run(const result_t & result) override
   {
     using namespace clang;
@@ -146,6 +153,50 @@ struct template_var_reporter : public callback_t {
     return;
   }  // run
 
+  /**\brief Fold the variables recorded by another instance into this one. */
+  void merge(template_var_reporter const & other)
+  {
+    for(auto & p : other.args_) {
+      auto it = args_.find(p.first);
+      if(it == args_.end()) { args_.insert(p); }
+      else if(p.second < it->second) {
+        it->second = p.second;
+      }
+    }
+    return;
+  }
+
+  /**\brief Write one line per variable: name <tab> arg1 <tab> arg2 ... */
+  void write(std::ostream & o) const
+  {
+    for(auto & p : args_) {
+      o << p.first;
+      for(auto & a : p.second) { o << "\t" << a; }
+      o << "\n";
+    }
+    return;
+  }
+
+  /**\brief Read variables written by write(), merging them into this one.
+   * \return false if a malformed line was encountered */
+  bool read(std::istream & i)
+  {
+    template_var_reporter shard(template_name_, namespace_name_);
+    string_t line;
+    while(std::getline(i, line)) {
+      vec_str fs(split(line, '\t'));
+      if(fs.empty() || fs[0].empty()) {
+        std::cerr << "template_var_reporter::read: malformed line '" << line
+                  << "'\n";
+        return false;
+      }
+      string_t const var_name(fs[0]);
+      shard.args_[var_name] = vec_strs_t(fs.begin() + 1, fs.end());
+    }
+    merge(shard);
+    return true;
+  }  // read
+
   template_var_reporter(str_t_cr template_name, str_t_cr namespace_name = "")
       : template_name_(template_name), namespace_name_(namespace_name)
   {
@@ -156,6 +207,68 @@ struct template_var_reporter : public callback_t {
   string_t namespace_name_;
 };  // template_var_reporter
 
+// Functions that process the results
+using type_set_t = std::set<string_t>;
+
+/**\brief distill the results into a set*/
+inline type_set_t
+collate_types(template_var_reporter::map_args_t const & args)
+{
+  type_set_t type_set;
+  for(auto p : args) {
+    template_var_reporter::vec_strs_t const & type_args(p.second);
+    for(auto & t : type_args) { type_set.insert(t); }
+  }
+  return type_set;
+}  // collate_types
+
+inline void
+fix_class(string_t & s);
+
+/**\brief Remove substring from s. */
+inline void
+seek_and_remove(string_t & s, string_t const & substr)
+{
+  size_t n = s.find(substr);
+  if(n != std::string::npos) {
+    s.replace(n, substr.size(), "");
+    return fix_class(s);
+  }
+  return;
+}
+
+/** \brief Remove 'class ', 'struct ', '__1::', and ' ' */
+inline void
+fix_class(string_t & s)
+{
+  string_t struct_str("struct ");
+  string_t class_str("class ");
+  string_t ns_str("__1::");
+  seek_and_remove(s, struct_str);
+  seek_and_remove(s, class_str);
+  seek_and_remove(s, ns_str);
+  seek_and_remove(s, " ");
+  return;
+}  // fix_class
+
+/**\brief process the set of types into result, in this case a tuple written
+ * to a stream. */
+inline void
+process_type_set(type_set_t const & ts, std::ostream & s)
+{
+  s << "using types = std::tuple<\n";
+  size_t n_ts(ts.size());
+  size_t i(0);
+  for(auto & t1 : ts) {
+    std::string t(t1);
+    fix_class(t);
+    s << "\t" << t;
+    if(i++ < (n_ts - 1)) { s << ",\n"; }
+  }
+  s << ">;\n";
+  return;
+}  // process_type_set
+
 }  // namespace corct
 
 // End of file
@@ -0,0 +1,120 @@
+// tu_schedule.cc
+// Oct 17, 2026
+
+#include "tu_schedule.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+namespace corct {
+
+namespace {
+/* Bytes charged for each #include: the size of a modest header. A header's
+ * own includes are not followed, so this undercounts deep include trees. */
+double const include_cost = 16384;
+}  // namespace
+
+double
+tu_costs::get(str_t_cr source) const
+{
+  auto it = secs_.find(source);
+  return it == secs_.end() ? -1.0 : it->second;
+}
+
+bool
+tu_costs::load(str_t_cr path)
+{
+  auto buf = llvm::MemoryBuffer::getFile(path);
+  if(!buf) { return true; }
+  llvm::StringRef rest((*buf)->getBuffer());
+  while(!rest.empty()) {
+    llvm::StringRef line, secs_s, source;
+    std::tie(line, rest) = rest.split('\n');
+    std::tie(secs_s, source) = line.split('\t');
+    double secs(0);
+    if(source.empty() || secs_s.getAsDouble(secs)) { return false; }
+    secs_[source.str()] = secs;
+  }
+  return true;
+}  // load
+
+bool
+tu_costs::save(str_t_cr path) const
+{
+  llvm::SmallString<256> tmp_path;
+  int fd(-1);
+  if(llvm::sys::fs::createUniqueFile(path + "-%%%%%%.tmp", fd, tmp_path)) {
+    return false;
+  }
+  {
+    llvm::raw_fd_ostream o(fd, /*shouldClose*/ true);
+    for(auto & s : secs_) { o << s.second << "\t" << s.first << "\n"; }
+    o.close();
+    if(o.has_error()) {
+      o.clear_error();
+      llvm::sys::fs::remove(tmp_path);
+      return false;
+    }
+  }
+  if(llvm::sys::fs::rename(tmp_path, path)) {
+    llvm::sys::fs::remove(tmp_path);
+    return false;
+  }
+  return true;
+}  // save
+
+double
+estimate_source_cost(llvm::StringRef text)
+{
+  double cost = static_cast<double>(text.size());
+  llvm::StringRef rest(text);
+  while(!rest.empty()) {
+    llvm::StringRef line;
+    std::tie(line, rest) = rest.split('\n');
+    line = line.ltrim();
+    if(line.consume_front("#") && line.ltrim().startswith("include")) {
+      cost += include_cost;
+    }
+  }
+  return cost;
+}  // estimate_source_cost
+
+std::vector<size_t>
+largest_first(vec_str const & sources,
+              tu_costs const & recorded,
+              std::function<double(str_t_cr)> const & estimate)
+{
+  size_t const n = sources.size();
+  std::vector<double> costs(n, 0.0);
+  double recorded_secs(0), recorded_est(0);
+  bool any_recorded(false);
+  for(size_t i = 0; i < n; ++i) {
+    costs[i] = recorded.get(sources[i]);
+    if(costs[i] < 0) { continue; }
+    any_recorded = true;
+    recorded_secs += costs[i];
+    recorded_est += estimate(sources[i]);
+  }
+  // seconds per unit of estimate; 1 compares estimates with each other
+  double const rate =
+      (any_recorded && recorded_est > 0) ? recorded_secs / recorded_est : 1.0;
+  for(size_t i = 0; i < n; ++i) {
+    if(costs[i] < 0) { costs[i] = rate * estimate(sources[i]); }
+  }
+  std::vector<size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&costs](size_t const a, size_t const b) {
+                     return costs[a] > costs[b];
+                   });
+  return order;
+}  // largest_first
+
+}  // namespace corct
+
+// End of file
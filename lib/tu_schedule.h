@@ -0,0 +1,67 @@
+// tu_schedule.h
+// Oct 17, 2026
+
+/* Order translation units so that the most expensive start first. TU costs
+ * vary by orders of magnitude; if a large TU happens to start last, the
+ * other workers sit idle while it finishes. Handing out the largest first
+ * (longest-processing-time order) keeps the run close to total work divided
+ * by the number of workers. */
+
+#pragma once
+
+#include "types.h"
+
+#include "llvm/ADT/StringRef.h"
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace corct {
+
+/**\brief Run time of each TU, in seconds, as measured by earlier runs.
+ *
+ * The file format is one line per TU: seconds <tab> source. */
+class tu_costs {
+public:
+  /**\brief Seconds recorded for source, or a negative number if none. */
+  double get(str_t_cr source) const;
+
+  void set(str_t_cr source, double const seconds) { secs_[source] = seconds; }
+
+  size_t size() const { return secs_.size(); }
+
+  /**\brief Merge the times in path into this; a missing file is empty.
+   * \return false if the file exists but has a malformed line */
+  bool load(str_t_cr path);
+
+  /**\brief Write every time, by source, to path. The file is written under a
+   * temporary name and renamed, so readers never see half of it.
+   * \return false on failure */
+  bool save(str_t_cr path) const;
+
+private:
+  std::map<string_t, double> secs_;
+};  // tu_costs
+
+/**\brief Rough cost of a TU whose main file holds 'text': its size in
+ * bytes, plus a typical header's size for each #include it has. Only good
+ * for comparing TUs. */
+double
+estimate_source_cost(llvm::StringRef text);
+
+/**\brief Order in which to process sources: most expensive first, ties in
+ * source order.
+ *
+ * A source's cost is its recorded time, if it has one. Otherwise it is
+ * estimate(source), converted to seconds at the rate the recorded TUs
+ * suggest (total recorded seconds over their total estimate); with no
+ * recorded times, the estimates are compared directly.
+ * \return indices into sources */
+std::vector<size_t>
+largest_first(vec_str const & sources,
+              tu_costs const & recorded,
+              std::function<double(str_t_cr)> const & estimate);
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,75 @@
+// typedef_reporter.h
+// Feb 14, 2017
+// (c) Copyright 2017 LANSLLC, all rights reserved
+
+/* Find all C struct fields declared with a typedef; report the typedef and
+ * underlying (desugared) type. */
+
+#pragma once
+
+#include "dump_things.h"
+#include "types.h"
+#include "utilities.h"
+
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/ASTMatchers/ASTMatchers.h"
+#include <iostream>
+#include <string>
+
+namespace corct {
+
+struct Typedef_Reporter
+    : public clang::ast_matchers::MatchFinder::MatchCallback {
+  std::string const ty_bd_name_ = "type_decl";
+  std::string const fd_bd_name_ = "fld_decl";
+
+  auto matcher()
+  {
+    using namespace clang::ast_matchers;
+    // clang-format off
+    return
+    fieldDecl(
+      hasType(
+        typedefType().bind(ty_bd_name_)
+      )//hasType
+    ).bind(fd_bd_name_);
+    // clang-format on
+  }  // matcher
+
+  llvm::StringRef getID() const override { return "Typedef_Reporter"; }
+
+  virtual void run(result_t const & result) override
+  {
+    using namespace clang;
+    FieldDecl * f_decl =
+        const_cast<FieldDecl *>(result.Nodes.getNodeAs<FieldDecl>(fd_bd_name_));
+    TypedefType * tt = const_cast<TypedefType *>(
+        result.Nodes.getNodeAs<TypedefType>(ty_bd_name_));
+    if(f_decl && tt) {
+      // QualType qt = tt->desugar();   // good to see
+      QualType ut = tt->getDecl()->getUnderlyingType();
+      TypedefNameDecl * tnd = tt->getDecl();
+      std::string const struct_name = f_decl->getParent()->getNameAsString();
+      std::string const fld_name = f_decl->getNameAsString();
+      // std::string const ty_name = qt.getAsString();
+      std::string ut_name = ut.getAsString();
+      std::string tnd_name = tnd->getNameAsString();
+      o_ << "Struct '" << struct_name << "' declares field '" << fld_name
+         << " with typedef name = '" << tnd_name << "'"
+         << ", underlying type = '" << ut_name << "'" << std::endl;
+    }
+    else {
+      check_ptr(f_decl, "f_decl");
+      check_ptr(tt, "tt");
+    }
+    return;
+  }  // run
+
+  explicit Typedef_Reporter(std::ostream & o) : o_(o) {}
+
+  std::ostream & o_;
+};  // struct Typedef_Reporter
+
+}  // namespace corct
+
+// End of file
@@ -0,0 +1,132 @@
+// use_bit_matrix.cc
+// Oct 17, 2026
+
+#include "use_bit_matrix.h"
+
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <numeric>
+
+namespace corct {
+
+use_bit_matrix::index_t
+use_bit_matrix::count_trailing_zeros(uint64_t const bits)
+{
+  return static_cast<index_t>(llvm::countTrailingZeros(bits));
+}
+
+void
+use_bit_matrix::insert(sym_id_t const func, sym_id_t const field)
+{
+  auto const f_it = func_idx_.insert({func, n_funcs()});
+  if(f_it.second) { funcs_.push_back(func); }
+  auto const c_it = field_idx_.insert({field, n_fields()});
+  if(c_it.second) {
+    fields_.push_back(field);
+    cols_.emplace_back();
+  }
+  index_t const row = f_it.first->second;
+  std::vector<uint64_t> & col(cols_[c_it.first->second]);
+  if(col.size() <= row / 64) { col.resize(row / 64 + 1, 0); }
+  col[row / 64] |= uint64_t(1) << (row % 64);
+  return;
+}  // insert
+
+std::vector<uint64_t> const *
+use_bit_matrix::column(sym_id_t const field) const
+{
+  auto const it = field_idx_.find(field);
+  return it == field_idx_.end() ? nullptr : &cols_[it->second];
+}
+
+bool
+use_bit_matrix::uses(sym_id_t const func, sym_id_t const field) const
+{
+  auto const f_it = func_idx_.find(func);
+  auto const col = column(field);
+  if(f_it == func_idx_.end() || !col) { return false; }
+  index_t const row = f_it->second;
+  return row / 64 < col->size() &&
+         0 != ((*col)[row / 64] & (uint64_t(1) << (row % 64)));
+}  // uses
+
+uint32_t
+use_bit_matrix::users(sym_id_t const field) const
+{
+  auto const col = column(field);
+  if(!col) { return 0; }
+  uint32_t n(0);
+  for(auto w : *col) { n += llvm::countPopulation(w); }
+  return n;
+}
+
+uint32_t
+use_bit_matrix::co_users(sym_id_t const a, sym_id_t const b) const
+{
+  auto const ca = column(a), cb = column(b);
+  if(!ca || !cb) { return 0; }
+  size_t const n_words = std::min(ca->size(), cb->size());
+  uint32_t n(0);
+  for(size_t w = 0; w < n_words; ++w) {
+    n += llvm::countPopulation((*ca)[w] & (*cb)[w]);
+  }
+  return n;
+}  // co_users
+
+std::vector<sym_id_t>
+use_bit_matrix::co_user_funcs(sym_id_t const a, sym_id_t const b) const
+{
+  std::vector<sym_id_t> fs;
+  auto const ca = column(a), cb = column(b);
+  if(!ca || !cb) { return fs; }
+  size_t const n_words = std::min(ca->size(), cb->size());
+  for(size_t w = 0; w < n_words; ++w) {
+    for(uint64_t bits = (*ca)[w] & (*cb)[w]; bits; bits &= bits - 1) {
+      fs.push_back(funcs_[w * 64 + count_trailing_zeros(bits)]);
+    }
+  }
+  return fs;
+}  // co_user_funcs
+
+std::vector<uint32_t>
+use_bit_matrix::co_usage() const
+{
+  index_t const n = n_fields();
+  std::vector<uint32_t> m(size_t(n) * n, 0);
+  for(index_t a = 0; a < n; ++a) {
+    for(index_t b = a; b < n; ++b) {
+      uint32_t const k = co_users(fields_[a], fields_[b]);
+      m[size_t(a) * n + b] = k;
+      m[size_t(b) * n + a] = k;
+    }
+  }
+  return m;
+}  // co_usage
+
+void
+write_co_usage(use_bit_matrix const & m,
+               symbol_table const & syms,
+               std::ostream & o)
+{
+  using index_t = use_bit_matrix::index_t;
+  index_t const n = m.n_fields();
+  std::vector<index_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](index_t const x, index_t const y) {
+    return syms.name(m.field(x)) < syms.name(m.field(y));
+  });
+  std::vector<uint32_t> const co(m.co_usage());
+  o << "field";
+  for(auto c : order) { o << "\t" << syms.name(m.field(c)); }
+  o << "\n";
+  for(auto r : order) {
+    o << syms.name(m.field(r));
+    for(auto c : order) { o << "\t" << co[size_t(r) * n + c]; }
+    o << "\n";
+  }
+  return;
+}  // write_co_usage
+
+}  // namespace corct
+
+// End of file
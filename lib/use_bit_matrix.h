@@ -0,0 +1,100 @@
+// use_bit_matrix.h
+// Oct 17, 2026
+
+/* Function x field uses of one struct as bit columns, for fast co-usage
+ * queries: which functions use both field a and field b is an AND of two
+ * columns, and how many is a popcount. */
+
+#pragma once
+
+#include "symbol_table.h"
+#include "types.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace corct {
+
+/**\brief Which functions use which fields of one struct, one bit column per
+ * field.
+ *
+ * Functions and fields are given symbol ids (see symbol_table) and are
+ * assigned dense row and column indices in order of first insertion. A
+ * column only grows as far as its highest function row, so columns of
+ * rarely used fields stay short.
+ */
+class use_bit_matrix {
+public:
+  using index_t = uint32_t;
+
+  /**\brief Record that func uses field. Amortized O(1). */
+  void insert(sym_id_t const func, sym_id_t const field);
+
+  bool uses(sym_id_t const func, sym_id_t const field) const;
+
+  /**\brief Number of functions that use field. */
+  uint32_t users(sym_id_t const field) const;
+
+  /**\brief Number of functions that use both fields. */
+  uint32_t co_users(sym_id_t const a, sym_id_t const b) const;
+
+  /**\brief The functions that use both fields. */
+  std::vector<sym_id_t> co_user_funcs(sym_id_t const a, sym_id_t const b) const;
+
+  /**\brief co_users for every pair of fields: n_fields() x n_fields(),
+   * row-major, in column order (see field()). The diagonal holds users(). */
+  std::vector<uint32_t> co_usage() const;
+
+  index_t n_funcs() const { return static_cast<index_t>(funcs_.size()); }
+
+  index_t n_fields() const { return static_cast<index_t>(fields_.size()); }
+
+  /**\brief Symbol of the field in column i. */
+  sym_id_t field(index_t const i) const { return fields_[i]; }
+
+  /**\brief Symbol of the function in row i. */
+  sym_id_t func(index_t const i) const { return funcs_[i]; }
+
+  /**\brief Add other's uses, passing its symbol ids through xlate. */
+  template <typename Xlate_Fn>
+  void merge(use_bit_matrix const & other, Xlate_Fn && xlate)
+  {
+    for(index_t c = 0; c < other.n_fields(); ++c) {
+      sym_id_t const fld = xlate(other.fields_[c]);
+      auto const & col(other.cols_[c]);
+      for(index_t w = 0; w < col.size(); ++w) {
+        for(uint64_t bits = col[w]; bits; bits &= bits - 1) {
+          index_t const r = w * 64 + count_trailing_zeros(bits);
+          insert(xlate(other.funcs_[r]), fld);
+        }
+      }
+    }
+    return;
+  }
+
+private:
+  static index_t count_trailing_zeros(uint64_t const bits);
+
+  /**\brief Column of field, or nullptr if it has no uses. */
+  std::vector<uint64_t> const * column(sym_id_t const field) const;
+
+  llvm::DenseMap<sym_id_t, index_t> func_idx_;
+  llvm::DenseMap<sym_id_t, index_t> field_idx_;
+  std::vector<sym_id_t> funcs_;
+  std::vector<sym_id_t> fields_;
+  std::vector<std::vector<uint64_t>> cols_;  // per field: bit per function
+};  // use_bit_matrix
+
+/**\brief Write the field x field co-usage matrix as tab-separated text: a
+ * header row of field names, then one row per field. Fields are sorted by
+ * name. */
+void
+write_co_usage(use_bit_matrix const & m,
+               symbol_table const & syms,
+               std::ostream & o);
+
+}  // namespace corct
+
+// End of file
@@ -71,6 +71,14 @@ in_vec(vec_t const & v, val_t const & val)
   return std::find(v.begin(), v.end(), val) != v.end();
 }
 
+/** \brief View a list of names as StringRefs, e.g. for hasAnyName(). The
+ * views are only valid while v is. */
+inline std::vector<llvm::StringRef>
+as_string_refs(vec_str const & v)
+{
+  return std::vector<llvm::StringRef>(v.begin(), v.end());
+}
+
 /** \brief Split a string s into substrings delimited by delim. */
 inline vec_str
 split(std::string const & s, char const delim)
@@ -149,7 +157,9 @@ infer_indent_level(clang::SourceLocation & loc, clang::SourceManager const & sm)
   is found, decide if the member expr is equal to its LHS.
 
   This finds both simple assignment and composite assignment
-  operations.
+  operations. It builds the TU's parent map on first use, which is costly
+  for large TUs; struct_field_user finds writes with a matcher instead (see
+  mk_struct_field_write_matcher).
   */
 inline bool
 is_on_lhs(clang::MemberExpr const * membr, clang::ASTContext & ctx)
@@ -162,14 +172,10 @@ is_on_lhs(clang::MemberExpr const * membr, clang::ASTContext & ctx)
   bool on_lhs(false);
   for(auto p : parents) {
     BinaryOperator const * bop = p.get<BinaryOperator>();
-    if(bop) {
-      if(bop->isAssignmentOp()) {
-        Expr const * e((Expr *)membr);
-        if(bop->getLHS() == e) { on_lhs = true; }
-      }
-      else if(bop->isCompoundAssignmentOp()) {
-        std::cout << "\t LOOK OUT!! Overlooked composite assignment!\n";
-      }
+    // isAssignmentOp() includes the compound assignments
+    if(bop && bop->isAssignmentOp()) {
+      Expr const * e((Expr *)membr);
+      if(bop->getLHS() == e) { on_lhs = true; }
     }  // if(bop)
   }    // for(p: parents)
   return on_lhs;
@@ -209,23 +215,6 @@ is_ancestor_of(clang::BinaryOperator const * e1,
   return is_parent;
 }
 
-/** \brief Is member expression part of an assignment? */
-inline bool
-is_part_of_assignment(clang::MemberExpr const * membr, clang::ASTContext & ctx)
-{
-  using namespace clang;
-  string_t const s_name = get_struct_name(*membr);
-  string_t const m_name = membr->getMemberDecl()->getNameAsString();
-  MemberExpr const & mem(*membr);
-  auto parents = ctx.getParents(mem);
-  bool bop_parent(false);
-  for(auto p : parents) {
-    BinaryOperator const * bop = p.get<BinaryOperator>();
-    if(bop) { bop_parent = true; }  // if(bop)
-  }
-  return bop_parent;
-}  // is_on_lhs
-
 /** \brief Decide if two VarDecl's are the same underlying variable.
 
  The idea of comparing canonical declarations is from the official Clang
@@ -0,0 +1,82 @@
+// call_graph_builder_test.cc
+// Oct 17, 2026
+
+#include "call_graph_builder.h"
+#include "gtest/gtest.h"
+#include "prep_code.h"
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+
+using namespace corct;
+using namespace clang;
+
+namespace {
+void
+run_builder(str_t_cr code, call_graph_builder & b)
+{
+  ASTUPtr ast;
+  ASTContext * pctx;
+  TranslationUnitDecl * decl;
+  std::tie(ast, pctx, decl) = prep_code(code);
+  finder_t finder;
+  finder.addMatcher(call_graph_builder::matcher(), &b);
+  finder.matchAST(*pctx);
+}
+
+/* Display names of each edge, "caller->callee", in USR order. */
+vec_str
+named_edges(call_graph_data const & g)
+{
+  vec_str es;
+  for(auto & e : g.edges) {
+    es.push_back(g.names.at(e.first) + "->" + g.names.at(e.second));
+  }
+  std::sort(es.begin(), es.end());
+  return es;
+}
+}  // namespace
+
+TEST(call_graph_builder, edges_by_usr)
+{
+  string_t const code =
+      "void h(){}\n"
+      "void g(){h(); h();}\n"
+      "namespace n { void f(){g(); h();} }\n"
+      "struct S { void m(){n::f();} };\n"
+      "void h(int){}\n"
+      "void k(){h(1);}\n";
+  call_graph_builder b;
+  run_builder(code, b);
+  EXPECT_EQ(5u, b.n_edges());
+  call_graph_data const g(b.data());
+  vec_str const exp = {"S::m->n::f", "g->h", "k->h", "n::f->g", "n::f->h"};
+  EXPECT_EQ(exp, named_edges(g));
+  // the two h overloads are different nodes
+  std::set<string_t> callees;
+  for(auto & e : g.edges) {
+    if(g.names.at(e.second) == "h") { callees.insert(e.second); }
+  }
+  EXPECT_EQ(2u, callees.size());
+}
+
+TEST(call_graph_builder, write_read_merge)
+{
+  call_graph_builder b1, b2;
+  run_builder("void h(){}\nvoid g(){h();}\n", b1);
+  run_builder("void h();\nvoid f(){h();}\n", b2);
+  std::stringstream s;
+  b2.write(s);
+  call_graph_builder b3;
+  EXPECT_TRUE(b3.read(s));
+  EXPECT_EQ(1u, b3.n_edges());
+  b1.merge(b3);
+  EXPECT_EQ(2u, b1.n_edges());
+  // both TUs' h are one node
+  call_graph_data const g(b1.data());
+  EXPECT_EQ(3u, g.names.size());
+  std::stringstream bad("edge\tonly-two-fields\n");
+  EXPECT_FALSE(b3.read(bad));
+}
+
+// End of file
@@ -0,0 +1,119 @@
+// call_graph_file_test.cc
+// Oct 17, 2026
+
+#include "call_graph_file.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+using namespace corct;
+
+namespace {
+/* main -> a -> b -> c, main -> d, b -> a (a cycle), e alone */
+call_graph_data
+mk_graph()
+{
+  call_graph_data g;
+  g.names = {{"u:main", "main"}, {"u:a", "ns::a"}, {"u:b", "b"},
+             {"u:c", "c"},       {"u:d", "d"},     {"u:e", "e"}};
+  g.edges = {{"u:main", "u:a"}, {"u:a", "u:b"}, {"u:b", "u:c"},
+             {"u:main", "u:d"}, {"u:b", "u:a"}};
+  return g;
+}
+
+bool
+round_trip(call_graph_data const & g, call_graph_file & f, string_t & err)
+{
+  std::stringstream s;
+  write_call_graph(g, s);
+  return f.open(llvm::MemoryBuffer::getMemBufferCopy(s.str()), err);
+}
+
+/* Names of nodes, comma-separated. */
+string_t
+names(call_graph_file const & f, call_graph_file::nodes_t const & ns)
+{
+  string_t s;
+  for(auto n : ns) { s += (s.empty() ? "" : ",") + f.name(n).str(); }
+  return s;
+}
+
+call_graph_file::node_t
+node(call_graph_file const & f, llvm::StringRef usr)
+{
+  call_graph_file::node_t n(0);
+  EXPECT_TRUE(f.find(usr, n)) << usr.str();
+  return n;
+}
+}  // namespace
+
+TEST(call_graph_file, round_trip)
+{
+  call_graph_file f;
+  string_t err;
+  ASSERT_TRUE(round_trip(mk_graph(), f, err)) << err;
+  EXPECT_EQ(6u, f.n_nodes());
+  EXPECT_EQ(5u, f.n_edges());
+  // nodes in USR order
+  EXPECT_EQ("u:a", f.usr(0));
+  EXPECT_EQ("ns::a", f.name(0));
+  EXPECT_EQ("main", f.name(5));
+  call_graph_file::node_t n(0);
+  EXPECT_FALSE(f.find("u:zz", n));
+  auto const r = f.callees(node(f, "u:main"));
+  EXPECT_EQ("ns::a,d", names(f, call_graph_file::nodes_t(r.first, r.second)));
+  auto const c = f.callers(node(f, "u:a"));
+  EXPECT_EQ("b,main", names(f, call_graph_file::nodes_t(c.first, c.second)));
+  EXPECT_EQ(call_graph_file::nodes_t{node(f, "u:b")}, f.find_name("b"));
+  EXPECT_TRUE(f.find_name("zz").empty());
+}
+
+TEST(call_graph_file, transitive)
+{
+  call_graph_file f;
+  string_t err;
+  ASSERT_TRUE(round_trip(mk_graph(), f, err)) << err;
+  // c's callers: b, and through the cycle a, b, and main
+  EXPECT_EQ("ns::a,b,main",
+            names(f, f.transitive_callers({node(f, "u:c")})));
+  // a is on a cycle, so it is its own transitive caller
+  EXPECT_EQ("ns::a,b,main",
+            names(f, f.transitive_callers({node(f, "u:a")})));
+  EXPECT_EQ("ns::a,b,c,d",
+            names(f, f.transitive_callees({node(f, "u:main")})));
+  EXPECT_EQ("", names(f, f.transitive_callers({node(f, "u:main")})));
+  EXPECT_EQ("", names(f, f.transitive_callees({node(f, "u:e")})));
+}
+
+TEST(call_graph_file, transitive_callers_with_stops)
+{
+  call_graph_file f;
+  string_t err;
+  ASSERT_TRUE(round_trip(mk_graph(), f, err)) << err;
+  call_graph_file::nodes_t const c{node(f, "u:c")};
+  // stopping at a: a is reached, but not its caller main
+  EXPECT_EQ("ns::a,b", names(f, f.transitive_callers(c, {node(f, "u:a")})));
+  // stopping at b: nothing past it
+  EXPECT_EQ("b", names(f, f.transitive_callers(c, {node(f, "u:b")})));
+  // a stopped root is not searched
+  EXPECT_EQ("", names(f, f.transitive_callers(c, c)));
+}
+
+TEST(call_graph_file, edge_only_nodes_and_bad_input)
+{
+  call_graph_data g;
+  g.edges = {{"u:x", "u:y"}};
+  call_graph_file f;
+  string_t err;
+  ASSERT_TRUE(round_trip(g, f, err)) << err;
+  EXPECT_EQ(2u, f.n_nodes());
+  EXPECT_EQ("u:y", f.name(1));  // unnamed: named by USR
+  EXPECT_FALSE(
+      f.open(llvm::MemoryBuffer::getMemBufferCopy("not a graph"), err));
+  std::stringstream s;
+  write_call_graph(mk_graph(), s);
+  string_t bytes(s.str());
+  bytes.resize(bytes.size() - 8);
+  EXPECT_FALSE(f.open(llvm::MemoryBuffer::getMemBufferCopy(bytes), err));
+}
+
+// End of file
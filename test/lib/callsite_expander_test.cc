@@ -379,4 +379,31 @@ TEST(expand_callsite, case6_method_expands)
   EXPECT_EQ(exp_reps, reps[fname]);
 }  // TEST(expand_callsite,expands)
 
+TEST(expand_callsite, combined_matcher_agrees)
+{
+  string_t const code =
+      "void f(int){return;} void h(){return;} "
+      "void g(){int i(42);f(i);h();f(2); return;}";
+  vec_str targs = {"f", "h"};
+  // one matcher per target
+  replacements_map_t reps;
+  expand_callsite ec(reps, targs, new_arg, false);
+  // one matcher for all targets
+  replacements_map_t reps_c;
+  expand_callsite ec_c(reps_c, targs, new_arg, false);
+  EXPECT_EQ(1u, ec_c.combined_fn_matchers().size());
+  EXPECT_EQ(0u, ec_c.combined_mthd_matchers().size());
+
+  ASTUPtr ast;
+  ASTContext * pctx;
+  TranslationUnitDecl * decl;
+  std::tie(ast, pctx, decl) = prep_code(code);
+  finder_t finder;
+  for(auto & m : ec.fn_matchers()) { finder.addMatcher(m, &ec); }
+  for(auto & m : ec_c.combined_fn_matchers()) { finder.addMatcher(m, &ec_c); }
+  finder.matchAST(*pctx);
+  EXPECT_EQ(3u, reps_c[fname].size());
+  EXPECT_EQ(reps[fname], reps_c[fname]);
+}  // TEST(expand_callsite,combined_matcher_agrees)
+
 // End of file
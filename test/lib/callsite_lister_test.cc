@@ -46,4 +46,78 @@ TEST(callsite_matcher, case1_BasicHit)
   EXPECT_EQ(n_matches, 1u);
 }
 
+TEST(callsite_lister, jsonl)
+{
+  string_t code =
+      "void h(){return;}\n"
+      "\n"
+      "void i(){return h();}\n"
+      "";
+  vec_str targets = {"h"};
+  std::stringstream s;
+  callsite_lister csl(targets, s);
+  csl.set_format(output_format::jsonl);
+  EXPECT_EQ(1u, run_case(code, csl));
+  string_t const exp =
+      "{\"kind\":\"call\",\"file\":\"input.cc\",\"line\":3,\"col\":17,"
+      "\"function\":\"i\",\"symbol\":\"h\",\"template_instantiation\":false}\n";
+  EXPECT_EQ(exp, s.str());
+}
+
+TEST(callsite_lister, every_call_site)
+{
+  // several calls per caller, several targets: one matcher finds them all
+  string_t code =
+      "void h(){return;}\n"
+      "void k(){return;}\n"
+      "void i(){h(); k(); h();}\n"
+      "void j(){k();}\n"
+      "";
+  vec_str targets = {"h", "k"};
+  std::stringstream s;
+  callsite_lister csl(targets, s);
+  EXPECT_EQ(1u, csl.matchers().size());
+  csl.set_print_calls(false);
+  EXPECT_EQ(4u, run_case(code, csl));
+  EXPECT_TRUE(s.str().empty());
+  csl.write_edges(s);
+  EXPECT_EQ("i\th\t2\ni\tk\t1\nj\tk\t1\n", s.str());
+  std::stringstream sj;
+  csl.set_format(output_format::jsonl);
+  csl.write_edges(sj);
+  EXPECT_EQ(
+      "{\"kind\":\"edge\",\"function\":\"i\",\"symbol\":\"h\","
+      "\"count\":2}\n",
+      sj.str().substr(0, sj.str().find('\n') + 1));
+  callsite_lister::named_calls_t const exp_calls = {{"i", {"h", "k"}},
+                                                    {"j", {"k"}}};
+  EXPECT_EQ(exp_calls, csl.named_calls());
+}
+
+TEST(callsite_lister, write_read_merge)
+{
+  string_t code =
+      "void h(){return;}\n"
+      "void i(){h(); h();}\n"
+      "";
+  vec_str targets = {"h"};
+  std::stringstream s;
+  callsite_lister csl(targets, s);
+  csl.set_print_calls(false);
+  EXPECT_EQ(2u, run_case(code, csl));
+  std::stringstream shard;
+  csl.write(shard);
+  EXPECT_EQ("n_calls\t2\nedge\ti\th\t2\n", shard.str());
+  // two shards' worth, each with its own symbol table
+  callsite_lister merged(targets, s);
+  EXPECT_TRUE(merged.read(shard));
+  merged.merge(csl);
+  EXPECT_EQ(4u, merged.m_num_calls);
+  std::stringstream edges;
+  merged.write_edges(edges);
+  EXPECT_EQ("i\th\t4\n", edges.str());
+  std::stringstream bad("edge\ti\th\n");
+  EXPECT_FALSE(merged.read(bad));
+}
+
 // End of file
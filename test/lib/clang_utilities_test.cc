@@ -64,49 +64,12 @@ TEST(utilities, on_lhs_case2)
   EXPECT_FALSE(on_lhs);
 }  // TEST(utilities,on_lhs){
 
-// is_part_of_assignment:
-struct Tests_PartOfAssgnmt : public callback_t {
-  void run(result_t const & result) override
-  {
-    MemberExpr const * mexpr = result.Nodes.getNodeAs<MemberExpr>("mexpr");
-    ASTContext * pctx = result.Context;
-    if(mexpr) { actually_part_ = is_part_of_assignment(mexpr, *pctx); }
-    return;
-  }  // run
-  bool actually_part_ = false;
-};
-
-bool
-run_case_part_of_assignment(str_t_cr code)
-{
-  ASTUPtr ast;
-  ASTContext * pctx;
-  TranslationUnitDecl * decl;
-  std::tie(ast, pctx, decl) = prep_code(code);
-  Tests_PartOfAssgnmt tpoa;
-  finder_t finder;
-  DeclarationMatcher m(hasDescendant(memberExpr().bind("mexpr")));
-  finder.addMatcher(m, &tpoa);
-  finder.match(*decl, *pctx);
-  return tpoa.actually_part_;
-}
-
-TEST(utilities, is_part_of_assignment_case1)
-{
-  // code includes exactly one member reference, and is part of assignment
-  string_t const code =
-      "struct S{ int i;};void g(int){return;}void f(){S s;s.i = 3;}";
-  bool is_part(run_case_part_of_assignment(code));
-  EXPECT_TRUE(is_part);
-}
-
-TEST(utilities, is_part_of_assignment_case2)
+TEST(utilities, on_lhs_case3)
 {
-  // code includes exactly one member reference, and is not part of assignment
-  string_t const code =
-      "struct S{ int i;};void g(int){return;}void f(){ S s; g(s.i);}";
-  bool is_part(run_case_part_of_assignment(code));
-  EXPECT_FALSE(is_part);
+  // a compound assignment also puts its target on the LHS
+  string_t const code = "struct S{  int i;};void f(){  S s = {1};  s.i += 2;}";
+  bool on_lhs = run_case_is_on_lhs(code);
+  EXPECT_TRUE(on_lhs);
 }
 
 // End of file
@@ -0,0 +1,157 @@
+// field_cluster_test.cc
+// Oct 17, 2026
+
+#include "field_cluster.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+using namespace corct;
+
+namespace {
+using index_t = use_matrix::index_t;
+
+/* Scenario 1 from the Haskell scorer's tests:
+Fnc |
+n1  | x   x
+n0  | x x x
+    --------- Fld */
+use_matrix::func_fields_t const scenario_1 = {
+    {"fnc_0", {"fld_0", "fld_1", "fld_2"}}, {"fnc_1", {"fld_0", "fld_2"}}};
+
+/* Scenario 2:
+Fnc |
+n3  |   x
+n2  |   x   x
+n1  | x   x x
+n0  | x x x
+    ----------- Fld */
+use_matrix::func_fields_t const scenario_2 = {
+    {"fnc_0", {"fld_0", "fld_1", "fld_2"}},
+    {"fnc_1", {"fld_0", "fld_2", "fld_3"}},
+    {"fnc_2", {"fld_1", "fld_3"}},
+    {"fnc_3", {"fld_1"}}};
+
+/* A scrambled matrix, the same every time. */
+use_matrix::func_fields_t
+pseudo_random_uses(uint32_t const n_funcs, uint32_t const n_fields)
+{
+  use_matrix::func_fields_t uses;
+  uint32_t x(12345);
+  for(uint32_t f = 0; f < n_funcs; ++f) {
+    for(uint32_t k = 0; k < 3; ++k) {
+      x = x * 1103515245u + 12345u;
+      uses["f" + std::to_string(f)].insert(
+          "m" + std::to_string((x >> 16) % n_fields));
+    }
+  }
+  return uses;
+}
+}  // namespace
+
+TEST(use_matrix, build)
+{
+  use_matrix m(scenario_2);
+  EXPECT_EQ(4u, m.n_funcs());
+  EXPECT_EQ(4u, m.n_fields());
+  EXPECT_EQ("fnc_2", m.func_name(2));
+  EXPECT_TRUE(m.uses(2, 3));
+  EXPECT_FALSE(m.uses(2, 2));
+  auto const fs = m.funcs_of(1);
+  EXPECT_EQ((std::vector<index_t>{0, 2, 3}),
+            std::vector<index_t>(fs.first, fs.second));
+  auto const ls = m.fields_of(1);
+  EXPECT_EQ((std::vector<index_t>{0, 2, 3}),
+            std::vector<index_t>(ls.first, ls.second));
+}
+
+TEST(use_matrix, from_field_use_file)
+{
+  named_field_uses_t const rhs = {{"a_t", {{"g", {"z"}}}},
+                                  {"b_t", {{"f", {"x", "y"}}, {"h", {"y"}}}}};
+  std::stringstream s;
+  write_field_uses({}, rhs, s);
+  field_use_file f;
+  string_t err;
+  ASSERT_TRUE(f.open(llvm::MemoryBuffer::getMemBufferCopy(s.str()), err));
+  uint32_t s_id(0);
+  ASSERT_TRUE(f.find(fu_dict::structs, "b_t", s_id));
+  use_matrix m(f, s_id);
+  EXPECT_EQ(2u, m.n_funcs());
+  EXPECT_EQ(2u, m.n_fields());
+  EXPECT_EQ("h", m.func_name(1));
+  EXPECT_EQ("y", m.field_name(1));
+  EXPECT_TRUE(m.uses(0, 0));
+  EXPECT_FALSE(m.uses(1, 0));
+}
+
+TEST(diagonalizer, haskell_scenarios)
+{
+  use_matrix m1(scenario_1);
+  diagonalizer d1(m1);
+  EXPECT_EQ(1, d1.score());
+  use_matrix m2(scenario_2);
+  diagonalizer d2(m2);
+  EXPECT_EQ(3, d2.score());
+  EXPECT_EQ(3, d2.full_score());
+}
+
+TEST(diagonalizer, swap_deltas_are_exact)
+{
+  use_matrix m(pseudo_random_uses(30, 12));
+  diagonalizer d(m);
+  for(index_t p = 0; p < m.n_fields(); ++p) {
+    for(index_t q = p + 1; q < m.n_fields(); q += 3) {
+      diagonalizer::score_t const before = d.score();
+      diagonalizer::score_t const delta = d.swap_fields_delta(p, q);
+      d.swap_fields(p, q);
+      EXPECT_EQ(before + delta, d.score());
+      EXPECT_EQ(d.full_score(), d.score());
+    }
+  }
+  for(index_t n = 0; n + 1 < m.n_funcs(); ++n) {
+    diagonalizer::score_t const before = d.score();
+    diagonalizer::score_t const delta = d.swap_funcs_delta(n);
+    d.swap_funcs(n);
+    EXPECT_EQ(before + delta, d.score());
+    EXPECT_EQ(d.full_score(), d.score());
+  }
+}
+
+TEST(diagonalizer, search)
+{
+  use_matrix m(pseudo_random_uses(40, 16));
+  diagonalizer d1(m), d4(m);
+  diagonalizer::score_t const start = d1.score();
+  uint32_t const n1 = d1.search(1000, 1);
+  uint32_t const n4 = d4.search(1000, 4);
+  EXPECT_GT(n1, 0u);
+  EXPECT_LT(d1.score(), start);
+  EXPECT_EQ(d1.full_score(), d1.score());
+  // same moves, whatever the number of threads
+  EXPECT_EQ(n1, n4);
+  EXPECT_EQ(d1.field_order(), d4.field_order());
+  EXPECT_EQ(d1.func_order(), d4.func_order());
+  // no single swap improves the result
+  for(index_t p = 0; p < m.n_fields(); ++p) {
+    for(index_t q = p + 1; q < m.n_fields(); ++q) {
+      EXPECT_GE(d1.swap_fields_delta(p, q), 0);
+    }
+  }
+}
+
+TEST(cluster, score_and_grow)
+{
+  use_matrix::func_fields_t const uses = {
+      {"f1", {"a", "b"}}, {"f2", {"a", "b"}}, {"f3", {"c"}}};
+  use_matrix m(uses);
+  // a = 0, b = 1, c = 2
+  EXPECT_EQ(4, cluster_score(m, {0, 1}));
+  EXPECT_EQ(-1, cluster_score(m, {0, 2}));
+  std::vector<index_t> c = {0};
+  EXPECT_EQ(4, grow_cluster(m, c, {1, 2}));
+  EXPECT_EQ((std::vector<index_t>{0, 1}), c);
+  std::vector<std::vector<index_t>> const exp = {{0, 1}, {2}};
+  EXPECT_EQ(exp, find_clusters(m, {0, 1, 2}));
+}
+
+// End of file
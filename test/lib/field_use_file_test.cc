@@ -0,0 +1,109 @@
+// field_use_file_test.cc
+// Oct 17, 2026
+
+#include "field_use_file.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <sstream>
+
+using namespace corct;
+
+namespace {
+/* Write uses, then open the bytes as a field_use_file. */
+bool
+round_trip(named_field_uses_t const & lhs,
+           named_field_uses_t const & rhs,
+           field_use_file & f,
+           string_t & err)
+{
+  std::stringstream s;
+  write_field_uses(lhs, rhs, s);
+  return f.open(llvm::MemoryBuffer::getMemBufferCopy(s.str()), err);
+}
+}  // namespace
+
+TEST(field_use_file, round_trip)
+{
+  named_field_uses_t const lhs = {{"cell_t", {{"update", {"x", "m"}}}}};
+  named_field_uses_t const rhs = {
+      {"cell_t", {{"update", {"x"}}, {"area", {"x", "y"}}}},
+      {"bas_t", {{"area", {"z"}}}}};
+  field_use_file f;
+  string_t err;
+  ASSERT_TRUE(round_trip(lhs, rhs, f, err)) << err;
+  EXPECT_EQ(2u, f.n_names(fu_dict::structs));
+  EXPECT_EQ(2u, f.n_names(fu_dict::funcs));
+  EXPECT_EQ(4u, f.n_names(fu_dict::fields));
+  // dictionaries are sorted
+  EXPECT_EQ("bas_t", f.name(fu_dict::structs, 0));
+  EXPECT_EQ("update", f.name(fu_dict::funcs, 1));
+  EXPECT_EQ("z", f.name(fu_dict::fields, 3));
+  uint32_t id(99);
+  EXPECT_TRUE(f.find(fu_dict::fields, "x", id));
+  EXPECT_EQ(1u, id);
+  EXPECT_FALSE(f.find(fu_dict::fields, "w", id));
+  // rows sorted by struct, function, field, is_lhs
+  ASSERT_EQ(6u, f.n_uses());
+  std::stringstream rows;
+  for(uint64_t i = 0; i < f.n_uses(); ++i) {
+    rows << f.name(fu_dict::structs, f.struct_ids()[i]).str() << " "
+         << f.name(fu_dict::funcs, f.func_ids()[i]).str() << " "
+         << f.name(fu_dict::fields, f.field_ids()[i]).str() << " "
+         << int(f.is_lhs()[i]) << "\n";
+  }
+  string_t const exp =
+      "bas_t area z 0\n"
+      "cell_t area x 0\n"
+      "cell_t area y 0\n"
+      "cell_t update m 1\n"
+      "cell_t update x 0\n"
+      "cell_t update x 1\n";
+  EXPECT_EQ(exp, rows.str());
+}
+
+TEST(field_use_file, empty)
+{
+  field_use_file f;
+  string_t err;
+  ASSERT_TRUE(round_trip({}, {}, f, err)) << err;
+  EXPECT_EQ(0u, f.n_uses());
+  EXPECT_EQ(0u, f.n_names(fu_dict::funcs));
+}
+
+TEST(field_use_file, rejects_garbage)
+{
+  field_use_file f;
+  string_t err;
+  EXPECT_FALSE(f.open(llvm::MemoryBuffer::getMemBufferCopy("short"), err));
+  EXPECT_FALSE(err.empty());
+  string_t junk(256, 'x');
+  EXPECT_FALSE(f.open(llvm::MemoryBuffer::getMemBufferCopy(junk), err));
+  EXPECT_EQ(0u, f.n_uses());
+}
+
+TEST(field_use_file, rejects_corrupt_dictionaries_and_ids)
+{
+  named_field_uses_t const lhs = {{"cell_t", {{"update", {"x", "m"}}}}};
+  std::stringstream s;
+  write_field_uses(lhs, {}, s);
+  string_t const good(s.str());
+  field_use_header h;
+  std::memcpy(&h, good.data(), sizeof(h));
+  field_use_file f;
+  string_t err;
+  // a field id past the end of the field dictionary
+  string_t bad_id(good);
+  uint32_t const n_fields = static_cast<uint32_t>(h.n_names[2]);
+  std::memcpy(&bad_id[h.columns[2]], &n_fields, sizeof(n_fields));
+  EXPECT_FALSE(f.open(llvm::MemoryBuffer::getMemBufferCopy(bad_id), err));
+  EXPECT_EQ(0u, f.n_uses());
+  // field name offsets that go backwards
+  string_t bad_offsets(good);
+  uint32_t const past_end = 1000;
+  std::memcpy(&bad_offsets[h.name_offsets[2]], &past_end, sizeof(past_end));
+  EXPECT_FALSE(f.open(llvm::MemoryBuffer::getMemBufferCopy(bad_offsets), err));
+  EXPECT_FALSE(err.empty());
+  EXPECT_TRUE(f.open(llvm::MemoryBuffer::getMemBufferCopy(good), err)) << err;
+}
+
+// End of file
@@ -0,0 +1,69 @@
+// fix_export_test.cc
+// Oct 17, 2026
+
+#include "fix_export.h"
+#include "gtest/gtest.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include <sstream>
+
+using namespace corct;
+
+TEST(fix_export, fixes_path)
+{
+  EXPECT_EQ("out/000042-a.cc.yaml", fixes_path("out", 42, "/src/x/a.cc"));
+}
+
+TEST(fix_export, write_fixes)
+{
+  vec_repl const reps = {replacement_t("a.h", 21, 1, "cfg.G")};
+  std::stringstream o;
+  write_fixes(o, "a.cc", reps);
+  string_t const yaml(o.str());
+  EXPECT_NE(string_t::npos, yaml.find("MainSourceFile:"));
+  EXPECT_NE(string_t::npos, yaml.find("FilePath:"));
+  EXPECT_NE(string_t::npos, yaml.find("cfg.G"));
+}
+
+TEST(fix_export, export_and_read)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-fixes", dir));
+  string_t const d(dir.str().str());
+  replacements_map_t a, b, c;
+  llvm::consumeError(a["a.h"].add(replacement_t("a.h", 21, 1, "cfg.G")));
+  llvm::consumeError(a["a.cc"].add(replacement_t("a.cc", 3, 0, "x")));
+  // the same header edit from b.cc, and one that conflicts with it from c.cc
+  llvm::consumeError(b["a.h"].add(replacement_t("a.h", 21, 1, "cfg.G")));
+  llvm::consumeError(c["a.h"].add(replacement_t("a.h", 20, 2, "y")));
+  string_t err;
+  ASSERT_TRUE(export_fixes(d, 0, "/src/a.cc", a, err)) << err;
+  ASSERT_TRUE(export_fixes(d, 1, "/src/b.cc", b, err)) << err;
+  ASSERT_TRUE(export_fixes(d, 2, "/src/c.cc", c, err)) << err;
+  vec_str const files(expand_fixes_dirs({d}));
+  ASSERT_EQ(3u, files.size());
+  EXPECT_EQ(fixes_path(d, 0, "a.cc"), files[0]);
+  replacement_set set;
+  for(auto & f : files) { EXPECT_TRUE(read_fixes(f, set, err)) << err; }
+  EXPECT_EQ(2u, set.n_edits());
+  EXPECT_EQ(1u, set.n_duplicates());
+  ASSERT_EQ(1u, set.conflicts().size());
+  EXPECT_EQ("/src/c.cc", set.syms().name(set.conflicts()[0].dropped.source));
+  EXPECT_FALSE(read_fixes(d + "/missing.yaml", set, err));
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST(fix_export, parse_several_documents)
+{
+  std::stringstream s;
+  write_fixes(s, "x (a.cc)", {replacement_t("a.h", 21, 1, "cfg.G")});
+  write_fixes(s, "y (a.cc)", {replacement_t("a.h", 30, 1, "cfg.H")});
+  replacement_set set;
+  string_t err;
+  ASSERT_TRUE(read_fixes(s, set, err)) << err;
+  EXPECT_EQ(2u, set.n_edits());
+  EXPECT_TRUE(parse_fixes("", set, err));
+  EXPECT_FALSE(parse_fixes("[ not fixes", set, err));
+}
+
+// End of file
@@ -0,0 +1,159 @@
+// function_scope_test.cc
+// Oct 17, 2026
+
+#include "function_scope.h"
+#include "global_matchers.h"
+#include "gtest/gtest.h"
+#include "prep_code.h"
+#include "struct_field_user.h"
+#include <sstream>
+#include <tuple>
+
+using namespace corct;
+using namespace clang;
+using namespace clang::ast_matchers;
+
+namespace {
+/* Run the field user's matchers with hasAncestor, or with a
+ * function_scope_finder. */
+void
+run_sfu(str_t_cr code, struct_field_user & sfu, bool const scoped)
+{
+  ASTUPtr ast;
+  ASTContext * pctx;
+  TranslationUnitDecl * decl;
+  std::tie(ast, pctx, decl) = prep_code(code);
+  if(!scoped) {
+    finder_t finder;
+    for(auto & m : sfu.matchers()) { finder.addMatcher(m, &sfu); }
+    finder.matchAST(*pctx);
+    return;
+  }
+  function_scope_finder fsf;
+  for(auto & m : sfu.matchers(false)) { fsf.add_matcher(m, &sfu); }
+  sfu.use_scope(fsf.scope());
+  fsf.match_ast(*pctx);
+  return;
+}
+
+void
+run_gp(str_t_cr code, Global_Printer & gp, bool const scoped)
+{
+  ASTUPtr ast;
+  ASTContext * pctx;
+  TranslationUnitDecl * decl;
+  std::tie(ast, pctx, decl) = prep_code(code);
+  clearLocation();  // print full locations
+  if(!scoped) {
+    finder_t finder;
+    finder.addMatcher(all_global_var_matcher(), &gp);
+    finder.matchAST(*pctx);
+    return;
+  }
+  function_scope_finder fsf;
+  fsf.add_matcher(mk_scoped_global_var_matcher(), &gp);
+  gp.use_scope(fsf.scope());
+  fsf.match_ast(*pctx);
+  return;
+}
+}  // namespace
+
+TEST(function_scope_finder, struct_field_user_same_results)
+{
+  string_t const code =
+      "struct foo_t{int i;int j;int k;};"
+      "foo_t g_foo;"
+      "int g_i = g_foo.i;"  // not in a function: no use
+      "void f1(foo_t & f){f.i = f.j;}"
+      "template <typename T> void ft(foo_t & f, T t){f.j = t;}"
+      "void f2(foo_t & f){ft(f, 1);}"
+      "void h(foo_t & f){auto l = [&f](){f.k = 2;}; l();}"
+      "void m(){struct L{void go(foo_t & f){f.i = 3;}};}";
+  vec_str ts = {"foo_t"};
+  struct_field_user by_ancestor(ts);
+  struct_field_user by_scope(ts);
+  run_sfu(code, by_ancestor, false);
+  run_sfu(code, by_scope, true);
+  auto const lhs(by_scope.lhs_uses());
+  EXPECT_EQ(by_ancestor.lhs_uses(), lhs);
+  EXPECT_EQ(by_ancestor.non_lhs_uses(), by_scope.non_lhs_uses());
+  EXPECT_EQ(by_ancestor.n_matches_, by_scope.n_matches_);
+  struct_field_user::named_func_mem_map_t const exp_lhs = {
+      {"f1", {"i"}}, {"ft", {"j"}}, {"go", {"i"}}, {"h", {"k"}}};
+  ASSERT_EQ(1u, lhs.size());
+  EXPECT_EQ(exp_lhs, lhs.begin()->second);
+}
+
+TEST(function_scope_finder, Global_Printer_same_results)
+{
+  string_t const code =
+      "int g1; int g2 = g1;"
+      "void f(){g2 = g1;}"
+      "struct s{void m(){g1 = 2;}};";
+  std::stringstream s_anc, s_scope;
+  Global_Printer by_ancestor(s_anc);
+  Global_Printer by_scope(s_scope);
+  run_gp(code, by_ancestor, false);
+  run_gp(code, by_scope, true);
+  EXPECT_EQ(s_anc.str(), s_scope.str());
+  EXPECT_EQ(by_ancestor.n_matches_, by_scope.n_matches_);
+  Global_Printer::named_uses_t const exp_uses = {{"f", {"g1", "g2"}},
+                                                 {"m", {"g1"}}};
+  EXPECT_EQ(exp_uses, by_scope.named_uses());
+}
+
+TEST(function_scope_finder, lambdas_belong_to_the_enclosing_function)
+{
+  // with or without parameters, a lambda's uses are its enclosing function's
+  string_t const s_code =
+      "struct foo_t{int i;int j;};"
+      "int g(foo_t & f){"
+      "  auto l = [](foo_t & s){return s.i;};"
+      "  auto m = [&f](){return f.j;};"
+      "  return l(f) + m();}";
+  vec_str ts = {"foo_t"};
+  struct_field_user by_ancestor(ts);
+  struct_field_user by_scope(ts);
+  run_sfu(s_code, by_ancestor, false);
+  run_sfu(s_code, by_scope, true);
+  auto const non_lhs(by_scope.non_lhs_uses());
+  EXPECT_EQ(by_ancestor.non_lhs_uses(), non_lhs);
+  EXPECT_EQ(by_ancestor.n_matches_, by_scope.n_matches_);
+  struct_field_user::named_func_mem_map_t const exp = {{"g", {"i", "j"}}};
+  ASSERT_EQ(1u, non_lhs.size());
+  EXPECT_EQ(exp, non_lhs.begin()->second);
+
+  string_t const g_code =
+      "int g1; int g2;"
+      "void h(){auto l = [](int x){return x + g1;};"
+      "  auto m = [](){return g2;}; l(m());}";
+  std::stringstream s_anc, s_scope;
+  Global_Printer gp_ancestor(s_anc);
+  Global_Printer gp_scope(s_scope);
+  run_gp(g_code, gp_ancestor, false);
+  run_gp(g_code, gp_scope, true);
+  EXPECT_EQ(gp_ancestor.named_uses(), gp_scope.named_uses());
+  Global_Printer::named_uses_t const exp_uses = {{"h", {"g1", "g2"}}};
+  EXPECT_EQ(exp_uses, gp_scope.named_uses());
+}
+
+TEST(function_scope_finder, back_in_outer_function_after_local_class)
+{
+  // after L::go, the traversal goes on in n without reaching a declaration
+  string_t const code =
+      "int g1; int g2;"
+      "void n(){struct L{void go(){g2 = 1;}}; g1 = 3;}"
+      "int g3 = g1;";
+  std::stringstream s_anc, s_scope;
+  Global_Printer by_ancestor(s_anc);
+  Global_Printer by_scope(s_scope);
+  run_gp(code, by_ancestor, false);
+  run_gp(code, by_scope, true);
+  EXPECT_EQ(by_ancestor.named_uses(), by_scope.named_uses());
+  EXPECT_EQ(by_ancestor.n_matches_, by_scope.n_matches_);
+  Global_Printer::named_uses_t const exp_uses = {{"go", {"g2"}},
+                                                 {"n", {"g1"}}};
+  EXPECT_EQ(exp_uses, by_scope.named_uses());
+}
+
+// End of file
@@ -98,4 +98,25 @@ TEST(function_sig_exp, expands_case3)
   run_case_fse(code, fse, exp_repls);
 }
 
+TEST(function_sig_exp, combined_matcher)
+{
+  string_t const code = "void p(int i=42); void q(int foo, double pi = 3.2);";
+  replacements_map_t reps;
+  vec_str ftargs = {"p", "q"};
+  FSE fse(reps, ftargs, new_param, false);
+  replacements_t exp_repls;
+  if(exp_repls.add({fname, 7u, 0u, npc})) { HERE("add replacement failed"); }
+  if(exp_repls.add({fname, 34u, 0u, npc})) { HERE("add replacement failed"); }
+  ASTUPtr ast;
+  ASTContext * pctx;
+  TranslationUnitDecl * decl;
+  std::tie(ast, pctx, decl) = prep_code(code);
+  auto ms(fse.combined_fn_matchers());
+  EXPECT_EQ(1u, ms.size());
+  finder_t finder;
+  for(auto & m : ms) { finder.addMatcher(m, &fse); }
+  finder.matchAST(*pctx);
+  EXPECT_EQ(exp_repls, fse.get_replacements(fname));
+}
+
 // End of file
@@ -203,6 +203,36 @@ TEST(Global_Printer, case2_HitAllGlobals)
   uint32_t const exp_matches(2u);
   EXPECT_EQ(exp_str, s.str());
   EXPECT_EQ(n_matches, exp_matches);
+  Global_Printer::named_uses_t exp_uses = {{"f", {"g_f", "global_i"}}};
+  EXPECT_EQ(exp_uses, gp.named_uses());
+  // round trip through a shard, and merge with another printer's uses
+  std::stringstream shard;
+  gp.write(shard);
+  EXPECT_EQ("n_matches\t2\nuse\tf\tg_f\nuse\tf\tglobal_i\n",
+            shard.str());
+  Global_Printer merged(s);
+  EXPECT_TRUE(merged.read(shard));
+  merged.merge(gp);
+  EXPECT_EQ(4u, merged.n_matches_);
+  EXPECT_EQ(exp_uses, merged.named_uses());
+}
+
+TEST(Global_Printer, case2_jsonl)
+{
+  std::stringstream s;
+  Global_Printer gp(s);
+  gp.set_format(output_format::jsonl);
+  string_t const code =
+      "int global_i; double g_f;void f(){  global_i = 1;g_f = 3.14;}";
+  string_t exp_str =
+      "{\"kind\":\"global_ref\",\"file\":\"input.cc\",\"line\":1,\"col\":37,"
+      "\"function\":\"f\",\"symbol\":\"global_i\"}\n"
+      "{\"kind\":\"global_ref\",\"file\":\"input.cc\",\"line\":1,\"col\":50,"
+      "\"function\":\"f\",\"symbol\":\"g_f\"}\n";
+  uint32_t const n_matches =
+      run_GP_case(code, gp, []() { return mk_global_var_matcher(""); });
+  EXPECT_EQ(2u, n_matches);
+  EXPECT_EQ(exp_str, s.str());
 }
 
 TEST(Global_Printer, case3_HitOnlySpecdVar)
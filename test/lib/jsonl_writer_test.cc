@@ -0,0 +1,26 @@
+// jsonl_writer_test.cc
+// Oct 17, 2026
+
+#include "gtest/gtest.h"
+#include "jsonl_writer.h"
+#include <sstream>
+
+using namespace corct;
+
+TEST(jsonl_writer, escapes_strings)
+{
+  std::stringstream s;
+  write_json_string(s, "a\"b\\c\nd\te\x01");
+  EXPECT_EQ("\"a\\\"b\\\\c\\nd\\te\\u0001\"", s.str());
+}
+
+TEST(jsonl_writer, record_fields_in_order)
+{
+  std::stringstream s;
+  jsonl_record rec(s);
+  rec.str("kind", "call").num("line", 3).boolean("b", false).end();
+  jsonl_record(s).end();
+  EXPECT_EQ("{\"kind\":\"call\",\"line\":3,\"b\":false}\n{}\n", s.str());
+}
+
+// End of file
@@ -0,0 +1,51 @@
+// match_profile_test.cc
+// Oct 17, 2026
+
+#include "gtest/gtest.h"
+#include "match_profile.h"
+#include <sstream>
+
+using namespace corct;
+
+TEST(match_profile, accumulates_matchers)
+{
+  match_profile p;
+  p.add_matcher("m#0", 1.0, 0.5, 3);
+  p.add_matcher("m#0", 2.0, 0.25, 4);
+  p.add_matcher("n#0", 0.5, 0.0, 1);
+  ASSERT_EQ(2u, p.matchers().size());
+  auto const & m = p.matchers().at("m#0");
+  EXPECT_DOUBLE_EQ(3.0, m.match_s);
+  EXPECT_DOUBLE_EQ(0.75, m.callback_s);
+  EXPECT_EQ(7u, m.n_matches);
+  p.clear();
+  EXPECT_TRUE(p.matchers().empty());
+}
+
+TEST(match_profile, write_largest_first)
+{
+  match_profile p;
+  p.add_matcher("small#0", 0.5, 0.0, 1);
+  p.add_matcher("big#0", 2.0, 1.0, 9);
+  match_profile::tu_row a, b;
+  a.source = "a.cc";
+  a.total_s = 1.0;
+  a.match_s = 0.25;
+  b.source = "b.cc";
+  b.total_s = 3.0;
+  b.match_s = 1.0;
+  p.add_tu(a);
+  p.add_tu(b);
+  std::stringstream s;
+  p.write(s);
+  string_t const exp =
+      "# matcher\tmatch_s\tcallback_s\tmatches\n"
+      "big#0\t2.000000\t1.000000\t9\n"
+      "small#0\t0.500000\t0.000000\t1\n"
+      "# translation_unit\ttotal_s\tparse_s\tmatch_s\tcallback_s\n"
+      "b.cc\t3.000000\t2.000000\t1.000000\t0.000000\n"
+      "a.cc\t1.000000\t0.750000\t0.250000\t0.000000\n";
+  EXPECT_EQ(exp, s.str());
+}
+
+// End of file
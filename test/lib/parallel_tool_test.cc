@@ -0,0 +1,380 @@
+// parallel_tool_test.cc
+// Oct 17, 2026
+
+#include "parallel_tool.h"
+#include "tu_schedule.h"
+#include "gtest/gtest.h"
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+using namespace corct;
+using namespace clang;
+using namespace clang::ast_matchers;
+
+namespace {
+/* Print the name of each function defined in the main file. */
+struct Fn_Namer : public callback_t {
+  auto matcher() const
+  {
+    return functionDecl(isDefinition(), isExpansionInMainFile()).bind("f");
+  }
+
+  void run(result_t const & result) override
+  {
+    FunctionDecl const * f = result.Nodes.getNodeAs<FunctionDecl>("f");
+    if(f) {
+      o_ << f->getNameAsString() << "\n";
+      matched_++;
+    }
+    return;
+  }
+
+  explicit Fn_Namer(std::ostream & o) : o_(o) {}
+
+  std::ostream & o_;
+  uint32_t matched_ = 0;
+};  // Fn_Namer
+
+/* Run Fn_Namer over three small virtual files with n_jobs workers */
+int
+run_namers(uint32_t const n_jobs, std::ostream & o, uint32_t & n_matched)
+{
+  clang::tooling::FixedCompilationDatabase comps("/", vec_str{});
+  vec_str sources = {"/a.cc", "/b.cc", "/c.cc"};
+  parallel_tool ptool(comps, sources, n_jobs);
+  ptool.map_virtual_file("/a.cc", "void a1(){} void a2(){}");
+  ptool.map_virtual_file("/b.cc", "void b1(){}");
+  ptool.map_virtual_file("/c.cc", "void c1(){} int c2(){return 0;}");
+  std::vector<uint32_t> counts(ptool.n_jobs(), 0);
+  int const status = ptool.run(
+      [&](tu_context & tu) {
+        Fn_Namer namer(tu.out);
+        tu.add_matcher(namer.matcher(), &namer);
+        int const rslt = tu.run();
+        counts[tu.worker] += namer.matched_;
+        return rslt;
+      },
+      o);
+  n_matched = 0;
+  for(auto c : counts) { n_matched += c; }
+  return status;
+}  // run_namers
+}  // namespace
+
+TEST(parallel_tool, instantiate)
+{
+  clang::tooling::FixedCompilationDatabase comps("/", vec_str{});
+  parallel_tool ptool(comps, {"/a.cc"}, 4);
+  EXPECT_EQ(4u, ptool.n_jobs());
+  EXPECT_EQ(1u, ptool.sources().size());
+}
+
+TEST(parallel_tool, serial_run)
+{
+  std::stringstream s;
+  uint32_t n_matched(0);
+  EXPECT_EQ(0, run_namers(1, s, n_matched));
+  EXPECT_EQ(5u, n_matched);
+  EXPECT_EQ("a1\na2\nb1\nc1\nc2\n", s.str());
+}
+
+TEST(parallel_tool, output_in_source_order)
+{
+  std::stringstream s;
+  uint32_t n_matched(0);
+  EXPECT_EQ(0, run_namers(3, s, n_matched));
+  EXPECT_EQ(5u, n_matched);
+  EXPECT_EQ("a1\na2\nb1\nc1\nc2\n", s.str());
+}
+
+TEST(parallel_tool, cached_run_replays)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-cache", dir));
+  clang::tooling::FixedCompilationDatabase comps("/", vec_str{});
+  vec_str sources = {"/a.cc", "/b.cc"};
+  auto run_once = [&](std::ostream & o, uint32_t & n_matched,
+                      uint32_t & n_replayed, str_t_cr b_code) {
+    parallel_tool ptool(comps, sources, 2);
+    ptool.map_virtual_file("/a.cc", "void a1(){} void a2(){}");
+    ptool.map_virtual_file("/b.cc", b_code);
+    ptool.use_cache(dir.str().str());
+    ptool.add_cache_salt("test");
+    n_matched = 0;
+    n_replayed = 0;
+    std::mutex m;
+    int const status = ptool.run(
+        [&](tu_context & tu) {
+          Fn_Namer namer(tu.out);
+          tu.add_matcher(namer.matcher(), &namer);
+          int const rslt = tu.run();
+          tu.data() << namer.matched_;
+          std::lock_guard<std::mutex> l(m);
+          n_matched += namer.matched_;
+          return rslt;
+        },
+        [&](tu_context & tu, std::istream & data) {
+          uint32_t n(0);
+          data >> n;
+          std::lock_guard<std::mutex> l(m);
+          n_replayed += n;
+        },
+        o);
+    EXPECT_EQ(0, status);
+    return ptool.cache_hits();
+  };
+  uint32_t n_matched(0), n_replayed(0);
+  std::stringstream s1, s2, s3;
+  EXPECT_EQ(0u, run_once(s1, n_matched, n_replayed, "void b1(){}"));
+  EXPECT_EQ(3u, n_matched);
+  // nothing changed: both TUs replayed
+  EXPECT_EQ(2u, run_once(s2, n_matched, n_replayed, "void b1(){}"));
+  EXPECT_EQ(0u, n_matched);
+  EXPECT_EQ(3u, n_replayed);
+  EXPECT_EQ(s1.str(), s2.str());
+  // b.cc changed: only a.cc replayed
+  EXPECT_EQ(1u, run_once(s3, n_matched, n_replayed, "void b2(){}"));
+  EXPECT_EQ(1u, n_matched);
+  EXPECT_EQ(2u, n_replayed);
+  EXPECT_EQ("a1\na2\nb2\n", s3.str());
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST(parallel_tool, journal_resumes)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-journal", dir));
+  clang::tooling::FixedCompilationDatabase comps("/", vec_str{});
+  vec_str sources = {"/a.cc", "/b.cc"};
+  auto run_once = [&](std::ostream & o, uint32_t & n_matched,
+                      uint32_t & n_replayed, str_t_cr b_code,
+                      bool const resume, size_t & n_resumed) {
+    parallel_tool ptool(comps, sources, 2);
+    ptool.map_virtual_file("/a.cc", "void a1(){} void a2(){}");
+    ptool.map_virtual_file("/b.cc", b_code);
+    ptool.use_journal(dir.str().str(), resume);
+    EXPECT_TRUE(ptool.keeps_tu_data());
+    n_matched = 0;
+    n_replayed = 0;
+    std::mutex m;
+    int const status = ptool.run(
+        [&](tu_context & tu) {
+          Fn_Namer namer(tu.out);
+          tu.add_matcher(namer.matcher(), &namer);
+          int const rslt = tu.run();
+          tu.data() << namer.matched_;
+          std::lock_guard<std::mutex> l(m);
+          n_matched += namer.matched_;
+          return rslt;
+        },
+        [&](tu_context & tu, std::istream & data) {
+          uint32_t n(0);
+          data >> n;
+          std::lock_guard<std::mutex> l(m);
+          n_replayed += n;
+        },
+        o);
+    n_resumed = ptool.n_resumed();
+    return status;
+  };
+  uint32_t n_matched(0), n_replayed(0);
+  size_t n_resumed(0);
+  std::stringstream s1, s2, s3;
+  // b.cc fails, as if the run had been killed before it finished
+  EXPECT_EQ(1, run_once(s1, n_matched, n_replayed, "void b1(){", false,
+                        n_resumed));
+  EXPECT_EQ(0u, n_resumed);
+  // resume: only b.cc is processed; a.cc's output and data come back
+  EXPECT_EQ(0, run_once(s2, n_matched, n_replayed, "void b1(){}", true,
+                        n_resumed));
+  EXPECT_EQ(1u, n_resumed);
+  EXPECT_EQ(1u, n_matched);
+  EXPECT_EQ(2u, n_replayed);
+  EXPECT_EQ("a1\na2\nb1\n", s2.str());
+  // without -resume, the journal starts over
+  EXPECT_EQ(0, run_once(s3, n_matched, n_replayed, "void b1(){}", false,
+                        n_resumed));
+  EXPECT_EQ(0u, n_resumed);
+  EXPECT_EQ(3u, n_matched);
+  EXPECT_EQ("a1\na2\nb1\n", s3.str());
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST(parallel_tool, largest_first)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-costs", dir));
+  llvm::SmallString<128> cost_path(dir);
+  llvm::sys::path::append(cost_path, "costs");
+  clang::tooling::FixedCompilationDatabase comps("/", vec_str{});
+  vec_str sources = {"/a.cc", "/b.cc", "/c.cc"};
+  parallel_tool ptool(comps, sources, 2);
+  ptool.map_virtual_file("/a.cc", "void a1(){}");
+  ptool.map_virtual_file("/b.h", "void b0();");
+  ptool.map_virtual_file("/b.cc", "#include \"/b.h\"\nvoid b1(){}");
+  ptool.map_virtual_file("/c.cc", "void c1(){} void c2(){} void c3(){}");
+  // estimated: b.cc has an #include, then c.cc is longest
+  EXPECT_EQ((std::vector<size_t>{1, 2, 0}), ptool.schedule());
+  ptool.use_cost_file(cost_path.str().str());
+  std::stringstream s;
+  int const status = ptool.run(
+      [&](tu_context & tu) {
+        Fn_Namer namer(tu.out);
+        tu.add_matcher(namer.matcher(), &namer);
+        return tu.run();
+      },
+      s);
+  EXPECT_EQ(0, status);
+  // output is still in source order
+  EXPECT_EQ("a1\nb1\nc1\nc2\nc3\n", s.str());
+  // every TU's time was recorded, and now orders the schedule
+  tu_costs recorded;
+  ASSERT_TRUE(recorded.load(cost_path.str().str()));
+  EXPECT_EQ(3u, recorded.size());
+  recorded.set("/a.cc", 10.0);
+  ASSERT_TRUE(recorded.save(cost_path.str().str()));
+  EXPECT_EQ(0u, ptool.schedule()[0]);
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST(parallel_tool, profiled_run)
+{
+  clang::tooling::FixedCompilationDatabase comps("/", vec_str{});
+  vec_str sources = {"/a.cc", "/b.cc"};
+  parallel_tool ptool(comps, sources, 2);
+  ptool.map_virtual_file("/a.cc", "void a1(){} void a2(){}");
+  ptool.map_virtual_file("/b.cc", "void b1(){}");
+  std::stringstream prof;
+  ptool.enable_profiling(prof);
+  std::stringstream s;
+  int const status = ptool.run(
+      [&](tu_context & tu) {
+        Fn_Namer namer(tu.out);
+        tu.add_matcher(namer.matcher(), &namer);
+        return tu.run();
+      },
+      s);
+  EXPECT_EQ(0, status);
+  // profiling doesn't change what the callbacks see
+  EXPECT_EQ("a1\na2\nb1\n", s.str());
+  auto const & matchers = ptool.profile().matchers();
+  ASSERT_EQ(1u, matchers.size());
+  EXPECT_EQ("callback#0", matchers.begin()->first);
+  EXPECT_EQ(3u, matchers.begin()->second.n_matches);
+  ASSERT_EQ(2u, ptool.profile().tus().size());
+  for(auto & tu : ptool.profile().tus()) {
+    EXPECT_LE(tu.match_s, tu.total_s);
+    EXPECT_LE(tu.callback_s, tu.match_s);
+  }
+  EXPECT_NE(string_t::npos, prof.str().find("callback#0"));
+  EXPECT_NE(string_t::npos, prof.str().find("/b.cc"));
+}
+
+TEST(parallel_tool, profiled_callbacks_sharing_an_id)
+{
+  clang::tooling::FixedCompilationDatabase comps("/", vec_str{});
+  parallel_tool ptool(comps, {"/a.cc"}, 1);
+  ptool.map_virtual_file("/a.cc", "void a1(){} void a2(){}");
+  std::stringstream prof;
+  ptool.enable_profiling(prof);
+  std::stringstream s;
+  int const status = ptool.run(
+      [&](tu_context & tu) {
+        // two callbacks, both with the default getID()
+        Fn_Namer n1(tu.out), n2(tu.out);
+        tu.add_matcher(n1.matcher(), &n1);
+        tu.add_matcher(n2.matcher(), &n2);
+        return tu.run();
+      },
+      s);
+  EXPECT_EQ(0, status);
+  // each gets its own row, rather than both landing on "callback#0"
+  auto const & matchers = ptool.profile().matchers();
+  ASSERT_EQ(2u, matchers.size());
+  EXPECT_EQ(1u, matchers.count("callback#0"));
+  EXPECT_EQ(1u, matchers.count("callback#1"));
+  for(auto & m : matchers) { EXPECT_EQ(2u, m.second.n_matches); }
+}
+
+TEST(parallel_tool, expand_ast_dirs)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-asts", dir));
+  llvm::SmallString<128> sub(dir), b(dir), a(dir), other(dir);
+  llvm::sys::path::append(sub, "sub");
+  ASSERT_FALSE(llvm::sys::fs::create_directory(sub));
+  llvm::sys::path::append(b, "b.ast");
+  llvm::sys::path::append(a, "sub", "a.ast");
+  llvm::sys::path::append(other, "c.cc");
+  for(auto & f : {b, a, other}) {
+    int fd(-1);
+    ASSERT_FALSE(llvm::sys::fs::openFileForWrite(f, fd));
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+  }
+  EXPECT_TRUE(is_ast_file(b.str().str()));
+  EXPECT_FALSE(is_ast_file(other.str().str()));
+  vec_str const exp = {"/x.cc", b.str().str(), a.str().str()};
+  std::vector<string_t> got(expand_ast_dirs({"/x.cc", dir.str().str()}));
+  // sorted by path: <dir>/b.ast before <dir>/sub/a.ast
+  EXPECT_EQ(exp, got);
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST(parallel_tool, runs_ast_files)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-ast-run", dir));
+  llvm::SmallString<128> src(dir), ast(dir), cache(dir);
+  llvm::sys::path::append(src, "s.cc");
+  llvm::sys::path::append(ast, "s.ast");
+  llvm::sys::path::append(cache, "cache");
+  {
+    std::ofstream o(src.str().str());
+    o << "void s1(){} void s2(){}\n";
+  }
+  // parse s.cc from disk and save its AST, as clang -emit-ast would
+  clang::tooling::FixedCompilationDatabase comps(dir.str().str(), vec_str{});
+  {
+    clang::tooling::ClangTool tool(comps, {src.str().str()});
+    std::vector<std::unique_ptr<clang::ASTUnit>> asts;
+    ASSERT_EQ(0, tool.buildASTs(asts));
+    ASSERT_EQ(1u, asts.size());
+    ASSERT_FALSE(asts[0]->Save(ast.str()));
+  }
+  // the compile database has no command for s.ast: the AST's own is used
+  auto run_once = [&](std::ostream & o, string_t & key) {
+    parallel_tool ptool(comps, {ast.str().str()}, 1);
+    ptool.use_cache(cache.str().str());
+    ptool.add_cache_salt("test");
+    int const status = ptool.run(
+        [&](tu_context & tu) {
+          key = tu.content_key("test");
+          EXPECT_NE(key, tu.content_key("other salt"));
+          Fn_Namer namer(tu.out);
+          tu.add_matcher(namer.matcher(), &namer);
+          return tu.run();
+        },
+        [](tu_context &, std::istream &) {}, o);
+    EXPECT_EQ(0, status);
+    return ptool.cache_hits();
+  };
+  std::stringstream s1, s2;
+  string_t key1, key2;
+  EXPECT_EQ(0u, run_once(s1, key1));
+  EXPECT_EQ("s1\ns2\n", s1.str());
+  EXPECT_FALSE(key1.empty());
+  // the key comes from the .ast file itself, so the second run hits
+  EXPECT_EQ(1u, run_once(s2, key2));
+  EXPECT_TRUE(key2.empty());  // the action did not run
+  EXPECT_EQ(s1.str(), s2.str());
+  llvm::sys::fs::remove_directories(dir);
+}
+
+// End of file
@@ -0,0 +1,85 @@
+// parameter_threading_test.cc
+// Oct 17, 2026
+
+#include "call_graph_builder.h"
+#include "parameter_threading.h"
+#include "gtest/gtest.h"
+#include "prep_code.h"
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+
+using namespace corct;
+using namespace clang;
+
+namespace {
+/* Globals used by leaf and by n::mid; main -> top -> n::mid -> leaf, and
+ * other -> leaf, other -> ok. */
+string_t const code =
+    "int G = 0;\n"
+    "int H = 0;\n"
+    "void leaf(){G++;}\n"
+    "void ok(){}\n"
+    "namespace n { void mid(){leaf(); H = G;} }\n"
+    "void top(){n::mid();}\n"
+    "void other(){leaf(); ok();}\n"
+    "int main(){top(); return G;}\n";
+
+void
+run_on(str_t_cr src, finder_t & finder)
+{
+  ASTUPtr ast;
+  ASTContext * pctx;
+  TranslationUnitDecl * decl;
+  std::tie(ast, pctx, decl) = prep_code(src);
+  finder.matchAST(*pctx);
+}
+
+bool
+graph_of(str_t_cr src, call_graph_file & g)
+{
+  call_graph_builder b;
+  finder_t finder;
+  finder.addMatcher(call_graph_builder::matcher(), &b);
+  run_on(src, finder);
+  std::stringstream s;
+  write_call_graph(b.data(), s);
+  string_t err;
+  return g.open(llvm::MemoryBuffer::getMemBufferCopy(s.str()), err);
+}
+}  // namespace
+
+TEST(global_user_finder, finds_users)
+{
+  global_user_finder users;
+  finder_t finder;
+  finder.addMatcher(global_user_finder::matcher({"G"}), &users);
+  run_on(code, finder);
+  vec_str names;
+  for(auto & u : users.users()) { names.push_back(u.second); }
+  std::sort(names.begin(), names.end());
+  vec_str const exp = {"leaf", "main", "n::mid"};
+  EXPECT_EQ(exp, names);
+  std::stringstream s;
+  users.write(s);
+  global_user_finder read_back;
+  EXPECT_TRUE(read_back.read(s));
+  EXPECT_EQ(users.users(), read_back.users());
+}
+
+TEST(parameter_threading, targets)
+{
+  global_user_finder users;
+  finder_t finder;
+  finder.addMatcher(global_user_finder::matcher({"G"}), &users);
+  run_on(code, finder);
+  call_graph_file g;
+  ASSERT_TRUE(graph_of(code, g));
+  vec_str const exp = {"leaf", "n::mid", "other", "top"};
+  EXPECT_EQ(exp, threading_targets(g, users.users(), {"main"}));
+  // stopping at top as well
+  vec_str const exp2 = {"leaf", "n::mid", "other"};
+  EXPECT_EQ(exp2, threading_targets(g, users.users(), {"main", "top"}));
+}
+
+// End of file
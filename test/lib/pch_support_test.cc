@@ -0,0 +1,118 @@
+// pch_support_test.cc
+// Oct 17, 2026
+
+#include "gtest/gtest.h"
+#include "pch_support.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include <ctime>
+#include <fstream>
+
+using namespace corct;
+
+namespace {
+/* Write text to dir/name; return the path. */
+string_t
+write_file(llvm::SmallString<128> const & dir, str_t_cr name, str_t_cr text)
+{
+  llvm::SmallString<128> path(dir);
+  llvm::sys::path::append(path, name);
+  std::ofstream o(path.str().str());
+  o << text;
+  return path.str().str();
+}
+
+/* Parse source with pch loaded; ClangTool::run's status. */
+int
+parse_with_pch(clang::tooling::CompilationDatabase const & comps,
+               str_t_cr source,
+               str_t_cr pch)
+{
+  using namespace clang::tooling;
+  ClangTool tool(comps, {source});
+  tool.appendArgumentsAdjuster(mk_include_pch_adjuster(pch));
+  return tool.run(newFrontendActionFactory<clang::SyntaxOnlyAction>().get());
+}
+}  // namespace
+
+TEST(pch_support, include_pch_adjuster)
+{
+  clang::tooling::CommandLineArguments args = {"clang++", "-I/inc", "a.cc"};
+  auto adj = mk_include_pch_adjuster("/tmp/common.h.pch");
+  clang::tooling::CommandLineArguments exp = {
+      "clang++", "-include-pch", "/tmp/common.h.pch", "-I/inc", "a.cc"};
+  EXPECT_EQ(exp, adj(args, "a.cc"));
+}
+
+TEST(pch_support, missing_files_are_not_current)
+{
+  EXPECT_FALSE(pch_is_current("/no/such/header.h", "/no/such/header.h.pch"));
+}
+
+TEST(pch_support, pch_language)
+{
+  EXPECT_EQ("c++-header", pch_language({"clang++", "a.cc"}, "a.cc"));
+  EXPECT_EQ("c-header", pch_language({"clang", "-c", "a.c"}, "a.c"));
+  EXPECT_EQ("objective-c-header", pch_language({"clang", "a.m"}, "a.m"));
+  // -x wins over the extension, but only before the source
+  EXPECT_EQ("c++-header", pch_language({"clang", "-x", "c++", "a.c"}, "a.c"));
+  EXPECT_EQ("c-header", pch_language({"clang", "-xc", "a.h"}, "a.h"));
+  EXPECT_EQ("c-header",
+            pch_language({"clang", "a.c", "-x", "c++", "b.cc"}, "a.c"));
+  EXPECT_EQ("c-header", pch_language({"clang", "-x", "none", "a.c"}, "a.c"));
+}
+
+TEST(pch_support, build_and_load)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-pch", dir));
+  string_t const header =
+      write_file(dir, "common.h", "#include \"inner.h\"\nstruct pt{int x;};\n");
+  write_file(dir, "inner.h", "int from_inner(void);\n");
+  // neither source includes common.h: their names come from the PCH
+  string_t const cc = write_file(
+      dir, "a.cc", "int f(){pt p{1}; return p.x + from_inner();}\n");
+  string_t const c =
+      write_file(dir, "b.c",
+                 "int f(void){struct pt p = {1}; return p.x + from_inner();}");
+  clang::tooling::FixedCompilationDatabase const comps(dir.str().str(),
+                                                       vec_str{});
+  // a C compile command must get a C PCH, which C TUs load
+  for(auto & source : {cc, c}) {
+    string_t const pch = source + ".pch";
+    ASSERT_TRUE(build_pch(comps, source, header, pch, {})) << source;
+    EXPECT_TRUE(pch_is_current(header, pch)) << source;
+    EXPECT_EQ(0, parse_with_pch(comps, source, pch)) << source;
+  }
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST(pch_support, stale_after_included_header_changes)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-pch", dir));
+  string_t const header = write_file(dir, "common.h", "#include \"inner.h\"\n");
+  string_t const inner = write_file(dir, "inner.h", "int from_inner();\n");
+  string_t const source = write_file(dir, "a.cc", "int f(){return 0;}\n");
+  clang::tooling::FixedCompilationDatabase const comps(dir.str().str(),
+                                                       vec_str{});
+  string_t const pch = source + ".pch";
+  ASSERT_TRUE(build_pch(comps, source, header, pch, {}));
+  EXPECT_TRUE(pch_is_current(header, pch));
+  // touch inner.h, but not common.h
+  int fd(-1);
+  ASSERT_FALSE(llvm::sys::fs::openFileForWrite(
+      inner, fd, llvm::sys::fs::CD_OpenExisting, llvm::sys::fs::OF_Append));
+  auto const later = llvm::sys::toTimePoint(std::time(nullptr) + 3600);
+  EXPECT_FALSE(llvm::sys::fs::setLastAccessAndModificationTime(fd, later));
+  llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+  EXPECT_FALSE(pch_is_current(header, pch));
+  llvm::sys::fs::remove_directories(dir);
+}
+
+// End of file
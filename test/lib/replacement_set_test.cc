@@ -0,0 +1,149 @@
+// replacement_set_test.cc
+// Oct 17, 2026
+
+#include "replacement_set.h"
+#include "gtest/gtest.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include <fstream>
+#include <sstream>
+
+using namespace corct;
+
+using add_result = replacement_set::add_result;
+
+TEST(replacement_set, dedups_and_applies)
+{
+  llvm::StringRef const code = "int f(int i){ return G + i; }\n";
+  replacement_set s;
+  // the same header edit, from two TUs
+  EXPECT_EQ(add_result::added, s.add("a.h", 21, 1, "cfg.G", "a.cc"));
+  EXPECT_EQ(add_result::duplicate, s.add("a.h", 21, 1, "cfg.G", "b.cc"));
+  // insertion at the start of a replaced range, and at its end
+  EXPECT_EQ(add_result::added, s.add("a.h", 21, 0, "(", "a.cc"));
+  EXPECT_EQ(add_result::added, s.add("a.h", 22, 0, ")", "a.cc"));
+  EXPECT_EQ(add_result::added, s.add("a.h", 11, 0, ", Cfg & cfg", "a.cc"));
+  EXPECT_EQ(4u, s.n_edits());
+  EXPECT_EQ(1u, s.n_files());
+  EXPECT_EQ(1u, s.n_duplicates());
+  EXPECT_TRUE(s.conflicts().empty());
+  string_t out;
+  ASSERT_TRUE(s.rewrite("a.h", code, out));
+  EXPECT_EQ("int f(int i, Cfg & cfg){ return (cfg.G) + i; }\n", out);
+  // files without edits are unchanged
+  ASSERT_TRUE(s.rewrite("b.h", code, out));
+  EXPECT_EQ(code, out);
+  // edits past the end
+  EXPECT_FALSE(s.rewrite("a.h", "int", out));
+}
+
+TEST(replacement_set, conflicts)
+{
+  replacement_set s;
+  EXPECT_EQ(add_result::added, s.add("/src/a.h", 10, 5, "x", "a.cc"));
+  EXPECT_EQ(add_result::conflict, s.add("/src/a.h", 12, 1, "y", "b.cc"));
+  EXPECT_EQ(add_result::conflict, s.add("/src/a.h", 8, 3, "y", "b.cc"));
+  EXPECT_EQ(add_result::conflict, s.add("/src/a.h", 10, 5, "z", "c.cc"));
+  EXPECT_EQ(add_result::conflict, s.add("/src/a.h", 12, 0, "w", "c.cc"));
+  EXPECT_EQ(add_result::added, s.add("/src/a.h", 15, 2, "v", "c.cc"));
+  EXPECT_EQ(add_result::added, s.add("/src/a.h", 3, 0, "i", "a.cc"));
+  EXPECT_EQ(add_result::conflict, s.add("/src/a.h", 3, 0, "j", "b.cc"));
+  EXPECT_EQ(5u, s.conflicts().size());
+  std::stringstream o;
+  s.write_conflicts(o);
+  std::string line;
+  std::getline(o, line);
+  EXPECT_EQ(
+      "conflicting edits in /src/a.h: kept 10:+5:\"x\" from a.cc, dropped "
+      "12:+1:\"y\" from b.cc",
+      line);
+}
+
+TEST(replacement_set, merge)
+{
+  symbol_table syms;
+  replacement_set w0(syms), w1(syms), other;
+  w0.add("/src/b.h", 1, 1, "x", "a.cc");
+  w1.add("/src/b.h", 1, 1, "x", "b.cc");
+  w1.add("/src/a.h", 0, 0, "y", "b.cc");
+  other.add("/src/a.h", 0, 1, "z", "c.cc");
+  other.add("/src/a.h", 0, 0, "q", "c.cc");
+  w0.merge(w1);
+  w0.merge(other);
+  EXPECT_EQ(3u, w0.n_edits());
+  EXPECT_EQ(1u, w0.n_duplicates());
+  ASSERT_EQ(1u, w0.conflicts().size());
+  EXPECT_EQ("c.cc", syms.name(w0.conflicts()[0].dropped.source));
+  std::stringstream o;
+  w0.write(o);
+  EXPECT_EQ("/src/a.h: 0:+0:\"y\"\n/src/a.h: 0:+1:\"z\"\n"
+            "/src/b.h: 1:+1:\"x\"\n",
+            o.str());
+}
+
+TEST(replacement_set, spellings_of_one_file)
+{
+  replacement_set s;
+  // one header, as TUs compiled in /src and /src/lib name it
+  EXPECT_EQ(add_result::added, s.add("a.h", 21, 1, "cfg.G", "a.cc", "/src"));
+  EXPECT_EQ(add_result::duplicate,
+            s.add("../a.h", 21, 1, "cfg.G", "lib/b.cc", "/src/lib"));
+  EXPECT_EQ(add_result::conflict,
+            s.add("/src/./lib/../a.h", 21, 1, "x", "c.cc", "/elsewhere"));
+  EXPECT_EQ(1u, s.n_files());
+  EXPECT_EQ("/src/a.h", s.syms().name(s.conflicts().at(0).file));
+  EXPECT_EQ(normalized_path("/src/a.h"), normalized_path("a.h", "/src/"));
+  // with no working directory, the current one
+  llvm::SmallString<128> cwd;
+  ASSERT_FALSE(llvm::sys::fs::current_path(cwd));
+  EXPECT_EQ(normalized_path("b.h", cwd), normalized_path("./x/../b.h"));
+  EXPECT_EQ("", normalized_path(""));
+}
+
+TEST(replacement_set, apply)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-reps", dir));
+  string_t const a = dir.str().str() + "/a.cc";
+  string_t const missing = dir.str().str() + "/missing.cc";
+  {
+    std::ofstream o(a);
+    o << "int x = G;\n";
+  }
+  replacement_set s;
+  s.add(a, 8, 1, "cfg.G", "a.cc");
+  s.add(missing, 0, 0, "x", "a.cc");
+  std::stringstream errs;
+  EXPECT_EQ(1u, s.apply(errs));
+  std::ifstream i(a);
+  string_t line;
+  std::getline(i, line);
+  EXPECT_EQ("int x = cfg.G;", line);
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST(replacement_set, apply_in_parallel)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-reps", dir));
+  replacement_set s;
+  vec_str paths;
+  for(int i = 0; i < 8; ++i) {
+    paths.push_back(dir.str().str() + "/f" + std::to_string(i) + ".cc");
+    std::ofstream o(paths.back());
+    o << "int x = G;\n";
+    s.add(paths.back(), 8, 1, "c" + std::to_string(i), "a.cc");
+  }
+  std::stringstream errs;
+  EXPECT_EQ(0u, s.apply(errs, 3));
+  EXPECT_EQ("", errs.str());
+  for(int i = 0; i < 8; ++i) {
+    std::ifstream in(paths[i]);
+    string_t line;
+    std::getline(in, line);
+    EXPECT_EQ("int x = c" + std::to_string(i) + ";", line);
+  }
+  llvm::sys::fs::remove_directories(dir);
+}
+
+// End of file
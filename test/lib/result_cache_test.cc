@@ -0,0 +1,74 @@
+// result_cache_test.cc
+// Oct 17, 2026
+
+#include "gtest/gtest.h"
+#include "result_cache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include <fstream>
+
+using namespace corct;
+
+TEST(result_cache, store_and_load)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-cache", dir));
+  result_cache cache(dir.str().str());
+  string_t out, data;
+  EXPECT_FALSE(cache.load("abc", out, data));
+  EXPECT_TRUE(cache.store("abc", "output\nlines\n", "n_matches\t2\n"));
+  EXPECT_TRUE(cache.load("abc", out, data));
+  EXPECT_EQ("output\nlines\n", out);
+  EXPECT_EQ("n_matches\t2\n", data);
+  // empty values are fine too
+  EXPECT_TRUE(cache.store("def", "", ""));
+  EXPECT_TRUE(cache.load("def", out, data));
+  EXPECT_EQ("", out);
+  EXPECT_EQ("", data);
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST(run_journal, record_and_resume)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-journal", dir));
+  string_t out, data;
+  {
+    run_journal j(dir.str().str(), false);
+    EXPECT_EQ(0u, j.n_done());
+    EXPECT_TRUE(j.record("k1", "/a.cc", "a out\n", "a data"));
+    EXPECT_TRUE(j.record("k2", "/b.cc", "", ""));
+    // only what earlier runs recorded counts as done
+    EXPECT_FALSE(j.done("k1"));
+  }
+  {
+    run_journal j(dir.str().str(), true);
+    EXPECT_EQ(2u, j.n_done());
+    EXPECT_TRUE(j.done("k1"));
+    EXPECT_FALSE(j.done("k3"));
+    EXPECT_TRUE(j.load("k1", out, data));
+    EXPECT_EQ("a out\n", out);
+    EXPECT_EQ("a data", data);
+    EXPECT_FALSE(j.load("k3", out, data));
+  }
+  {
+    // a partial last line, as a killed run might leave, is ignored
+    std::ofstream log(run_journal(dir.str().str(), true).path(),
+                      std::ios::app);
+    log << "k3\t/c.c";
+  }
+  {
+    run_journal j(dir.str().str(), true);
+    EXPECT_EQ(2u, j.n_done());
+    EXPECT_FALSE(j.done("k3"));
+  }
+  {
+    // without resume, the journal is emptied
+    run_journal j(dir.str().str(), false);
+    EXPECT_EQ(0u, j.n_done());
+  }
+  EXPECT_EQ(0u, run_journal(dir.str().str(), true).n_done());
+  llvm::sys::fs::remove_directories(dir);
+}
+
+// End of file
@@ -0,0 +1,115 @@
+// rewrite_manifest_test.cc
+// Oct 17, 2026
+
+#include "parallel_tool.h"
+#include "rewrite_manifest.h"
+#include "gtest/gtest.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include <sstream>
+
+using namespace corct;
+
+TEST(rewrite_manifest, parse)
+{
+  char const * text =
+      "[ {\"name\": \"nr\", \"gvar\": [\"NR\", \"NB\"],"
+      "   \"lvar\": [\"cfg.NR\", \"cfg.NB\"]},"
+      "  {\"tf\": [\"f\", \"g\"], \"np\": \"Cfg const & cfg\","
+      "   \"na\": \"cfg\"} ]";
+  rewrite_specs_t specs;
+  string_t err;
+  ASSERT_TRUE(parse_manifest(text, specs, err)) << err;
+  ASSERT_EQ(2u, specs.size());
+  EXPECT_EQ("nr", specs[0].name);
+  EXPECT_TRUE(specs[0].replaces());
+  EXPECT_FALSE(specs[0].expands());
+  EXPECT_EQ((vec_str{"cfg.NR", "cfg.NB"}), specs[0].lvars);
+  EXPECT_EQ("spec 1", specs[1].name);
+  EXPECT_EQ((vec_str{"f", "g"}), specs[1].targets);
+  EXPECT_EQ("Cfg const & cfg", specs[1].new_param);
+  EXPECT_EQ("cfg", specs[1].new_arg);
+  std::stringstream errs;
+  EXPECT_EQ(0u, check_manifest(specs, errs));
+}
+
+TEST(rewrite_manifest, bad_manifests)
+{
+  rewrite_specs_t specs;
+  string_t err;
+  EXPECT_FALSE(parse_manifest("{}", specs, err));
+  EXPECT_FALSE(parse_manifest("[", specs, err));
+  EXPECT_FALSE(parse_manifest("[{\"gvar\": [\"G\"]}]", specs, err));
+  EXPECT_EQ("spec 0: needs one \"lvar\" for each \"gvar\"", err);
+  EXPECT_FALSE(parse_manifest("[{\"tf\": [\"f\"], \"np\": \"int i\"}]",
+                              specs, err));
+  EXPECT_FALSE(parse_manifest("[{\"name\": \"x\"}]", specs, err));
+  EXPECT_FALSE(parse_manifest("[{\"gvar\": \"G\", \"lvar\": \"g\"}]",
+                              specs, err));
+  EXPECT_FALSE(parse_manifest(
+      "[{\"gvar\": [\"G\"], \"lvar\": [\"g\"], \"tff\": []}]", specs, err));
+  EXPECT_EQ("spec 0: unknown key \"tff\"", err);
+}
+
+TEST(rewrite_manifest, check)
+{
+  char const * text =
+      "[ {\"name\": \"a\", \"gvar\": [\"G\"], \"lvar\": [\"c.G\"],"
+      "   \"tf\": [\"f\"], \"np\": \"C & c\", \"na\": \"c\"},"
+      "  {\"name\": \"b\", \"gvar\": [\"G\", \"H\"], \"lvar\": [\"d.G\","
+      "   \"d.H\"], \"tf\": [\"f\", \"g\"], \"np\": \"D & d\","
+      "   \"na\": \"d\"} ]";
+  rewrite_specs_t specs;
+  string_t err;
+  ASSERT_TRUE(parse_manifest(text, specs, err)) << err;
+  std::stringstream errs;
+  EXPECT_EQ(2u, check_manifest(specs, errs));
+  EXPECT_EQ(
+      "manifest: global G in both 'a' and 'b'\n"
+      "manifest: function f in both 'a' and 'b'\n",
+      errs.str());
+}
+
+TEST(rewrite_manifest, salt_follows_the_specs)
+{
+  char const * text =
+      "[{\"name\": \"nr\", \"gvar\": [\"NR\"], \"lvar\": [\"cfg.NR\"]}]";
+  char const * relaid =
+      "[ {\"lvar\": [\"cfg.NR\"],\n  \"gvar\": [\"NR\"], \"name\": \"nr\"} ]";
+  char const * edited =
+      "[{\"name\": \"nr\", \"gvar\": [\"NR\"], \"lvar\": [\"cfg.NB\"]}]";
+  rewrite_specs_t specs, specs_relaid, specs_edited;
+  string_t err;
+  ASSERT_TRUE(parse_manifest(text, specs, err)) << err;
+  ASSERT_TRUE(parse_manifest(relaid, specs_relaid, err)) << err;
+  ASSERT_TRUE(parse_manifest(edited, specs_edited, err)) << err;
+  EXPECT_EQ(manifest_salt(specs), manifest_salt(specs_relaid));
+  EXPECT_NE(manifest_salt(specs), manifest_salt(specs_edited));
+  // {"a", "b"} and {"ab"} must differ
+  rewrite_spec s1, s2;
+  s1.gvars = {"a", "b"};
+  s2.gvars = {"ab"};
+  EXPECT_NE(manifest_salt({s1}), manifest_salt({s2}));
+
+  // with the salt, editing a spec misses the result cache
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-manifest", dir));
+  clang::tooling::FixedCompilationDatabase comps("/", vec_str{});
+  auto n_hits = [&](rewrite_specs_t const & sp) {
+    parallel_tool ptool(comps, {"/a.cc"}, 1);
+    ptool.map_virtual_file("/a.cc", "int NR; int f(){return NR;}");
+    ptool.use_cache(dir.str().str());
+    ptool.add_cache_salt("manifest:" + manifest_salt(sp));
+    std::stringstream o;
+    EXPECT_EQ(0, ptool.run([](tu_context & tu) { return tu.run(); },
+                           [](tu_context &, std::istream &) {}, o));
+    return ptool.cache_hits();
+  };
+  EXPECT_EQ(0u, n_hits(specs));
+  EXPECT_EQ(1u, n_hits(specs_relaid));
+  EXPECT_EQ(0u, n_hits(specs_edited));
+  llvm::sys::fs::remove_directories(dir);
+}
+
+// End of file
@@ -0,0 +1,96 @@
+// shard_test.cc
+// Oct 17, 2026
+
+#include "fix_export.h"
+#include "parallel_tool.h"
+#include "shard.h"
+#include "gtest/gtest.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include <sstream>
+
+using namespace corct;
+
+TEST(shard, parse_shard)
+{
+  uint32_t i(9), n(9);
+  string_t err;
+  ASSERT_TRUE(parse_shard("3/32", i, n, err)) << err;
+  EXPECT_EQ(3u, i);
+  EXPECT_EQ(32u, n);
+  EXPECT_FALSE(parse_shard("32/32", i, n, err));
+  EXPECT_FALSE(parse_shard("0/0", i, n, err));
+  EXPECT_FALSE(parse_shard("1", i, n, err));
+  EXPECT_FALSE(parse_shard("a/2", i, n, err));
+  EXPECT_EQ("expected i/N, not 'a/2'", err);
+}
+
+TEST(shard, shard_sources)
+{
+  vec_str const sources = {"e.cc", "b.cc", "d.cc", "a.cc", "c.cc"};
+  // path order a b c d e, dealt to shards 0 1 0 1 0
+  EXPECT_EQ((vec_str{"e.cc", "a.cc", "c.cc"}),
+            shard_sources(sources, 0, 2));
+  EXPECT_EQ((vec_str{"b.cc", "d.cc"}), shard_sources(sources, 1, 2));
+  // the same partition, whatever order the sources come in
+  vec_str const sorted = {"a.cc", "b.cc", "c.cc", "d.cc", "e.cc"};
+  EXPECT_EQ((vec_str{"a.cc", "c.cc", "e.cc"}), shard_sources(sorted, 0, 2));
+  EXPECT_EQ(sources, shard_sources(sources, 0, 1));
+  EXPECT_TRUE(shard_sources(sources, 7, 8).empty());
+  std::vector<size_t> positions;
+  shard_sources(sources, 1, 2, &positions);
+  EXPECT_EQ((std::vector<size_t>{1, 2}), positions);
+}
+
+TEST(shard, shards_export_to_distinct_files)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-shards", dir));
+  clang::tooling::FixedCompilationDatabase comps("/", vec_str{});
+  // same file names, so only the index tells the fixes files apart
+  vec_str const sources = {"/d/a.cc", "/e/a.cc", "/f/a.cc", "/g/a.cc"};
+  for(uint32_t i = 0; i < 2; ++i) {
+    std::vector<size_t> positions;
+    vec_str const mine = shard_sources(sources, i, 2, &positions);
+    parallel_tool ptool(comps, mine, 1);
+    ptool.set_run_indices(positions);
+    std::stringstream o;
+    int const status = ptool.run(
+        [&](tu_context & tu) {
+          string_t err;
+          return export_fixes(dir.str().str(), tu.run_index, tu.source,
+                              vec_repl(), err)
+                     ? 0
+                     : 1;
+        },
+        o);
+    EXPECT_EQ(0, status);
+  }
+  // one file per source: no shard overwrote another's
+  uint32_t n_files(0);
+  std::error_code ec;
+  for(llvm::sys::fs::directory_iterator it(dir, ec), end; !ec && it != end;
+      it.increment(ec)) {
+    ++n_files;
+  }
+  EXPECT_EQ(sources.size(), n_files);
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST(shard, header)
+{
+  std::stringstream s;
+  write_shard_header(s, "struct-field-use");
+  s << "n_matches\t0\n";
+  string_t kind;
+  ASSERT_TRUE(read_shard_header(s, kind));
+  EXPECT_EQ("struct-field-use", kind);
+  string_t rest;
+  std::getline(s, rest);
+  EXPECT_EQ("n_matches\t0", rest);
+  std::stringstream bad("n_matches\t0\n");
+  EXPECT_FALSE(read_shard_header(bad, kind));
+}
+
+// End of file
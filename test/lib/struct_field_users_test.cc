@@ -5,6 +5,7 @@
 #include "gtest/gtest.h"
 #include "prep_code.h"
 #include "struct_field_user.h"
+#include <sstream>
 #include <tuple>
 
 using namespace corct;
@@ -42,10 +43,128 @@ TEST(struct_field_user, case1)
   struct_field_user sfu(ts);
   uint32_t const exp_matches = 2u;
   EXPECT_EQ(exp_matches, run_case(code, sfu));
-  EXPECT_EQ(0u, sfu.non_lhs_uses_["foo_t"]["f1"].size());
-  EXPECT_EQ(0u, sfu.non_lhs_uses_["bar_t"]["f2"].size());
-  EXPECT_EQ(1u, sfu.lhs_uses_["foo_t"]["f1"].size());
-  EXPECT_EQ(1u, sfu.lhs_uses_["bar_t"]["f2"].size());
+  auto non_lhs(sfu.non_lhs_uses());
+  auto lhs(sfu.lhs_uses());
+  EXPECT_EQ(0u, non_lhs["foo_t"]["f1"].size());
+  EXPECT_EQ(0u, non_lhs["bar_t"]["f2"].size());
+  EXPECT_EQ(1u, lhs["foo_t"]["f1"].size());
+  EXPECT_EQ(1u, lhs["bar_t"]["f2"].size());
+}
+
+TEST(struct_field_user, compound_and_increment)
+{
+  // compound assignment, ++, and -- both read and write; parens are seen
+  // through; a plain assignment only writes
+  string_t const code =
+      "struct foo_t{int i;int j;int k;int l;int m;};"
+      "void f1(foo_t & f){f.i += 1; f.j++; --f.m; (f.k) = 2; int x = f.l;}";
+  vec_str ts = {"foo_t"};
+  struct_field_user sfu(ts);
+  EXPECT_EQ(5u, run_case(code, sfu));
+  auto lhs(sfu.lhs_uses());
+  auto non_lhs(sfu.non_lhs_uses());
+  struct_field_user::set_t const exp_lhs = {"i", "j", "k", "m"};
+  struct_field_user::set_t const exp_non_lhs = {"i", "j", "l", "m"};
+  EXPECT_EQ(exp_lhs, lhs["foo_t"]["f1"]);
+  EXPECT_EQ(exp_non_lhs, non_lhs["foo_t"]["f1"]);
+}
+
+TEST(struct_field_user, merge_shards)
+{
+  string_t const code1 =
+      "struct foo_t{int i;int j;};void f1(foo_t & f){f.i = f.j;}";
+  string_t const code2 =
+      "struct foo_t{int i;int j;};void f1(foo_t & f){f.j = 2;}"
+      "void f2(foo_t & f){int k = f.i;}";
+  vec_str ts = {"foo_t"};
+  struct_field_user sfu1(ts);
+  struct_field_user sfu2(ts);
+  run_case(code1, sfu1);
+  run_case(code2, sfu2);
+  // merging in either order gives the same result
+  struct_field_user m12(ts);
+  m12.merge(sfu1);
+  m12.merge(sfu2);
+  struct_field_user m21(ts);
+  m21.merge(sfu2);
+  m21.merge(sfu1);
+  EXPECT_EQ(4u, m12.n_matches_);
+  auto lhs(m12.lhs_uses());
+  auto non_lhs(m12.non_lhs_uses());
+  EXPECT_EQ(lhs, m21.lhs_uses());
+  EXPECT_EQ(non_lhs, m21.non_lhs_uses());
+  EXPECT_EQ(2u, lhs["foo_t"]["f1"].size());
+  EXPECT_EQ(1u, non_lhs["foo_t"]["f1"].size());
+  EXPECT_EQ(1u, non_lhs["foo_t"]["f2"].size());
+}
+
+TEST(struct_field_user, write_read)
+{
+  string_t const code =
+      "struct foo_t{int i;int j;};void f1(foo_t & f){f.i = f.j;}";
+  vec_str ts = {"foo_t"};
+  struct_field_user sfu(ts);
+  run_case(code, sfu);
+  std::stringstream s;
+  sfu.write(s);
+  struct_field_user sfu_in(ts);
+  EXPECT_TRUE(sfu_in.read(s));
+  EXPECT_EQ(sfu.n_matches_, sfu_in.n_matches_);
+  EXPECT_EQ(sfu.lhs_uses(), sfu_in.lhs_uses());
+  EXPECT_EQ(sfu.non_lhs_uses(), sfu_in.non_lhs_uses());
+  std::stringstream bad("lhs\tfoo_t\n");
+  EXPECT_FALSE(sfu_in.read(bad));
+}
+
+TEST(struct_field_user, shared_symbol_table)
+{
+  string_t const code1 = "struct foo_t{int i;};void f1(foo_t & f){f.i = 1;}";
+  string_t const code2 = "struct foo_t{int i;};void f2(foo_t & f){f.i = 2;}";
+  vec_str ts = {"foo_t"};
+  symbol_table syms;
+  struct_field_user sfu1(ts, syms);
+  struct_field_user sfu2(ts, syms);
+  run_case(code1, sfu1);
+  run_case(code2, sfu2);
+  // foo_t, i, f1, f2
+  EXPECT_EQ(4u, syms.size());
+  sfu1.merge(sfu2);
+  sym_id_t foo_id(0);
+  ASSERT_TRUE(syms.find("foo_t", foo_id));
+  EXPECT_EQ(2u, sfu1.lhs_uses_[foo_id].size());
+}
+
+TEST(struct_field_user, use_matrices)
+{
+  string_t const code1 =
+      "struct foo_t{int i;int j;int k;};"
+      "void f1(foo_t & f){f.i = f.j;}";
+  string_t const code2 =
+      "struct foo_t{int i;int j;int k;};"
+      "void f2(foo_t & f){f.k = f.j;}";
+  vec_str ts = {"foo_t"};
+  struct_field_user sfu1(ts);
+  struct_field_user sfu2(ts);
+  sfu1.track_use_matrices();
+  run_case(code1, sfu1);
+  run_case(code2, sfu2);
+  // sfu2 did not track; its uses are added to the matrix on merge
+  sfu1.merge(sfu2);
+  symbol_table & syms(sfu1.syms());
+  ASSERT_EQ(1u, sfu1.use_matrices().size());
+  use_bit_matrix const & m(sfu1.use_matrices().begin()->second);
+  EXPECT_EQ(2u, m.n_funcs());
+  EXPECT_EQ(2u, m.users(syms.intern("j")));
+  EXPECT_EQ(1u, m.co_users(syms.intern("i"), syms.intern("j")));
+  EXPECT_EQ(0u, m.co_users(syms.intern("i"), syms.intern("k")));
+  std::stringstream s;
+  sfu1.write_co_usage(s);
+  EXPECT_EQ("# struct foo_t\n"
+            "field\ti\tj\tk\n"
+            "i\t1\t1\t0\n"
+            "j\t1\t2\t1\n"
+            "k\t0\t1\t1\n",
+            s.str());
 }
 
 // End of file
@@ -0,0 +1,69 @@
+// symbol_table_test.cc
+// Oct 17, 2026
+
+#include "gtest/gtest.h"
+#include "symbol_table.h"
+#include <thread>
+#include <vector>
+
+using namespace corct;
+
+TEST(symbol_table, intern_and_name)
+{
+  symbol_table syms;
+  sym_id_t const a = syms.intern("alpha");
+  sym_id_t const b = syms.intern("beta");
+  EXPECT_EQ(0u, a);
+  EXPECT_EQ(1u, b);
+  EXPECT_EQ(a, syms.intern("alpha"));
+  EXPECT_EQ(2u, syms.size());
+  EXPECT_EQ("alpha", syms.name(a));
+  EXPECT_EQ("beta", syms.name(b));
+  sym_id_t id(99);
+  EXPECT_TRUE(syms.find("beta", id));
+  EXPECT_EQ(b, id);
+  EXPECT_FALSE(syms.find("gamma", id));
+}
+
+TEST(symbol_table, concurrent_intern)
+{
+  symbol_table syms;
+  uint32_t const n_threads = 4;
+  uint32_t const n_names = 200;
+  std::vector<std::vector<sym_id_t>> ids(n_threads);
+  std::vector<std::thread> ts;
+  for(uint32_t t = 0; t < n_threads; ++t) {
+    ts.emplace_back([&, t] {
+      for(uint32_t i = 0; i < n_names; ++i) {
+        ids[t].push_back(syms.intern("n" + std::to_string(i)));
+      }
+    });
+  }
+  for(auto & t : ts) { t.join(); }
+  EXPECT_EQ(n_names, syms.size());
+  for(uint32_t t = 1; t < n_threads; ++t) { EXPECT_EQ(ids[0], ids[t]); }
+  for(uint32_t i = 0; i < n_names; ++i) {
+    EXPECT_EQ("n" + std::to_string(i), syms.name(ids[0][i]));
+  }
+}
+
+TEST(symbol_cache, memoizes_by_address)
+{
+  symbol_table syms;
+  symbol_cache cache(syms);
+  int key(0);
+  uint32_t n_calls(0);
+  auto name_of = [&n_calls] {
+    n_calls++;
+    return string_t("thing");
+  };
+  sym_id_t const id1 = cache.get(&key, name_of);
+  sym_id_t const id2 = cache.get(&key, name_of);
+  EXPECT_EQ(id1, id2);
+  EXPECT_EQ(1u, n_calls);
+  cache.clear();
+  EXPECT_EQ(id1, cache.get(&key, name_of));
+  EXPECT_EQ(2u, n_calls);
+}
+
+// End of file
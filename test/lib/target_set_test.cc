@@ -0,0 +1,48 @@
+// target_set_test.cc
+// Oct 17, 2026
+
+#include "gtest/gtest.h"
+#include "target_set.h"
+
+using namespace corct;
+
+TEST(target_set, instantiate)
+{
+  target_set ts;
+  EXPECT_TRUE(ts.empty());
+  EXPECT_FALSE(ts.contains("f"));
+}
+
+TEST(target_set, lookup)
+{
+  vec_str const names = {"f", "g", "h", "g"};
+  target_set ts(names);
+  EXPECT_EQ(4u, ts.size());
+  EXPECT_EQ(names, ts.names());
+  EXPECT_TRUE(ts.contains("h"));
+  EXPECT_FALSE(ts.contains("k"));
+  target_set::index_t idx(99);
+  EXPECT_TRUE(ts.find("h", idx));
+  EXPECT_EQ(2u, idx);
+  // repeated names find their first position
+  EXPECT_TRUE(ts.find("g", idx));
+  EXPECT_EQ(1u, idx);
+  EXPECT_FALSE(ts.find("k", idx));
+  vec_str iterated(ts.begin(), ts.end());
+  EXPECT_EQ(names, iterated);
+}
+
+TEST(target_set, copy)
+{
+  // copies own their names, so their lookups stay valid
+  target_set ts2;
+  {
+    target_set ts1(vec_str{"a", "b"});
+    ts2 = ts1;
+  }
+  target_set::index_t idx(99);
+  EXPECT_TRUE(ts2.find("b", idx));
+  EXPECT_EQ(1u, idx);
+}
+
+// End of file
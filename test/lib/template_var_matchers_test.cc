@@ -241,4 +241,36 @@ TEST(template_var_matchers, template_var_reporter)
 
 }  // TEST(template_var_matchers,template_var_reporter)
 
+TEST(template_var_matchers, template_var_reporter_merge)
+{
+  using vec_strs_t = template_var_reporter::vec_strs_t;
+  template_var_reporter r1("Aardvarks");
+  template_var_reporter r2("Aardvarks");
+  template_var_reporter r3("Aardvarks");
+  r1.args_["a"] = vec_strs_t{"int"};
+  r2.args_["b"] = vec_strs_t{"float", "int"};
+  r3.args_["a"] = vec_strs_t{"double"};
+  // (r1 + r2) + r3
+  template_var_reporter left("Aardvarks");
+  left.merge(r1);
+  left.merge(r2);
+  left.merge(r3);
+  // r3 + (r2 + r1)
+  template_var_reporter right("Aardvarks");
+  template_var_reporter r21("Aardvarks");
+  r21.merge(r2);
+  r21.merge(r1);
+  right.merge(r3);
+  right.merge(r21);
+  EXPECT_EQ(left.args_, right.args_);
+  EXPECT_EQ(2u, left.args_.size());
+  EXPECT_EQ(vec_strs_t{"double"}, left.args_["a"]);
+  // write and read back
+  std::stringstream s;
+  left.write(s);
+  template_var_reporter in("Aardvarks");
+  EXPECT_TRUE(in.read(s));
+  EXPECT_EQ(left.args_, in.args_);
+}  // TEST(template_var_matchers,template_var_reporter_merge)
+
 // End of file
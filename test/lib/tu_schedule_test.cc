@@ -0,0 +1,75 @@
+// tu_schedule_test.cc
+// Oct 17, 2026
+
+#include "tu_schedule.h"
+#include "gtest/gtest.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include <fstream>
+
+using namespace corct;
+
+TEST(tu_schedule, estimate_source_cost)
+{
+  EXPECT_EQ(3.0, estimate_source_cost("int"));
+  double const one = estimate_source_cost("#include <a>\n");
+  double const two =
+      estimate_source_cost("#include <a>\n  #  include \"b\"\n");
+  EXPECT_GT(one, 1000.0);
+  EXPECT_GT(two, one + 1000.0);
+  // not includes
+  EXPECT_EQ(16.0, estimate_source_cost("// #include <a>\n"));
+}
+
+TEST(tu_schedule, largest_first_by_estimate)
+{
+  vec_str const sources = {"a", "b", "c", "d"};
+  std::map<string_t, double> est = {{"a", 1}, {"b", 30}, {"c", 2}, {"d", 30}};
+  auto estimate = [&est](str_t_cr s) { return est[s]; };
+  // ties stay in source order
+  EXPECT_EQ((std::vector<size_t>{1, 3, 2, 0}),
+            largest_first(sources, tu_costs(), estimate));
+}
+
+TEST(tu_schedule, largest_first_by_recorded_time)
+{
+  vec_str const sources = {"a", "b", "c"};
+  std::map<string_t, double> est = {{"a", 100}, {"b", 100}, {"c", 300}};
+  auto estimate = [&est](str_t_cr s) { return est[s]; };
+  tu_costs recorded;
+  // a is slower than its estimate suggests; b is not recorded
+  recorded.set("a", 8.0);
+  recorded.set("c", 4.0);
+  // rate is 12 s / 400 = 0.03 s per unit, so b is estimated at 3 s
+  EXPECT_EQ((std::vector<size_t>{0, 2, 1}),
+            largest_first(sources, recorded, estimate));
+}
+
+TEST(tu_schedule, save_and_load)
+{
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("corct-costs", dir));
+  llvm::SmallString<128> path(dir);
+  llvm::sys::path::append(path, "costs");
+  tu_costs costs;
+  EXPECT_TRUE(costs.load(path.str().str()));  // missing: nothing recorded
+  EXPECT_EQ(0u, costs.size());
+  costs.set("/src/a.cc", 1.5);
+  costs.set("/src/b c.cc", 0.25);
+  ASSERT_TRUE(costs.save(path.str().str()));
+  tu_costs loaded;
+  ASSERT_TRUE(loaded.load(path.str().str()));
+  EXPECT_EQ(2u, loaded.size());
+  EXPECT_EQ(1.5, loaded.get("/src/a.cc"));
+  EXPECT_EQ(0.25, loaded.get("/src/b c.cc"));
+  EXPECT_GT(0.0, loaded.get("/src/x.cc"));
+  {
+    std::ofstream o(path.str().str(), std::ios::app);
+    o << "fast\t/src/c.cc\n";
+  }
+  EXPECT_FALSE(loaded.load(path.str().str()));
+  llvm::sys::fs::remove_directories(dir);
+}
+
+// End of file
@@ -0,0 +1,97 @@
+// use_bit_matrix_test.cc
+// Oct 17, 2026
+
+#include "gtest/gtest.h"
+#include "use_bit_matrix.h"
+#include <sstream>
+
+using namespace corct;
+
+namespace {
+/* f0 uses a, b; f1 uses b, c; f2 uses a, b, c */
+use_bit_matrix
+mk_matrix(symbol_table & syms)
+{
+  use_bit_matrix m;
+  m.insert(syms.intern("f0"), syms.intern("a"));
+  m.insert(syms.intern("f0"), syms.intern("b"));
+  m.insert(syms.intern("f1"), syms.intern("b"));
+  m.insert(syms.intern("f1"), syms.intern("c"));
+  m.insert(syms.intern("f2"), syms.intern("a"));
+  m.insert(syms.intern("f2"), syms.intern("b"));
+  m.insert(syms.intern("f2"), syms.intern("c"));
+  m.insert(syms.intern("f2"), syms.intern("c"));  // duplicate
+  return m;
+}
+}  // namespace
+
+TEST(use_bit_matrix, queries)
+{
+  symbol_table syms;
+  use_bit_matrix const m(mk_matrix(syms));
+  sym_id_t const a = syms.intern("a"), b = syms.intern("b"),
+                 c = syms.intern("c");
+  EXPECT_EQ(3u, m.n_funcs());
+  EXPECT_EQ(3u, m.n_fields());
+  EXPECT_TRUE(m.uses(syms.intern("f0"), a));
+  EXPECT_FALSE(m.uses(syms.intern("f1"), a));
+  EXPECT_FALSE(m.uses(syms.intern("nobody"), a));
+  EXPECT_EQ(2u, m.users(a));
+  EXPECT_EQ(3u, m.users(b));
+  EXPECT_EQ(2u, m.co_users(a, b));
+  EXPECT_EQ(1u, m.co_users(a, c));
+  EXPECT_EQ(2u, m.co_users(c, b));
+  EXPECT_EQ(0u, m.co_users(a, syms.intern("unused")));
+  std::vector<sym_id_t> const fs(m.co_user_funcs(a, c));
+  ASSERT_EQ(1u, fs.size());
+  EXPECT_EQ("f2", syms.name(fs[0]));
+}
+
+TEST(use_bit_matrix, many_functions)
+{
+  // columns span several words and have different lengths
+  symbol_table syms;
+  use_bit_matrix m;
+  sym_id_t const even = syms.intern("even"), all = syms.intern("all");
+  for(uint32_t i = 0; i < 200; ++i) {
+    sym_id_t const f = syms.intern("f" + std::to_string(i));
+    m.insert(f, all);
+    if(i % 2 == 0 && i < 130) { m.insert(f, even); }
+  }
+  EXPECT_EQ(200u, m.users(all));
+  EXPECT_EQ(65u, m.users(even));
+  EXPECT_EQ(65u, m.co_users(all, even));
+  EXPECT_EQ(65u, m.co_users(even, all));
+  EXPECT_EQ(65u, m.co_user_funcs(all, even).size());
+}
+
+TEST(use_bit_matrix, co_usage_and_merge)
+{
+  symbol_table syms;
+  use_bit_matrix const m(mk_matrix(syms));
+  std::vector<uint32_t> const co(m.co_usage());
+  ASSERT_EQ(9u, co.size());
+  for(uint32_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(m.users(m.field(i)), co[i * 3 + i]);
+    for(uint32_t j = 0; j < 3; ++j) {
+      EXPECT_EQ(m.co_users(m.field(i), m.field(j)), co[i * 3 + j]);
+    }
+  }
+  std::stringstream s;
+  write_co_usage(m, syms, s);
+  EXPECT_EQ("field\ta\tb\tc\n"
+            "a\t2\t2\t1\n"
+            "b\t2\t3\t2\n"
+            "c\t1\t2\t2\n",
+            s.str());
+  // merge into a matrix with a different symbol table
+  symbol_table syms2;
+  use_bit_matrix m2;
+  m2.insert(syms2.intern("f9"), syms2.intern("c"));
+  m2.merge(m, [&](sym_id_t id) { return syms2.intern(syms.name(id)); });
+  EXPECT_EQ(4u, m2.n_funcs());
+  EXPECT_EQ(3u, m2.users(syms2.intern("c")));
+  EXPECT_EQ(2u, m2.co_users(syms2.intern("a"), syms2.intern("b")));
+}
+
+// End of file